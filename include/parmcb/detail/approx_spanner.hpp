@@ -6,6 +6,7 @@
 //    (See accompanying file LICENSE_1_0.txt or copy at
 //          https://www.boost.org/LICENSE_1_0.txt)
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/detail/dijkstra.hpp>
 #include <parmcb/detail/bfs.hpp>
 
@@ -31,18 +32,20 @@ public:
     typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
     typedef typename boost::property_traits<WeightMap>::value_type WeightType;
     typedef typename boost::property_map<Graph, boost::edge_weight_t>::type EdgeWeightMapType;
+    typedef parmcb::detail::CSRSnapshot<Graph, EdgeWeightMapType> SpannerSnapshot;
+    typedef typename SpannerSnapshot::CSRWeightMap CSRWeightMap;
+    typedef typename boost::graph_traits<CSRGraph>::vertex_descriptor CSRVertex;
 
     NonSpannerEdgesCycleBuilder(const Graph &g, const WeightMap &weight_map,
-            const Graph &spanner, const VertexIndexMapType &spanner_index_map,
-            const std::map<Edge, Edge> &edge_spanner_to_g,
-            const EdgeWeightMapType &spanner_weight_map,
+            const SpannerSnapshot &spanner, const VertexIndexMapType &spanner_index_map,
+            const std::vector<Edge> &edge_csr_to_g,
             const std::vector<Edge> &non_spanner_edges,
             const boost::function_property_map<
                     parmcb::detail::VertexIndexFunctor<Graph, Vertex>, Vertex,
                     Vertex&> &vertex_g_to_spanner) :
-            _g(g), _weight_map(weight_map), _spanner(spanner), _spanner_index_map(
-                    spanner_index_map), _edge_spanner_to_g(edge_spanner_to_g), _spanner_weight_map(
-                    spanner_weight_map), _non_spanner_edges(non_spanner_edges), _vertex_g_to_spanner(
+            _g(g), _weight_map(weight_map), _spanner(spanner), _spanner_weight_map(
+                    spanner.weight_map()), _spanner_index_map(spanner_index_map), _edge_csr_to_g(
+                    edge_csr_to_g), _non_spanner_edges(non_spanner_edges), _vertex_g_to_spanner(
                     vertex_g_to_spanner) {
 
     }
@@ -65,65 +68,11 @@ private:
 
         for (auto it = _non_spanner_edges.begin();
                 it != _non_spanner_edges.end(); it++) {
-            auto e = *it;
-            Vertex v = boost::source(e, _g);
-            Vertex u = boost::target(e, _g);
-            Vertex spanner_v = _vertex_g_to_spanner[v];
-            Vertex spanner_u = _vertex_g_to_spanner[u];
-
-            // compute shortest path on spanner
-            std::vector<WeightType> dist(boost::num_vertices(_spanner),
-                    (std::numeric_limits<WeightType>::max)());
-            boost::function_property_map<
-                    parmcb::detail::VertexIndexFunctor<Graph, WeightType>,
-                    Vertex, WeightType&> dist_map(
-                    parmcb::detail::VertexIndexFunctor<Graph, WeightType>(dist,
-                            _spanner_index_map));
-            std::vector<std::tuple<bool, Edge>> pred(
-                    boost::num_vertices(_spanner),
-                    std::make_tuple(false, Edge()));
-            boost::function_property_map<
-                    parmcb::detail::VertexIndexFunctor<Graph,
-                            std::tuple<bool, Edge>>, Vertex,
-                    std::tuple<bool, Edge>&> pred_map(
-                    parmcb::detail::VertexIndexFunctor<Graph,
-                            std::tuple<bool, Edge> >(pred, _spanner_index_map));
-
-            // run dijkstra
-            parmcb::dijkstra(_spanner, _spanner_weight_map, spanner_v, dist_map,
-                    pred_map);
-
-            // form cycle
             std::list<Edge> cycle_edgelist;
-            WeightType weight = WeightType();
-            Vertex spanner_w = spanner_u;
-            while (true) {
-                auto pred_t = boost::get(pred_map, spanner_w);
-                if (!std::get<0>(pred_t)) {
-                    // no predecessor
-                    break;
-                }
-                Edge spanner_ae = std::get<1>(pred_t);
-                Edge ae = _edge_spanner_to_g.at(spanner_ae);
-                cycle_edgelist.push_back(ae);
-                weight += boost::get(_weight_map, ae);
-
-                // go to predecessor
-                auto spanner_other = boost::target(spanner_ae, _spanner);
-                if (spanner_other == spanner_w) {
-                    spanner_other = boost::source(spanner_ae, _spanner);
-                }
-                if (spanner_other == spanner_w) {
-                    throw new std::runtime_error("Self loops?");
-                }
-                spanner_w = spanner_other;
-            }
-            cycle_edgelist.push_back(e);
-            weight += boost::get(_weight_map, e);
+            total_weight += construct_cycle(*it, cycle_edgelist);
 
             // output
             *out++ = cycle_edgelist;
-            total_weight += weight;
         }
 
         return total_weight;
@@ -144,67 +93,8 @@ private:
                         > (0, _non_spanner_edges.size()),
                 [&](const tbb::blocked_range<std::size_t> &r) {
                     for (std::size_t i = r.begin(); i != r.end(); ++i) {
-                        auto e = _non_spanner_edges.at(i);
-
-                        Vertex v = boost::source(e, _g);
-                        Vertex u = boost::target(e, _g);
-                        Vertex spanner_v = _vertex_g_to_spanner[v];
-                        Vertex spanner_u = _vertex_g_to_spanner[u];
-
-                        // compute shortest path on spanner
-                        std::vector<WeightType> dist(
-                                boost::num_vertices(_spanner),
-                                (std::numeric_limits<WeightType>::max)());
-                        boost::function_property_map<
-                                parmcb::detail::VertexIndexFunctor<Graph,
-                                        WeightType>, Vertex, WeightType&> dist_map(
-                                parmcb::detail::VertexIndexFunctor<Graph,
-                                        WeightType>(dist, _spanner_index_map));
-                        std::vector<std::tuple<bool, Edge>> pred(
-                                boost::num_vertices(_spanner),
-                                std::make_tuple(false, Edge()));
-                        boost::function_property_map<
-                                parmcb::detail::VertexIndexFunctor<Graph,
-                                        std::tuple<bool, Edge>>, Vertex,
-                                std::tuple<bool, Edge>&> pred_map(
-                                parmcb::detail::VertexIndexFunctor<Graph,
-                                        std::tuple<bool, Edge> >(pred,
-                                        _spanner_index_map));
-
-                        // run dijkstra
-                        parmcb::dijkstra(_spanner, _spanner_weight_map,
-                                spanner_v, dist_map, pred_map);
-
-                        // form cycle
                         std::list<Edge> cycle_edgelist;
-                        WeightType weight = WeightType();
-                        Vertex spanner_w = spanner_u;
-                        while (true) {
-                            auto pred_t = boost::get(pred_map, spanner_w);
-                            if (!std::get<0>(pred_t)) {
-                                // no predecessor
-                                break;
-                            }
-                            Edge spanner_ae = std::get<1>(pred_t);
-                            Edge ae = _edge_spanner_to_g.at(spanner_ae);
-                            cycle_edgelist.push_back(ae);
-                            weight += boost::get(_weight_map, ae);
-
-                            // go to predecessor
-                            auto spanner_other = boost::target(spanner_ae,
-                                    _spanner);
-                            if (spanner_other == spanner_w) {
-                                spanner_other = boost::source(spanner_ae,
-                                        _spanner);
-                            }
-                            if (spanner_other == spanner_w) {
-                                throw new std::runtime_error("Self loops?");
-                            }
-                            spanner_w = spanner_other;
-                        }
-                        cycle_edgelist.push_back(e);
-                        weight += boost::get(_weight_map, e);
-
+                        WeightType weight = construct_cycle(_non_spanner_edges[i], cycle_edgelist);
                         cycles.push_back(cycle_edgelist);
                         cycles_weights.push_back(weight);
                     }
@@ -226,12 +116,74 @@ private:
         return total_weight;
     }
 
+    /*
+     * Close a non-spanner edge with a shortest path in the spanner. The search runs on the
+     * CSR snapshot of the spanner, whose vertices are the spanner vertex indices.
+     */
+    WeightType construct_cycle(const Edge &e, std::list<Edge> &cycle_edgelist) const {
+        const CSRGraph &csr = _spanner.graph();
+        CSRVertex csr_v = _spanner_index_map[_vertex_g_to_spanner[boost::source(e, _g)]];
+        CSRVertex csr_u = _spanner_index_map[_vertex_g_to_spanner[boost::target(e, _g)]];
+        auto csr_index_map = boost::get(boost::vertex_index, csr);
+
+        // compute shortest path on spanner
+        std::vector<WeightType> dist(boost::num_vertices(csr),
+                (std::numeric_limits<WeightType>::max)());
+        boost::function_property_map<
+                parmcb::detail::VertexIndexFunctor<CSRGraph, WeightType>,
+                CSRVertex, WeightType&> dist_map(
+                parmcb::detail::VertexIndexFunctor<CSRGraph, WeightType>(dist,
+                        csr_index_map));
+        std::vector<std::tuple<bool, CSREdge>> pred(
+                boost::num_vertices(csr),
+                std::make_tuple(false, CSREdge()));
+        boost::function_property_map<
+                parmcb::detail::VertexIndexFunctor<CSRGraph,
+                        std::tuple<bool, CSREdge>>, CSRVertex,
+                std::tuple<bool, CSREdge>&> pred_map(
+                parmcb::detail::VertexIndexFunctor<CSRGraph,
+                        std::tuple<bool, CSREdge> >(pred, csr_index_map));
+
+        // run dijkstra
+        parmcb::dijkstra(csr, _spanner_weight_map, csr_v, dist_map,
+                pred_map);
+
+        // form cycle
+        WeightType weight = WeightType();
+        CSRVertex csr_w = csr_u;
+        while (true) {
+            auto pred_t = boost::get(pred_map, csr_w);
+            if (!std::get<0>(pred_t)) {
+                // no predecessor
+                break;
+            }
+            CSREdge csr_ae = std::get<1>(pred_t);
+            Edge ae = _edge_csr_to_g[csr_ae.id];
+            cycle_edgelist.push_back(ae);
+            weight += boost::get(_weight_map, ae);
+
+            // go to predecessor
+            auto csr_other = boost::target(csr_ae, csr);
+            if (csr_other == csr_w) {
+                csr_other = boost::source(csr_ae, csr);
+            }
+            if (csr_other == csr_w) {
+                throw new std::runtime_error("Self loops?");
+            }
+            csr_w = csr_other;
+        }
+        cycle_edgelist.push_back(e);
+        weight += boost::get(_weight_map, e);
+
+        return weight;
+    }
+
     const Graph &_g;
     const WeightMap &_weight_map;
-    const Graph &_spanner;
+    const SpannerSnapshot &_spanner;
+    const CSRWeightMap _spanner_weight_map;
     const VertexIndexMapType &_spanner_index_map;
-    const std::map<Edge, Edge> &_edge_spanner_to_g;
-    const EdgeWeightMapType &_spanner_weight_map;
+    const std::vector<Edge> &_edge_csr_to_g;
     const std::vector<Edge> &_non_spanner_edges;
     const boost::function_property_map<
             parmcb::detail::VertexIndexFunctor<Graph, Vertex>, Vertex, Vertex&> &_vertex_g_to_spanner;
@@ -280,11 +232,19 @@ public:
         ExactAlgorithm exact_mcb_algo;
         _weight += exact_mcb_algo(_spanner, spanner_weight_map, out);
 
+        // snapshot the spanner, edge ids of the snapshot map directly to edges of g
+        parmcb::detail::CSRSnapshot<Graph, EdgeWeightMapType> spanner_snapshot(_spanner, spanner_weight_map);
+        std::vector<Edge> edge_csr_to_g;
+        edge_csr_to_g.reserve(boost::num_edges(_spanner));
+        for (std::size_t id = 0; id < boost::num_edges(_spanner); id++) {
+            edge_csr_to_g.push_back(_edge_spanner_to_g.at(spanner_snapshot.edge(id)));
+        }
+
         // compute remaining cycles
         parmcb::detail::NonSpannerEdgesCycleBuilder<Graph, WeightMap,
                 ParallelUsingTBB> non_spanner_edges_cycle_builder(_g,
-                _weight_map, _spanner, _spanner_index_map, _edge_spanner_to_g,
-                spanner_weight_map, _non_spanner_edges, _vertex_g_to_spanner);
+                _weight_map, spanner_snapshot, _spanner_index_map, edge_csr_to_g,
+                _non_spanner_edges, _vertex_g_to_spanner);
         _weight += non_spanner_edges_cycle_builder(out);
 
         return _weight;
@@ -18,6 +18,7 @@
 #include <boost/graph/graph_concepts.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/detail/util.hpp>
 
 namespace parmcb {
@@ -0,0 +1,225 @@
+#ifndef PARMCB_DETAIL_BICONNECTED_HPP_
+#define PARMCB_DETAIL_BICONNECTED_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+
+#include <boost/graph/biconnected_components.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * The biconnected components of a graph which contain at least one cycle. Bridges and
+         * the edges of tree-like parts form components without cycles and are dropped. Each
+         * block is stored as a CSR graph with contiguous vertex and edge ids together with
+         * the edges of the original graph, blocks are ordered by decreasing number of edges.
+         */
+        template<class Graph, class WeightMap>
+        class BiconnectedBlocks {
+        public:
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef typename CSRSnapshot<Graph, WeightMap>::CSRWeightMap BlockWeightMap;
+
+            struct Block {
+                CSRGraph graph;
+                std::vector<WeightType> weights;
+                std::vector<Edge> edges;
+
+                BlockWeightMap weight_map() const {
+                    return BlockWeightMap(weights.begin(), CSREdgeIndexMap());
+                }
+
+                std::size_t cycle_space_dimension() const {
+                    return boost::num_edges(graph) - boost::num_vertices(graph) + 1;
+                }
+            };
+
+            BiconnectedBlocks(const Graph &g, const WeightMap &weight_map) :
+                    _dropped_edges(0) {
+                CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+                const CSRGraph &csr = snapshot.graph();
+                std::size_t n = boost::num_vertices(csr);
+                std::size_t m = boost::num_edges(csr);
+
+                std::vector<std::size_t> component(m);
+                std::size_t num_components = boost::biconnected_components(csr,
+                        boost::make_iterator_property_map(component.begin(), CSREdgeIndexMap()));
+
+                std::vector<std::vector<std::size_t>> component_edges(num_components);
+                for (std::size_t id = 0; id < m; id++) {
+                    component_edges[component[id]].push_back(id);
+                }
+
+                // vertex ids local to the current block
+                const std::size_t npos = (std::numeric_limits<std::size_t>::max)();
+                std::vector<std::size_t> local(n, npos);
+                std::vector<std::size_t> touched;
+
+                auto snapshot_weights = snapshot.weight_map();
+                for (const auto &ids : component_edges) {
+                    std::vector<std::pair<std::size_t, std::size_t>> endpoints;
+                    endpoints.reserve(ids.size());
+                    for (auto id : ids) {
+                        const CSREdge &e = csr.edge(id);
+                        for (auto v : { e.source, e.target }) {
+                            if (local[v] == npos) {
+                                local[v] = touched.size();
+                                touched.push_back(v);
+                            }
+                        }
+                        endpoints.emplace_back(local[e.source], local[e.target]);
+                    }
+                    std::size_t block_n = touched.size();
+                    for (auto v : touched) {
+                        local[v] = npos;
+                    }
+                    touched.clear();
+
+                    if (ids.size() < block_n) {
+                        // a bridge
+                        _dropped_edges += ids.size();
+                        continue;
+                    }
+
+                    Block block;
+                    block.graph = CSRGraph(block_n, endpoints);
+                    block.weights.reserve(ids.size());
+                    block.edges.reserve(ids.size());
+                    for (auto id : ids) {
+                        block.weights.push_back(snapshot_weights[csr.edge(id)]);
+                        block.edges.push_back(snapshot.edge(id));
+                    }
+                    _blocks.push_back(std::move(block));
+                }
+
+                std::stable_sort(_blocks.begin(), _blocks.end(), [](const Block &a, const Block &b) {
+                    return a.edges.size() > b.edges.size();
+                });
+            }
+
+            std::size_t size() const {
+                return _blocks.size();
+            }
+
+            const Block& operator[](std::size_t i) const {
+                return _blocks[i];
+            }
+
+            std::size_t dropped_edges() const {
+                return _dropped_edges;
+            }
+
+        private:
+            std::vector<Block> _blocks;
+            std::size_t _dropped_edges;
+        };
+
+        /*
+         * Computes a minimum cycle basis as the union of the minimum cycle bases of the
+         * biconnected components. Each block is solved independently by the exact algorithm,
+         * in parallel when using TBB, and the cycles are reported block after block using the
+         * edges of the original graph.
+         */
+        template<class Graph, class WeightMap, template<class, class, class > class ExactAlgorithm,
+                bool ParallelUsingTBB>
+        class BaseBiconnectedAlgorithm {
+        public:
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef BiconnectedBlocks<Graph, WeightMap> Blocks;
+            typedef typename Blocks::Block Block;
+            typedef std::list<std::list<CSREdge>> BlockCycles;
+            typedef ExactAlgorithm<CSRGraph, typename Blocks::BlockWeightMap,
+                    std::back_insert_iterator<BlockCycles>> BlockAlgorithm;
+
+            BaseBiconnectedAlgorithm(const Graph &g, const WeightMap &weight_map) :
+                    _blocks(g, weight_map) {
+#ifdef PARMCB_LOGGING
+                std::cout << "Biconnected blocks with cycles: " << _blocks.size() << std::endl;
+                std::cout << "Edges outside blocks: " << _blocks.dropped_edges() << std::endl;
+#endif
+            }
+
+            template<class CycleOutputIterator>
+            WeightType run(CycleOutputIterator out) {
+                std::vector<BlockCycles> cycles(_blocks.size());
+                std::vector<WeightType> weights(_blocks.size(), WeightType());
+                solve(cycles, weights);
+
+                WeightType weight = WeightType();
+                for (std::size_t i = 0; i < _blocks.size(); i++) {
+                    const Block &block = _blocks[i];
+                    for (const auto &c : cycles[i]) {
+                        std::list<Edge> cycle;
+                        for (const auto &e : c) {
+                            cycle.push_back(block.edges[e.id]);
+                        }
+                        *out++ = cycle;
+                    }
+                    weight += weights[i];
+                }
+                return weight;
+            }
+
+        private:
+            void solve_block(std::size_t i, std::vector<BlockCycles> &cycles, std::vector<WeightType> &weights) {
+                const Block &block = _blocks[i];
+                BlockAlgorithm exact_mcb_algo;
+                weights[i] = exact_mcb_algo(block.graph, block.weight_map(), std::back_inserter(cycles[i]));
+            }
+
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void solve(std::vector<BlockCycles> &cycles, std::vector<WeightType> &weights,
+                    typename std::enable_if<!is_tbb_enabled>::type* = 0) {
+                for (std::size_t i = 0; i < _blocks.size(); i++) {
+                    solve_block(i, cycles, weights);
+                }
+            }
+
+#ifdef PARMCB_HAVE_TBB
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void solve(std::vector<BlockCycles> &cycles, std::vector<WeightType> &weights,
+                    typename std::enable_if<is_tbb_enabled>::type* = 0) {
+                // blocks are sorted by decreasing size, so the large ones start first
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, _blocks.size(), 1),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            for (std::size_t i = r.begin(); i != r.end(); ++i) {
+                                solve_block(i, cycles, weights);
+                            }
+                        });
+            }
+#endif
+
+            Blocks _blocks;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
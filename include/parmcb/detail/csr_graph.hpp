@@ -0,0 +1,456 @@
+#ifndef PARMCB_DETAIL_CSR_GRAPH_HPP_
+#define PARMCB_DETAIL_CSR_GRAPH_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Edge of a CSR graph. Edges are identified by their id, the endpoints are oriented
+         * so that the source is the vertex whose adjacency produced the edge.
+         */
+        struct CSREdge {
+            std::size_t source;
+            std::size_t target;
+            std::size_t id;
+
+            CSREdge() :
+                    source(0), target(0), id(0) {
+            }
+
+            CSREdge(std::size_t source, std::size_t target, std::size_t id) :
+                    source(source), target(target), id(id) {
+            }
+        };
+
+        inline bool operator==(const CSREdge &a, const CSREdge &b) {
+            return a.id == b.id;
+        }
+
+        inline bool operator!=(const CSREdge &a, const CSREdge &b) {
+            return a.id != b.id;
+        }
+
+        inline bool operator<(const CSREdge &a, const CSREdge &b) {
+            return a.id < b.id;
+        }
+
+        inline bool operator>(const CSREdge &a, const CSREdge &b) {
+            return a.id > b.id;
+        }
+
+        inline bool operator<=(const CSREdge &a, const CSREdge &b) {
+            return a.id <= b.id;
+        }
+
+        inline bool operator>=(const CSREdge &a, const CSREdge &b) {
+            return a.id >= b.id;
+        }
+
+        inline std::size_t hash_value(const CSREdge &e) {
+            return boost::hash_value(e.id);
+        }
+
+        inline std::ostream& operator<<(std::ostream &out, const CSREdge &e) {
+            return out << "(" << e.source << "," << e.target << ")";
+        }
+
+        /*
+         * Readable property map from edges of a CSR graph to their id.
+         */
+        struct CSREdgeIndexMap: public boost::put_get_helper<std::size_t, CSREdgeIndexMap> {
+            typedef CSREdge key_type;
+            typedef std::size_t value_type;
+            typedef std::size_t reference;
+            typedef boost::readable_property_map_tag category;
+
+            std::size_t operator[](const CSREdge &e) const {
+                return e.id;
+            }
+        };
+
+        /*
+         * Immutable undirected graph in compressed sparse row format. Vertices are 0..n-1 and edges
+         * have ids 0..m-1. The adjacency of each vertex is stored contiguously, as pairs of neighbor
+         * and edge id. Models the Boost incidence, vertex list and edge list graph concepts.
+         */
+        class CSRGraph {
+        public:
+            typedef std::size_t vertex_descriptor;
+            typedef CSREdge edge_descriptor;
+            typedef boost::undirected_tag directed_category;
+            typedef boost::allow_parallel_edge_tag edge_parallel_category;
+            struct traversal_category: public boost::incidence_graph_tag,
+                    public boost::vertex_list_graph_tag,
+                    public boost::edge_list_graph_tag {
+            };
+            typedef std::size_t vertices_size_type;
+            typedef std::size_t edges_size_type;
+            typedef std::size_t degree_size_type;
+            typedef boost::counting_iterator<std::size_t> vertex_iterator;
+
+            class out_edge_iterator: public boost::iterator_facade<out_edge_iterator, CSREdge,
+                    std::random_access_iterator_tag, CSREdge> {
+            public:
+                out_edge_iterator() :
+                        g(nullptr), u(0), pos(0) {
+                }
+
+                out_edge_iterator(const CSRGraph *g, std::size_t u, std::size_t pos) :
+                        g(g), u(u), pos(pos) {
+                }
+
+            private:
+                friend class boost::iterator_core_access;
+
+                CSREdge dereference() const {
+                    return CSREdge(u, g->_targets[pos], g->_edge_ids[pos]);
+                }
+
+                bool equal(const out_edge_iterator &other) const {
+                    return pos == other.pos;
+                }
+
+                void increment() {
+                    ++pos;
+                }
+
+                void decrement() {
+                    --pos;
+                }
+
+                void advance(std::ptrdiff_t n) {
+                    pos += n;
+                }
+
+                std::ptrdiff_t distance_to(const out_edge_iterator &other) const {
+                    return std::ptrdiff_t(other.pos) - std::ptrdiff_t(pos);
+                }
+
+                const CSRGraph *g;
+                std::size_t u;
+                std::size_t pos;
+            };
+
+            class edge_iterator: public boost::iterator_facade<edge_iterator, CSREdge, std::random_access_iterator_tag,
+                    CSREdge> {
+            public:
+                edge_iterator() :
+                        g(nullptr), id(0) {
+                }
+
+                edge_iterator(const CSRGraph *g, std::size_t id) :
+                        g(g), id(id) {
+                }
+
+            private:
+                friend class boost::iterator_core_access;
+
+                CSREdge dereference() const {
+                    return g->edge(id);
+                }
+
+                bool equal(const edge_iterator &other) const {
+                    return id == other.id;
+                }
+
+                void increment() {
+                    ++id;
+                }
+
+                void decrement() {
+                    --id;
+                }
+
+                void advance(std::ptrdiff_t n) {
+                    id += n;
+                }
+
+                std::ptrdiff_t distance_to(const edge_iterator &other) const {
+                    return std::ptrdiff_t(other.id) - std::ptrdiff_t(id);
+                }
+
+                const CSRGraph *g;
+                std::size_t id;
+            };
+
+            CSRGraph() :
+                    _offsets(1, 0) {
+            }
+
+            static vertex_descriptor null_vertex() {
+                return (std::numeric_limits<std::size_t>::max)();
+            }
+
+            /*
+             * Build from the endpoints of the edges, edge i gets id i.
+             */
+            CSRGraph(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &endpoints) :
+                    _offsets(n + 1, 0), _targets(2 * endpoints.size()), _edge_ids(2 * endpoints.size()), _endpoints(
+                            endpoints) {
+                for (const auto &uv : endpoints) {
+                    _offsets[uv.first + 1]++;
+                    _offsets[uv.second + 1]++;
+                }
+                for (std::size_t v = 0; v < n; v++) {
+                    _offsets[v + 1] += _offsets[v];
+                }
+                std::vector<std::size_t> next(_offsets.begin(), _offsets.end() - 1);
+                for (std::size_t id = 0; id < endpoints.size(); id++) {
+                    auto u = endpoints[id].first;
+                    auto v = endpoints[id].second;
+                    _targets[next[u]] = v;
+                    _edge_ids[next[u]++] = id;
+                    _targets[next[v]] = u;
+                    _edge_ids[next[v]++] = id;
+                }
+            }
+
+            std::size_t num_vertices() const {
+                return _offsets.size() - 1;
+            }
+
+            std::size_t num_edges() const {
+                return _endpoints.size();
+            }
+
+            std::size_t degree(std::size_t u) const {
+                return _offsets[u + 1] - _offsets[u];
+            }
+
+            CSREdge edge(std::size_t id) const {
+                return CSREdge(_endpoints[id].first, _endpoints[id].second, id);
+            }
+
+            std::pair<out_edge_iterator, out_edge_iterator> out_edges(std::size_t u) const {
+                return std::make_pair(out_edge_iterator(this, u, _offsets[u]),
+                        out_edge_iterator(this, u, _offsets[u + 1]));
+            }
+
+            std::pair<edge_iterator, edge_iterator> edges() const {
+                return std::make_pair(edge_iterator(this, 0), edge_iterator(this, num_edges()));
+            }
+
+        private:
+            std::vector<std::size_t> _offsets;
+            std::vector<std::size_t> _targets;
+            std::vector<std::size_t> _edge_ids;
+            std::vector<std::pair<std::size_t, std::size_t>> _endpoints;
+        };
+
+        inline std::size_t source(const CSREdge &e, const CSRGraph&) {
+            return e.source;
+        }
+
+        inline std::size_t target(const CSREdge &e, const CSRGraph&) {
+            return e.target;
+        }
+
+        inline std::pair<CSRGraph::out_edge_iterator, CSRGraph::out_edge_iterator> out_edges(std::size_t u,
+                const CSRGraph &g) {
+            return g.out_edges(u);
+        }
+
+        inline std::size_t out_degree(std::size_t u, const CSRGraph &g) {
+            return g.degree(u);
+        }
+
+        inline std::size_t degree(std::size_t u, const CSRGraph &g) {
+            return g.degree(u);
+        }
+
+        inline std::pair<CSRGraph::vertex_iterator, CSRGraph::vertex_iterator> vertices(const CSRGraph &g) {
+            return std::make_pair(CSRGraph::vertex_iterator(0), CSRGraph::vertex_iterator(g.num_vertices()));
+        }
+
+        inline std::size_t num_vertices(const CSRGraph &g) {
+            return g.num_vertices();
+        }
+
+        inline std::size_t vertex(std::size_t i, const CSRGraph&) {
+            return i;
+        }
+
+        inline std::pair<CSRGraph::edge_iterator, CSRGraph::edge_iterator> edges(const CSRGraph &g) {
+            return g.edges();
+        }
+
+        inline std::size_t num_edges(const CSRGraph &g) {
+            return g.num_edges();
+        }
+
+        inline boost::typed_identity_property_map<std::size_t> get(boost::vertex_index_t, const CSRGraph&) {
+            return boost::typed_identity_property_map<std::size_t>();
+        }
+
+        inline std::size_t get(boost::vertex_index_t, const CSRGraph&, std::size_t v) {
+            return v;
+        }
+
+        inline CSREdgeIndexMap get(boost::edge_index_t, const CSRGraph&) {
+            return CSREdgeIndexMap();
+        }
+
+        inline std::size_t get(boost::edge_index_t, const CSRGraph&, const CSREdge &e) {
+            return e.id;
+        }
+
+    } // detail
+
+} // parmcb
+
+namespace boost {
+
+    // qualified calls such as boost::out_edges() must find the CSR graph functions
+
+    using parmcb::detail::source;
+    using parmcb::detail::target;
+    using parmcb::detail::out_edges;
+    using parmcb::detail::out_degree;
+    using parmcb::detail::degree;
+    using parmcb::detail::vertices;
+    using parmcb::detail::num_vertices;
+    using parmcb::detail::vertex;
+    using parmcb::detail::edges;
+    using parmcb::detail::num_edges;
+    using parmcb::detail::get;
+
+    template<>
+    struct property_map<parmcb::detail::CSRGraph, vertex_index_t> {
+        typedef typed_identity_property_map<std::size_t> type;
+        typedef typed_identity_property_map<std::size_t> const_type;
+    };
+
+    template<>
+    struct property_map<parmcb::detail::CSRGraph, edge_index_t> {
+        typedef parmcb::detail::CSREdgeIndexMap type;
+        typedef parmcb::detail::CSREdgeIndexMap const_type;
+    };
+
+    template<>
+    struct hash<parmcb::detail::CSREdge> {
+        std::size_t operator()(const parmcb::detail::CSREdge &e) const {
+            return parmcb::detail::hash_value(e);
+        }
+    };
+
+} // boost
+
+namespace parmcb {
+
+    namespace detail {
+
+        template<class Cycle, class Translator, class CycleOutputIterator>
+        struct CSRCycleOutput {
+            const Translator *translator;
+            CycleOutputIterator *out;
+
+            template<class CSRCycle>
+            void operator()(const CSRCycle &csr_cycle) const {
+                Cycle cycle;
+                for (const auto &e : csr_cycle) {
+                    cycle.push_back(translator->edge(e));
+                }
+                *(*out)++ = cycle;
+            }
+        };
+
+        /*
+         * CSR snapshot of a graph together with its edge weights. Vertex i of the snapshot is
+         * the vertex with index i in the original graph and edge ids follow the order of
+         * boost::edges(). Keeps the mapping back to the original descriptors.
+         */
+        template<class Graph, class WeightMap>
+        class CSRSnapshot {
+        public:
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef boost::iterator_property_map<typename std::vector<WeightType>::const_iterator, CSREdgeIndexMap,
+                    WeightType, const WeightType&> CSRWeightMap;
+
+            CSRSnapshot(const Graph &g, const WeightMap &weight_map) {
+                auto index_map = boost::get(boost::vertex_index, g);
+                std::size_t n = boost::num_vertices(g);
+                _vertices.resize(n);
+                for (const auto &v : boost::make_iterator_range(boost::vertices(g))) {
+                    _vertices[index_map[v]] = v;
+                }
+                std::vector<std::pair<std::size_t, std::size_t>> endpoints;
+                endpoints.reserve(boost::num_edges(g));
+                _edges.reserve(boost::num_edges(g));
+                _weights.reserve(boost::num_edges(g));
+                for (const auto &e : boost::make_iterator_range(boost::edges(g))) {
+                    endpoints.emplace_back(index_map[boost::source(e, g)], index_map[boost::target(e, g)]);
+                    _edges.push_back(e);
+                    _weights.push_back(boost::get(weight_map, e));
+                }
+                _graph = CSRGraph(n, endpoints);
+            }
+
+            CSRSnapshot(const CSRSnapshot &other) = delete;
+            CSRSnapshot& operator=(const CSRSnapshot &other) = delete;
+
+            const CSRGraph& graph() const {
+                return _graph;
+            }
+
+            CSRWeightMap weight_map() const {
+                return CSRWeightMap(_weights.begin(), CSREdgeIndexMap());
+            }
+
+            const Edge& edge(const CSREdge &e) const {
+                return _edges[e.id];
+            }
+
+            const Edge& edge(std::size_t id) const {
+                return _edges[id];
+            }
+
+            const Vertex& vertex(std::size_t v) const {
+                return _vertices[v];
+            }
+
+            /*
+             * Output iterator accepting cycles of the snapshot, which writes them as lists of
+             * original edges to out. The iterator refers to out, which must outlive it.
+             */
+            template<class CycleOutputIterator>
+            boost::iterators::function_output_iterator<CSRCycleOutput<std::list<Edge>, CSRSnapshot, CycleOutputIterator>> cycle_output(
+                    CycleOutputIterator &out) const {
+                return boost::iterators::make_function_output_iterator(
+                        CSRCycleOutput<std::list<Edge>, CSRSnapshot, CycleOutputIterator> { this, &out });
+            }
+
+        private:
+            CSRGraph _graph;
+            std::vector<WeightType> _weights;
+            std::vector<Edge> _edges;
+            std::vector<Vertex> _vertices;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef PARMCB_DETAIL_CYCLE_CACHE_HPP_
+#define PARMCB_DETAIL_CYCLE_CACHE_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <parmcb/detail/edge_bitmap.hpp>
+
+namespace parmcb {
+
+    /*
+     * Statistics of the pool of previously found cycles used to seed the odd cycle searches.
+     */
+    struct cycle_cache_statistics {
+        // iterations which looked for an odd cycle in the pool
+        std::size_t lookups = 0;
+        // lookups which found an odd cycle and used it as the initial weight limit
+        std::size_t hits = 0;
+        // hits where no lighter cycle was found, so the cached cycle joined the basis
+        std::size_t answers = 0;
+        // cycles added to the pool
+        std::size_t insertions = 0;
+
+        double hit_rate() const {
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+        }
+    };
+
+    namespace detail {
+
+        /*
+         * Bounded pool of the lightest cycles discovered by the searches, each stored as the
+         * sorted forest index ids of its edges. A cycle is odd with respect to a support vector
+         * when it shares an odd number of edges with it, which is tested against the bitmap of
+         * the signed edges.
+         */
+        template<class WeightType>
+        class CycleCache {
+        public:
+            static constexpr std::size_t npos = (std::numeric_limits<std::size_t>::max)();
+
+            explicit CycleCache(std::size_t capacity) :
+                    capacity(capacity) {
+            }
+
+            /*
+             * Add a cycle unless it is already present. When the pool is full the cycle replaces
+             * the heaviest one if it is lighter.
+             */
+            void insert(std::vector<std::size_t> &&ids, const WeightType &weight) {
+                if (capacity == 0) {
+                    return;
+                }
+                std::sort(ids.begin(), ids.end());
+                std::size_t heaviest = npos;
+                for (std::size_t i = 0; i < cycles.size(); i++) {
+                    if (!(weights[i] < weight) && !(weight < weights[i]) && cycles[i] == ids) {
+                        return;
+                    }
+                    if (heaviest == npos || weights[heaviest] < weights[i]) {
+                        heaviest = i;
+                    }
+                }
+                if (cycles.size() < capacity) {
+                    cycles.push_back(std::move(ids));
+                    weights.push_back(weight);
+                } else if (weight < weights[heaviest]) {
+                    cycles[heaviest] = std::move(ids);
+                    weights[heaviest] = weight;
+                } else {
+                    return;
+                }
+                stats.insertions++;
+            }
+
+            /*
+             * Remove a cycle, given by its sorted ids, which joined the basis. Later support
+             * vectors are orthogonal to it, so it can never be odd again.
+             */
+            void erase(const std::vector<std::size_t> &ids) {
+                for (std::size_t i = 0; i < cycles.size(); i++) {
+                    if (cycles[i] == ids) {
+                        cycles[i] = std::move(cycles.back());
+                        weights[i] = weights.back();
+                        cycles.pop_back();
+                        weights.pop_back();
+                        return;
+                    }
+                }
+            }
+
+            /*
+             * Position of the lightest cycle which is odd with respect to the signed edges, or npos.
+             */
+            std::size_t lightest_odd(const EdgeBitmap &signed_edges) {
+                stats.lookups++;
+                std::size_t best = npos;
+                for (std::size_t i = 0; i < cycles.size(); i++) {
+                    if (best != npos && !(weights[i] < weights[best])) {
+                        continue;
+                    }
+                    bool odd = false;
+                    for (auto id : cycles[i]) {
+                        odd ^= signed_edges.test(id);
+                    }
+                    if (odd) {
+                        best = i;
+                    }
+                }
+                if (best != npos) {
+                    stats.hits++;
+                }
+                return best;
+            }
+
+            const std::vector<std::size_t>& cycle(std::size_t i) const {
+                return cycles[i];
+            }
+
+            const WeightType& weight(std::size_t i) const {
+                return weights[i];
+            }
+
+            std::size_t size() const {
+                return cycles.size();
+            }
+
+            void record_answer() {
+                stats.answers++;
+            }
+
+            const cycle_cache_statistics& statistics() const {
+                return stats;
+            }
+
+        private:
+            const std::size_t capacity;
+            std::vector<std::vector<std::size_t>> cycles;
+            std::vector<WeightType> weights;
+            cycle_cache_statistics stats;
+        };
+
+        template<class WeightType>
+        constexpr std::size_t CycleCache<WeightType>::npos;
+
+    } // detail
+
+} // parmcb
+
+#endif
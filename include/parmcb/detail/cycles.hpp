@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <map>
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/util.hpp>
 #include <parmcb/sptrees.hpp>
 #include <parmcb/detail/fvs.hpp>
@@ -34,27 +35,26 @@ namespace parmcb {
 
     namespace detail {
 
-        template<class Graph, class WeightMap>
+        template<class Graph, class WeightMap, bool ParallelUsingTBB = false>
         struct HortonCyclesBuilder {
 
             void operator()(const Graph &g, const WeightMap &weight_map,
                     std::vector<parmcb::SPTree<Graph, WeightMap>> &trees,
                     std::vector<CandidateCycle<Graph, WeightMap>> &cycles) {
-                typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
-                VertexIt vi, viend;
-                for (boost::tie(vi, viend) = boost::vertices(g); vi != viend; ++vi) {
-                    auto v = *vi;
-                    trees.emplace_back(trees.size(), g, boost::get(boost::vertex_index, g), weight_map, v);
-                }
-                for (auto &tree : trees) {
-                    std::vector<CandidateCycle<Graph, WeightMap>> tree_cycles = tree.create_candidate_cycles();
-                    cycles.insert(cycles.end(), tree_cycles.begin(), tree_cycles.end());
+                typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+
+                std::vector<Vertex> sources;
+                for (const auto &v : boost::make_iterator_range(boost::vertices(g))) {
+                    sources.push_back(v);
                 }
+                parmcb::SPTrees<Graph, WeightMap, ParallelUsingTBB> builder(g, weight_map);
+                builder.build_trees(sources, trees);
+                builder.build_candidate_cycles(trees, cycles);
             }
 
         };
 
-        template<class Graph, class WeightMap>
+        template<class Graph, class WeightMap, bool ParallelUsingTBB = false>
         struct FVSCyclesBuilder {
 
             void operator()(const Graph &g, const WeightMap &weight_map,
@@ -64,25 +64,21 @@ namespace parmcb {
 
                 std::vector<Vertex> feedback_vertex_set;
                 parmcb::greedy_fvs(g, std::back_inserter(feedback_vertex_set));
-                for (auto v : feedback_vertex_set) {
-                    trees.emplace_back(trees.size(), g, boost::get(boost::vertex_index, g), weight_map, v);
-                }
-                for (auto &tree : trees) {
-                    std::vector<CandidateCycle<Graph, WeightMap>> tree_cycles = tree.create_candidate_cycles();
-                    cycles.insert(cycles.end(), tree_cycles.begin(), tree_cycles.end());
-                }
+                parmcb::SPTrees<Graph, WeightMap, ParallelUsingTBB> builder(g, weight_map);
+                builder.build_trees(feedback_vertex_set, trees);
+                builder.build_candidate_cycles(trees, cycles);
             }
 
         };
 
-        template<class Graph, class WeightMap>
+        template<class Graph, class WeightMap, bool ParallelUsingTBB = false>
         struct ISOCyclesBuilder {
 
             void operator()(const Graph &g, const WeightMap &weight_map,
                     std::vector<parmcb::SPTree<Graph, WeightMap>> &trees,
                     std::vector<CandidateCycle<Graph, WeightMap>> &cycles) {
                 typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
-                typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
+                typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
                 typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
                 typedef typename boost::property_traits<WeightMap>::value_type WeightType;
 
@@ -92,24 +88,19 @@ namespace parmcb {
                  * Build all shortest path trees
                  */
                 std::vector<std::size_t> trees_index_map(boost::num_vertices(g));
-                VertexIt ui, uiend;
-                std::size_t next_tree = 0;
-                for (boost::tie(ui, uiend) = boost::vertices(g); ui != uiend; ++ui) {
-                    auto u = *ui;
-                    auto uindex = index_map[u];
-                    trees.emplace_back(next_tree, g, boost::get(boost::vertex_index, g), weight_map, u);
-                    trees_index_map[uindex] = next_tree;
-                    next_tree++;
+                std::vector<Vertex> sources;
+                for (const auto &u : boost::make_iterator_range(boost::vertices(g))) {
+                    trees_index_map[index_map[u]] = trees.size() + sources.size();
+                    sources.push_back(u);
                 }
+                parmcb::SPTrees<Graph, WeightMap, ParallelUsingTBB> builder(g, weight_map);
+                builder.build_trees(sources, trees);
 
                 /*
                  * Build all of Horton's candidate cycles
                  */
                 std::vector<CandidateCycle<Graph, WeightMap>> allcycles;
-                for (const auto &tree : trees) {
-                    std::vector<CandidateCycle<Graph, WeightMap>> tree_cycles = tree.create_candidate_cycles();
-                    allcycles.insert(allcycles.end(), tree_cycles.begin(), tree_cycles.end());
-                }
+                builder.build_candidate_cycles(trees, allcycles);
 
                 /*
                  * Create graph with candidate cycles
@@ -173,7 +164,7 @@ namespace parmcb {
                             if (u == first_v_xprime) {
                                 boost::add_edge(*alli,
                                         cycle_to_vertex[std::make_pair(trees_index_map[index_map[v]],
-                                                tree_x.node(xprime)->pred())], cycles_g);
+                                                tree_x.pred(xprime))], cycles_g);
                             } else {
                                 boost::put(bad_map, *alli, true);
                             }
@@ -207,16 +198,12 @@ namespace parmcb {
                         auto e = boost::get(edge_map, v);
                         parmcb::SPTree<Graph, WeightMap> &tree_v = trees[tree];
 
-                        std::shared_ptr<SPNode<Graph, WeightMap>> spnode_v = tree_v.node(boost::source(e, g));
-                        if (spnode_v == nullptr) {
-                            continue;
-                        }
-                        std::shared_ptr<SPNode<Graph, WeightMap>> spnode_u = tree_v.node(boost::target(e, g));
-                        if (spnode_u == nullptr) {
+                        if (!tree_v.is_reachable(boost::source(e, g)) || !tree_v.is_reachable(boost::target(e, g))) {
                             continue;
                         }
 
-                        WeightType cycle_weight = boost::get(weight_map, e) + spnode_v->weight() + spnode_u->weight();
+                        WeightType cycle_weight = boost::get(weight_map, e) + tree_v.distance(boost::source(e, g))
+                                + tree_v.distance(boost::target(e, g));
                         cycles.emplace_back(tree, e, cycle_weight);
                         is_in_output[component] = true;
                     }
@@ -18,6 +18,8 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/detail/d_ary_heap.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/detail/radix_heap.hpp>
 #include <parmcb/detail/util.hpp>
 
 namespace parmcb {
@@ -30,14 +32,14 @@ namespace parmcb {
             typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
 
             std::vector<std::size_t> &index_in_heap;
-            const VertexIndexMapType &index_map;
+            VertexIndexMapType index_map;
 
             IndexInHeapFunctor(std::vector<std::size_t> &index_in_heap, const VertexIndexMapType &index_map) :
                     index_in_heap(index_in_heap), index_map(index_map) {
             }
 
             std::size_t& operator()(const Vertex &v) const {
-                return index_in_heap.at(index_map[v]);
+                return index_in_heap[index_map[v]];
             }
         };
 
@@ -53,9 +55,9 @@ namespace parmcb {
         typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
         typedef typename boost::property_traits<WeightMap>::value_type WeightType;
         typedef typename boost::property_traits<DistanceMap>::value_type DistanceType;
-        typedef boost::d_ary_heap_indirect<Vertex, 4,
+        typedef typename parmcb::detail::dijkstra_queue<Vertex,
                 boost::function_property_map<parmcb::detail::VertexIndexFunctor<Graph, std::size_t>, Vertex,
-                        std::size_t&>, DistanceMap, std::less<DistanceType>> VertexQueue;
+                        std::size_t&>, DistanceMap, std::less<DistanceType>>::type VertexQueue;
 
         std::less<DistanceType> compare;
         parmcb::detail::closed_plus<DistanceType> combine = parmcb::detail::closed_plus<DistanceType>();
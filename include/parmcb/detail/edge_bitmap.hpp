@@ -0,0 +1,139 @@
+#ifndef PARMCB_DETAIL_EDGE_BITMAP_HPP_
+#define PARMCB_DETAIL_EDGE_BITMAP_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * A bit per edge, indexed by a dense edge id in [0, m). Membership tests are a single
+         * word access. The positions set since the last clear are remembered, so that clearing
+         * or reassigning costs proportional to the number of set bits and not to m.
+         */
+        class EdgeBitmap {
+        public:
+            typedef std::size_t size_type;
+
+            EdgeBitmap() :
+                    EdgeBitmap(0) {
+            }
+
+            explicit EdgeBitmap(size_type size) :
+                    _size(size), words((size + 63) / 64, 0) {
+            }
+
+            size_type size() const {
+                return _size;
+            }
+
+            bool test(size_type i) const {
+                assert(i < _size);
+                return (words[i >> 6] >> (i & 63)) & 1;
+            }
+
+            void set(size_type i) {
+                assert(i < _size);
+                words[i >> 6] |= std::uint64_t(1) << (i & 63);
+                touched.push_back(i);
+            }
+
+            void reset(size_type i) {
+                assert(i < _size);
+                words[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+            }
+
+            void clear() {
+                for (auto i : touched) {
+                    words[i >> 6] = 0;
+                }
+                touched.clear();
+            }
+
+            /*
+             * Make the bitmap contain exactly the ids in the range [first, last).
+             */
+            template<class InputIterator>
+            void assign(InputIterator first, InputIterator last) {
+                clear();
+                for (; first != last; ++first) {
+                    set(*first);
+                }
+            }
+
+        private:
+            size_type _size;
+            std::vector<std::uint64_t> words;
+            std::vector<size_type> touched;
+        };
+
+        /*
+         * Rank of each signed edge in the order of a support vector, indexed by a dense edge id.
+         * Unsigned edges have rank zero and the signed edge at position i has rank i + 1. The
+         * search of the i-th signed edge hides the signed edges at position i or later, which is
+         * a single comparison of the rank with i instead of a set of hidden edges per search.
+         */
+        class EdgeRanks {
+        public:
+            typedef std::size_t size_type;
+
+            /*
+             * Position after every signed edge, nothing is hidden.
+             */
+            static constexpr size_type none = (std::numeric_limits<std::uint32_t>::max)();
+
+            explicit EdgeRanks(size_type size) :
+                    ranks(size, 0) {
+            }
+
+            size_type size() const {
+                return ranks.size();
+            }
+
+            bool test(size_type i) const {
+                return ranks[i] != 0;
+            }
+
+            /*
+             * Whether edge i is signed with position first_hidden or later.
+             */
+            bool hidden(size_type i, size_type first_hidden) const {
+                return ranks[i] > first_hidden;
+            }
+
+            /*
+             * Rank the ids in the range [first, last) in order.
+             */
+            template<class InputIterator>
+            void assign(InputIterator first, InputIterator last) {
+                for (auto i : ranked) {
+                    ranks[i] = 0;
+                }
+                ranked.clear();
+                for (; first != last; ++first) {
+                    assert(ranked.size() + 1 < none);
+                    ranked.push_back(*first);
+                    ranks[*first] = static_cast<std::uint32_t>(ranked.size());
+                }
+            }
+
+        private:
+            std::vector<std::uint32_t> ranks;
+            std::vector<size_type> ranked;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -18,6 +18,8 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/heap/pairing_heap.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
+
 namespace parmcb {
 
     namespace detail {
@@ -0,0 +1,97 @@
+#ifndef PARMCB_DETAIL_GRAPH_REPLICA_HPP_
+#define PARMCB_DETAIL_GRAPH_REPLICA_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/forestindex.hpp>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Read-only data of the graph used by the searches of one NUMA node. The generic version
+         * refers to the original data, the CSR snapshots are copied so that each node reads its
+         * own memory. The copy is placed by the first touch and must therefore be constructed by
+         * a thread of the node.
+         */
+        template<class Graph, class WeightMap>
+        class GraphReplica {
+        public:
+            GraphReplica(const Graph &g, const WeightMap &weight_map, const ForestIndex<Graph> &forest_index) :
+                    _g(g), _weight_map(weight_map), _forest_index(forest_index) {
+            }
+
+            const Graph& graph() const {
+                return _g;
+            }
+
+            const WeightMap& weight_map() const {
+                return _weight_map;
+            }
+
+            const ForestIndex<Graph>& forest_index() const {
+                return _forest_index;
+            }
+
+        private:
+            const Graph &_g;
+            const WeightMap _weight_map;
+            const ForestIndex<Graph> &_forest_index;
+        };
+
+        template<class Iterator, class WeightType>
+        class GraphReplica<CSRGraph, boost::iterator_property_map<Iterator, CSREdgeIndexMap, WeightType, const WeightType&>> {
+        public:
+            typedef boost::iterator_property_map<Iterator, CSREdgeIndexMap, WeightType, const WeightType&> WeightMap;
+
+            GraphReplica(const CSRGraph &g, const WeightMap &weight_map, const ForestIndex<CSRGraph> &forest_index) :
+                    _g(g), _weights(copy_weights(g, weight_map)), _weight_map(_weights.begin(), CSREdgeIndexMap()), _forest_index(
+                            forest_index) {
+            }
+
+            GraphReplica(const GraphReplica &other) = delete;
+            GraphReplica& operator=(const GraphReplica &other) = delete;
+
+            const CSRGraph& graph() const {
+                return _g;
+            }
+
+            const WeightMap& weight_map() const {
+                return _weight_map;
+            }
+
+            const ForestIndex<CSRGraph>& forest_index() const {
+                return _forest_index;
+            }
+
+        private:
+            static std::vector<WeightType> copy_weights(const CSRGraph &g, const WeightMap &weight_map) {
+                std::vector<WeightType> weights(g.num_edges());
+                for (std::size_t id = 0; id < weights.size(); id++) {
+                    weights[id] = boost::get(weight_map, g.edge(id));
+                }
+                return weights;
+            }
+
+            const CSRGraph _g;
+            const std::vector<WeightType> _weights;
+            const WeightMap _weight_map;
+            const ForestIndex<CSRGraph> _forest_index;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef PARMCB_DETAIL_LANDMARKS_HPP_
+#define PARMCB_DETAIL_LANDMARKS_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include <boost/property_map/property_map.hpp>
+#include <boost/property_map/function_property_map.hpp>
+#include <boost/graph/graph_traits.hpp>
+
+#include <parmcb/detail/dijkstra.hpp>
+#include <parmcb/detail/util.hpp>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Distances from k landmark vertices, which give lower bounds on the distance between any
+         * two vertices by the triangle inequality. A path in the signed graph projects to a walk
+         * of the same weight in the graph, thus the bounds also hold for signed paths.
+         *
+         * The first landmark is the vertex farthest from the first vertex and each next one is
+         * the vertex farthest from the landmarks already chosen, where vertices of components
+         * without a landmark count as infinitely far. The distances are stored per vertex, using
+         * k values of the weight type for each.
+         */
+        template<class Graph, class WeightMap>
+        class Landmarks {
+        public:
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
+
+            Landmarks(const Graph &g, const WeightMap &weight_map, std::size_t k) :
+                    index_map(boost::get(boost::vertex_index, g)), n(boost::num_vertices(g)), k(
+                            std::min(k, boost::num_vertices(g))), distances(n * this->k) {
+                const WeightType inf = (std::numeric_limits<WeightType>::max)();
+                if (this->k == 0) {
+                    return;
+                }
+
+                std::vector<WeightType> dist(n);
+                boost::function_property_map<VertexIndexFunctor<Graph, WeightType>, Vertex, WeightType&> dist_map(
+                        VertexIndexFunctor<Graph, WeightType>(dist, index_map));
+                std::vector<std::tuple<bool, Edge>> pred(n);
+                boost::function_property_map<VertexIndexFunctor<Graph, std::tuple<bool, Edge>>, Vertex,
+                        std::tuple<bool, Edge>&> pred_map(
+                        VertexIndexFunctor<Graph, std::tuple<bool, Edge>>(pred, index_map));
+                auto shortest_paths = [&](const Vertex &s) {
+                    std::fill(dist.begin(), dist.end(), inf);
+                    std::fill(pred.begin(), pred.end(), std::make_tuple(false, Edge()));
+                    parmcb::dijkstra(g, weight_map, s, dist_map, pred_map);
+                };
+
+                // distance from the closest landmark
+                std::vector<WeightType> closest(n, inf);
+                shortest_paths(*boost::vertices(g).first);
+                Vertex landmark = farthest(g, dist);
+                for (std::size_t l = 0; l < this->k; l++) {
+                    shortest_paths(landmark);
+                    for (std::size_t i = 0; i < n; i++) {
+                        distances[i * this->k + l] = dist[i];
+                        closest[i] = std::min(closest[i], dist[i]);
+                    }
+                    landmark = farthest(g, closest);
+                }
+            }
+
+            Landmarks(const Landmarks &other) = delete;
+            Landmarks& operator=(const Landmarks &other) = delete;
+
+            std::size_t size() const {
+                return k;
+            }
+
+            const WeightType* row(const Vertex &v) const {
+                return distances.data() + index_map[v] * k;
+            }
+
+            /*
+             * Lower bound on the distance between the vertices with the given rows, or the
+             * maximum value of the weight type if they are not connected.
+             */
+            WeightType lower_bound(const WeightType *u, const WeightType *v) const {
+                const WeightType inf = (std::numeric_limits<WeightType>::max)();
+                WeightType bound = WeightType();
+                for (std::size_t l = 0; l < k; l++) {
+                    if (u[l] == inf || v[l] == inf) {
+                        if (u[l] != v[l]) {
+                            return inf;
+                        }
+                        continue;
+                    }
+                    WeightType d = u[l] < v[l] ? v[l] - u[l] : u[l] - v[l];
+                    if (bound < d) {
+                        bound = d;
+                    }
+                }
+                return bound;
+            }
+
+        private:
+            Vertex farthest(const Graph &g, const std::vector<WeightType> &dist) const {
+                Vertex best = *boost::vertices(g).first;
+                for (const auto &v : boost::make_iterator_range(boost::vertices(g))) {
+                    if (dist[index_map[best]] < dist[index_map[v]]) {
+                        best = v;
+                    }
+                }
+                return best;
+            }
+
+            VertexIndexMapType index_map;
+            const std::size_t n;
+            const std::size_t k;
+            std::vector<WeightType> distances;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
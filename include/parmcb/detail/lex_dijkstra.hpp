@@ -18,6 +18,7 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/detail/d_ary_heap.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/detail/dijkstra.hpp>
 #include <parmcb/detail/util.hpp>
 
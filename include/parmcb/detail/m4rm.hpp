@@ -0,0 +1,102 @@
+#ifndef PARMCB_DETAIL_M4RM_HPP_
+#define PARMCB_DETAIL_M4RM_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Method of Four Russians tables over up to 64 bit-packed rows of a GF(2) matrix.
+         * Rows are split into groups of GROUP_BITS and all 2^GROUP_BITS sums of the rows of
+         * each group are precomputed. A product of a bit vector with the matrix then costs
+         * one table lookup per group instead of one row addition per set bit.
+         */
+        class M4RMTable {
+        public:
+            static constexpr std::size_t GROUP_BITS = 8;
+            static constexpr std::size_t GROUP_SIZE = std::size_t(1) << GROUP_BITS;
+
+            M4RMTable() :
+                    _rows(0), _words(0) {
+            }
+
+            /*
+             * Build the tables for rows given as pointers to words_per_row words each.
+             */
+            void build(const std::vector<const std::uint64_t*> &rows, std::size_t words_per_row) {
+                assert(rows.size() <= 64);
+                _rows = rows.size();
+                _words = words_per_row;
+                std::size_t groups = (_rows + GROUP_BITS - 1) / GROUP_BITS;
+                table.assign(groups * GROUP_SIZE * _words, 0);
+                for (std::size_t g = 0; g < groups; g++) {
+                    std::uint64_t *base = &table[g * GROUP_SIZE * _words];
+                    for (std::size_t c = 1; c < GROUP_SIZE; c++) {
+                        std::size_t low = ctz(c);
+                        std::size_t row = g * GROUP_BITS + low;
+                        std::uint64_t *entry = base + c * _words;
+                        const std::uint64_t *prev = base + (c & (c - 1)) * _words;
+                        if (row < _rows) {
+                            const std::uint64_t *r = rows[row];
+                            for (std::size_t w = 0; w < _words; w++) {
+                                entry[w] = prev[w] ^ r[w];
+                            }
+                        } else {
+                            for (std::size_t w = 0; w < _words; w++) {
+                                entry[w] = prev[w];
+                            }
+                        }
+                    }
+                }
+            }
+
+            /*
+             * out ^= sum of the rows whose bit is set in mask.
+             */
+            void multiply(std::uint64_t mask, std::uint64_t *out) const {
+                std::size_t groups = (_rows + GROUP_BITS - 1) / GROUP_BITS;
+                for (std::size_t g = 0; g < groups && mask != 0; g++, mask >>= GROUP_BITS) {
+                    std::size_t c = mask & (GROUP_SIZE - 1);
+                    if (c == 0) {
+                        continue;
+                    }
+                    const std::uint64_t *entry = &table[(g * GROUP_SIZE + c) * _words];
+                    for (std::size_t w = 0; w < _words; w++) {
+                        out[w] ^= entry[w];
+                    }
+                }
+            }
+
+            std::size_t words_per_row() const {
+                return _words;
+            }
+
+        private:
+            static std::size_t ctz(std::size_t c) {
+                std::size_t bit = 0;
+                while (!((c >> bit) & 1)) {
+                    bit++;
+                }
+                return bit;
+            }
+
+            std::size_t _rows;
+            std::size_t _words;
+            std::vector<std::uint64_t> table;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
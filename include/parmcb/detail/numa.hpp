@@ -0,0 +1,251 @@
+#ifndef PARMCB_DETAIL_NUMA_HPP_
+#define PARMCB_DETAIL_NUMA_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <parmcb/config.hpp>
+#include <parmcb/execution_context.hpp>
+
+#ifdef PARMCB_HAVE_NUMA
+#include <numa.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+#endif
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Parse a list of cpus in the format of /sys, such as "0-3,8,10-11".
+         */
+        inline std::vector<int> parse_cpu_list(const std::string &list) {
+            std::vector<int> cpus;
+            std::stringstream ss(list);
+            std::string range;
+            while (std::getline(ss, range, ',')) {
+                if (range.find_first_not_of(" \t\r\n") == std::string::npos) {
+                    continue;
+                }
+                std::size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; cpu++) {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        }
+
+        /*
+         * The cpus of each NUMA node which the process may run on, indexed by node. Uses libnuma
+         * when available and /sys otherwise. Without any NUMA information the machine is a single
+         * node with all allowed cpus.
+         */
+        inline std::vector<std::vector<int>> numa_topology() {
+            std::vector<int> allowed;
+#ifdef __linux__
+            cpu_set_t mask;
+            if (sched_getaffinity(0, sizeof(cpu_set_t), &mask) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                    if (CPU_ISSET(cpu, &mask)) {
+                        allowed.push_back(cpu);
+                    }
+                }
+            }
+#endif
+            auto is_allowed = [&](int cpu) {
+                return allowed.empty() || std::binary_search(allowed.begin(), allowed.end(), cpu);
+            };
+
+            std::vector<std::vector<int>> nodes;
+#ifdef PARMCB_HAVE_NUMA
+            if (numa_available() >= 0) {
+                struct bitmask *cpus = numa_allocate_cpumask();
+                for (int node = 0; node <= numa_max_node(); node++) {
+                    nodes.emplace_back();
+                    if (numa_node_to_cpus(node, cpus) != 0) {
+                        continue;
+                    }
+                    for (unsigned int cpu = 0; cpu < cpus->size; cpu++) {
+                        if (numa_bitmask_isbitset(cpus, cpu) && is_allowed(static_cast<int>(cpu))) {
+                            nodes.back().push_back(static_cast<int>(cpu));
+                        }
+                    }
+                }
+                numa_free_cpumask(cpus);
+            }
+#endif
+            if (nodes.empty()) {
+                for (int node = 0;; node++) {
+                    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    if (!in) {
+                        break;
+                    }
+                    std::string list;
+                    std::getline(in, list);
+                    nodes.emplace_back();
+                    for (int cpu : parse_cpu_list(list)) {
+                        if (is_allowed(cpu)) {
+                            nodes.back().push_back(cpu);
+                        }
+                    }
+                }
+            }
+            bool any = std::any_of(nodes.begin(), nodes.end(), [](const std::vector<int> &cpus) {
+                return !cpus.empty();
+            });
+            if (!any) {
+                nodes.assign(1, allowed);
+            }
+            return nodes;
+        }
+
+        class NumaDomains;
+
+#ifdef PARMCB_HAVE_TBB
+        /*
+         * One task arena per NUMA node, whose threads are bound to the cpus of the node. Work is
+         * dispatched to all nodes at once by for_each(). The total concurrency, when given, is
+         * split among the nodes by their number of cpus.
+         */
+        class NumaDomains {
+        public:
+            NumaDomains(const std::vector<std::vector<int>> &nodes, std::size_t concurrency = 0, bool pin_threads =
+                    false) {
+                std::vector<std::vector<int>> used;
+                std::size_t total = 0;
+                for (const auto &cpus : nodes) {
+                    if (!cpus.empty()) {
+                        used.push_back(cpus);
+                        total += cpus.size();
+                    }
+                }
+                if (used.empty()) {
+                    throw std::invalid_argument("No NUMA node with cpus");
+                }
+                if (concurrency > 0 && concurrency < used.size()) {
+                    used.resize(concurrency);
+                }
+                for (const auto &cpus : used) {
+                    std::size_t threads = cpus.size();
+                    if (concurrency > 0 && concurrency < total) {
+                        threads = (std::max)(std::size_t(1), cpus.size() * concurrency / total);
+                    }
+                    domains.emplace_back(new Domain(cpus, threads, pin_threads));
+                }
+            }
+
+            explicit NumaDomains(const execution_context &context) :
+                    NumaDomains(select(numa_topology(), context.numa_node), context.concurrency, context.pin_threads) {
+            }
+
+            NumaDomains(const NumaDomains &other) = delete;
+            NumaDomains& operator=(const NumaDomains &other) = delete;
+
+            std::size_t size() const {
+                return domains.size();
+            }
+
+            std::size_t concurrency(std::size_t i) const {
+                return domains[i]->threads;
+            }
+
+            /*
+             * Run f(i) in the arena of each node i and wait for all of them.
+             */
+            template<class F>
+            void for_each(F f) {
+                for (std::size_t i = 0; i < domains.size(); i++) {
+                    Domain &d = *domains[i];
+                    d.arena.execute([&d, &f, i] {
+                        d.group.run([&f, i] {
+                            f(i);
+                        });
+                    });
+                }
+                for (auto &d : domains) {
+                    Domain &domain = *d;
+                    domain.arena.execute([&domain] {
+                        domain.group.wait();
+                    });
+                }
+            }
+
+            /*
+             * Part of [first, last) assigned to node i, proportional to its threads.
+             */
+            std::pair<std::size_t, std::size_t> part(std::size_t first, std::size_t last, std::size_t i) const {
+                std::size_t total = 0;
+                std::size_t before = 0;
+                for (std::size_t j = 0; j < domains.size(); j++) {
+                    if (j < i) {
+                        before += domains[j]->threads;
+                    }
+                    total += domains[j]->threads;
+                }
+                std::size_t length = last - first;
+                return std::make_pair(first + length * before / total,
+                        first + length * (before + domains[i]->threads) / total);
+            }
+
+        private:
+            static std::vector<std::vector<int>> select(const std::vector<std::vector<int>> &nodes, int node) {
+                if (node < 0) {
+                    return nodes;
+                }
+                if (static_cast<std::size_t>(node) >= nodes.size() || nodes[node].empty()) {
+                    throw std::invalid_argument("Unknown NUMA node");
+                }
+                return std::vector<std::vector<int>>(1, nodes[node]);
+            }
+
+            struct Domain {
+                Domain(const std::vector<int> &cpus, std::size_t threads, bool pin_threads) :
+                        threads(threads), arena(static_cast<int>(threads)) {
+                    arena.initialize();
+#ifdef __linux__
+                    observer.reset(new ThreadPinningObserver(arena, cpus, pin_threads));
+#else
+                    (void) cpus;
+                    (void) pin_threads;
+#endif
+                }
+
+                std::size_t threads;
+                tbb::task_arena arena;
+                tbb::task_group group;
+#ifdef __linux__
+                std::unique_ptr<ThreadPinningObserver> observer;
+#endif
+            };
+
+            std::vector<std::unique_ptr<Domain>> domains;
+        };
+#endif
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef PARMCB_DETAIL_RADIX_HEAP_HPP_
+#define PARMCB_DETAIL_RADIX_HEAP_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/property_map/property_map.hpp>
+#include <boost/graph/detail/d_ary_heap.hpp>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Monotone radix heap over integral distances, with the interface of
+         * boost::d_ary_heap_indirect used by the Dijkstra variants. Keys are read from the
+         * distance map when a value is pushed or updated and must never be smaller than the key of
+         * the last value popped, which holds for Dijkstra with non-negative weights.
+         *
+         * An entry is kept in the bucket given by the highest bit in which its key differs from the
+         * last popped key. Decrease key inserts a new entry and leaves the old one behind, entries
+         * whose key no longer matches the distance map are discarded when they are met.
+         */
+        template<class Value, class DistanceMap>
+        class RadixHeap {
+        public:
+            typedef typename boost::property_traits<DistanceMap>::value_type DistanceType;
+            typedef typename std::make_unsigned<DistanceType>::type Key;
+
+            static constexpr std::size_t num_buckets = std::numeric_limits<Key>::digits + 1;
+
+            template<class IndexInHeapMap, class Compare>
+            RadixHeap(DistanceMap distance, IndexInHeapMap, Compare) :
+                    distance(distance), buckets(num_buckets), last(0), live(0) {
+            }
+
+            bool empty() const {
+                return live == 0;
+            }
+
+            std::size_t size() const {
+                return live;
+            }
+
+            void push(const Value &v) {
+                insert(v);
+                ++live;
+            }
+
+            /*
+             * Called after the key of a value already in the heap was decreased.
+             */
+            void update(const Value &v) {
+                insert(v);
+            }
+
+            Value& top() {
+                normalize();
+                return buckets[0].back().second;
+            }
+
+            void pop() {
+                normalize();
+                buckets[0].pop_back();
+                --live;
+            }
+
+        private:
+            typedef std::pair<Key, Value> Entry;
+
+            Key key(const Value &v) const {
+                return static_cast<Key>(boost::get(distance, v));
+            }
+
+            static std::size_t bit_width(Key x) {
+#if defined(__GNUC__)
+                return std::numeric_limits<unsigned long long>::digits
+                        - __builtin_clzll(static_cast<unsigned long long>(x));
+#else
+                std::size_t width = 0;
+                while (x != 0) {
+                    x >>= 1;
+                    ++width;
+                }
+                return width;
+#endif
+            }
+
+            std::size_t bucket(Key k) const {
+                return k == last ? 0 : bit_width(k ^ last);
+            }
+
+            void insert(const Value &v) {
+                Key k = key(v);
+                assert(!(k < last));
+                buckets[bucket(k)].emplace_back(k, v);
+            }
+
+            bool is_stale(const Entry &entry) const {
+                return entry.first != key(entry.second);
+            }
+
+            /*
+             * Move the entries with the minimum key into the first bucket.
+             */
+            void normalize() {
+                assert(live > 0);
+                std::vector<Entry> &first = buckets[0];
+                while (true) {
+                    while (!first.empty() && is_stale(first.back())) {
+                        first.pop_back();
+                    }
+                    if (!first.empty()) {
+                        return;
+                    }
+
+                    std::size_t i = 1;
+                    while (buckets[i].empty()) {
+                        ++i;
+                    }
+                    std::vector<Entry> &b = buckets[i];
+                    Key min = (std::numeric_limits<Key>::max)();
+                    bool found = false;
+                    for (const Entry &entry : b) {
+                        if (!is_stale(entry) && (!found || entry.first < min)) {
+                            min = entry.first;
+                            found = true;
+                        }
+                    }
+                    if (found) {
+                        // all entries of bucket i land in lower buckets
+                        last = min;
+                        for (const Entry &entry : b) {
+                            if (!is_stale(entry)) {
+                                buckets[bucket(entry.first)].push_back(entry);
+                            }
+                        }
+                    }
+                    b.clear();
+                }
+            }
+
+            DistanceMap distance;
+            std::vector<std::vector<Entry>> buckets;
+            Key last;
+            // number of values with an entry which is not stale
+            std::size_t live;
+        };
+
+        template<class Value, class DistanceMap>
+        constexpr std::size_t RadixHeap<Value, DistanceMap>::num_buckets;
+
+        /*
+         * Priority queue of the Dijkstra variants, a radix heap for integral distances and a
+         * 4-ary heap otherwise.
+         */
+        template<class Value, class IndexInHeapMap, class DistanceMap, class Compare,
+                bool Integral = std::is_integral<typename boost::property_traits<DistanceMap>::value_type>::value>
+        struct dijkstra_queue {
+            typedef boost::d_ary_heap_indirect<Value, 4, IndexInHeapMap, DistanceMap, Compare> type;
+        };
+
+        template<class Value, class IndexInHeapMap, class DistanceMap, class Compare>
+        struct dijkstra_queue<Value, IndexInHeapMap, DistanceMap, Compare, true> {
+            typedef RadixHeap<Value, DistanceMap> type;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -0,0 +1,349 @@
+#ifndef PARMCB_DETAIL_REDUCTION_HPP_
+#define PARMCB_DETAIL_REDUCTION_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Output iterator functor which expands cycles of a reduced graph into lists of
+         * original edges.
+         */
+        template<class Cycle, class Reduction, class CycleOutputIterator>
+        struct ReducedCycleOutput {
+            const Reduction *reduction;
+            CycleOutputIterator *out;
+
+            template<class ReducedCycle>
+            void operator()(const ReducedCycle &reduced_cycle) const {
+                Cycle cycle;
+                for (const auto &e : reduced_cycle) {
+                    reduction->expand(e, std::back_inserter(cycle));
+                }
+                *(*out)++ = cycle;
+            }
+        };
+
+        /*
+         * Reversible reduction which does not change the cycle space. Vertices of degree at most
+         * one are removed iteratively, since their edges belong to no cycle. Maximal paths whose
+         * inner vertices have degree two are contracted into a single edge with the total weight
+         * of the path. When the contracted edge would be parallel to an existing one, or a loop,
+         * one or two inner vertices are kept so that the reduced graph stays simple. Each edge of
+         * the reduced graph remembers the original edges it replaces.
+         */
+        template<class Graph, class WeightMap>
+        class ChainReduction {
+        public:
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef typename CSRSnapshot<Graph, WeightMap>::CSRWeightMap ReducedWeightMap;
+
+            ChainReduction(const Graph &g, const WeightMap &weight_map) {
+                CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+                const CSRGraph &csr = snapshot.graph();
+                _original_vertices = boost::num_vertices(csr);
+                _original_edges = boost::num_edges(csr);
+
+                prune(csr);
+                contract(csr, snapshot);
+            }
+
+            ChainReduction(const ChainReduction &other) = delete;
+            ChainReduction& operator=(const ChainReduction &other) = delete;
+
+            const CSRGraph& graph() const {
+                return _graph;
+            }
+
+            ReducedWeightMap weight_map() const {
+                return ReducedWeightMap(_weights.begin(), CSREdgeIndexMap());
+            }
+
+            /*
+             * Write the original edges replaced by edge e of the reduced graph.
+             */
+            template<class EdgeOutputIterator>
+            void expand(const CSREdge &e, EdgeOutputIterator out) const {
+                for (std::size_t i = _expansion_offsets[e.id]; i < _expansion_offsets[e.id + 1]; i++) {
+                    *out++ = _expansion[i];
+                }
+            }
+
+            /*
+             * Output iterator accepting cycles of the reduced graph, which writes them as lists
+             * of original edges to out. The iterator refers to out, which must outlive it.
+             */
+            template<class CycleOutputIterator>
+            boost::iterators::function_output_iterator<
+                    ReducedCycleOutput<std::list<Edge>, ChainReduction, CycleOutputIterator>> cycle_output(
+                    CycleOutputIterator &out) const {
+                return boost::iterators::make_function_output_iterator(
+                        ReducedCycleOutput<std::list<Edge>, ChainReduction, CycleOutputIterator> { this, &out });
+            }
+
+            std::size_t original_vertices() const {
+                return _original_vertices;
+            }
+
+            std::size_t original_edges() const {
+                return _original_edges;
+            }
+
+            /*
+             * Fraction of the vertices removed by the reduction.
+             */
+            double reduction_ratio() const {
+                if (_original_vertices == 0) {
+                    return 0.0;
+                }
+                return 1.0 - static_cast<double>(boost::num_vertices(_graph)) / _original_vertices;
+            }
+
+        private:
+            static constexpr std::size_t npos = (std::numeric_limits<std::size_t>::max)();
+
+            /*
+             * A maximal path, inner vertices have degree two.
+             */
+            struct Chain {
+                std::size_t first;
+                std::size_t last;
+                std::vector<std::size_t> inner;
+                std::vector<std::size_t> edges;
+            };
+
+            void prune(const CSRGraph &csr) {
+                std::size_t n = boost::num_vertices(csr);
+                _degree.resize(n);
+                _removed.assign(boost::num_edges(csr), false);
+
+                std::vector<std::size_t> stack;
+                for (std::size_t v = 0; v < n; v++) {
+                    _degree[v] = csr.degree(v);
+                    if (_degree[v] == 1) {
+                        stack.push_back(v);
+                    }
+                }
+                while (!stack.empty()) {
+                    std::size_t v = stack.back();
+                    stack.pop_back();
+                    if (_degree[v] != 1) {
+                        continue;
+                    }
+                    for (const auto &e : boost::make_iterator_range(boost::out_edges(v, csr))) {
+                        if (!_removed[e.id]) {
+                            _removed[e.id] = true;
+                            _degree[v]--;
+                            if (--_degree[e.target] == 1) {
+                                stack.push_back(e.target);
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+
+            /*
+             * Follow the path starting with edge e from vertex u until a vertex which is not an
+             * inner vertex.
+             */
+            Chain walk(const CSRGraph &csr, std::size_t u, CSREdge e, std::vector<bool> &visited) const {
+                Chain chain;
+                chain.first = u;
+                chain.edges.push_back(e.id);
+                visited[e.id] = true;
+                std::size_t x = e.target;
+                while (x != u && _reduced[x] == npos && _degree[x] == 2) {
+                    chain.inner.push_back(x);
+                    for (const auto &f : boost::make_iterator_range(boost::out_edges(x, csr))) {
+                        if (!_removed[f.id] && !visited[f.id]) {
+                            e = f;
+                            break;
+                        }
+                    }
+                    chain.edges.push_back(e.id);
+                    visited[e.id] = true;
+                    x = e.target;
+                }
+                chain.last = x;
+                return chain;
+            }
+
+            void contract(const CSRGraph &csr, const CSRSnapshot<Graph, WeightMap> &snapshot) {
+                std::size_t n = boost::num_vertices(csr);
+                _reduced.assign(n, npos);
+                std::size_t reduced_n = 0;
+                for (std::size_t v = 0; v < n; v++) {
+                    if (_degree[v] >= 3) {
+                        _reduced[v] = reduced_n++;
+                    }
+                }
+
+                std::vector<bool> visited(boost::num_edges(csr), false);
+                std::vector<Chain> chains;
+                for (std::size_t u = 0; u < n; u++) {
+                    if (_reduced[u] == npos) {
+                        continue;
+                    }
+                    for (const auto &e : boost::make_iterator_range(boost::out_edges(u, csr))) {
+                        if (!_removed[e.id] && !visited[e.id]) {
+                            chains.push_back(walk(csr, u, e, visited));
+                        }
+                    }
+                }
+
+                // cycles without any vertex of degree three or more
+                for (std::size_t u = 0; u < n; u++) {
+                    if (_degree[u] != 2 || _reduced[u] != npos) {
+                        continue;
+                    }
+                    for (const auto &e : boost::make_iterator_range(boost::out_edges(u, csr))) {
+                        if (!_removed[e.id] && !visited[e.id]) {
+                            _reduced[u] = reduced_n++;
+                            chains.push_back(walk(csr, u, e, visited));
+                            break;
+                        }
+                    }
+                }
+
+                // single edges first, so that contracted edges never become parallel to them
+                std::vector<std::pair<std::size_t, std::size_t>> endpoints;
+                std::set<std::pair<std::size_t, std::size_t>> pairs;
+                _expansion_offsets.push_back(0);
+                auto snapshot_weights = snapshot.weight_map();
+                auto add_edge = [&](std::size_t u, std::size_t v, const Chain &chain, std::size_t from,
+                        std::size_t to) {
+                    endpoints.emplace_back(_reduced[u], _reduced[v]);
+                    pairs.emplace((std::min)(u, v), (std::max)(u, v));
+                    WeightType w = WeightType();
+                    for (std::size_t i = from; i < to; i++) {
+                        std::size_t id = chain.edges[i];
+                        w += snapshot_weights[csr.edge(id)];
+                        _expansion.push_back(snapshot.edge(id));
+                    }
+                    _weights.push_back(w);
+                    _expansion_offsets.push_back(_expansion.size());
+                };
+                for (const auto &chain : chains) {
+                    if (chain.inner.empty()) {
+                        add_edge(chain.first, chain.last, chain, 0, 1);
+                    }
+                }
+                for (const auto &chain : chains) {
+                    std::size_t u = chain.first;
+                    std::size_t v = chain.last;
+                    std::size_t s = chain.inner.size();
+                    if (s == 0) {
+                        continue;
+                    }
+                    if (u != v && pairs.count(std::make_pair((std::min)(u, v), (std::max)(u, v))) == 0) {
+                        add_edge(u, v, chain, 0, s + 1);
+                    } else if (u != v) {
+                        // inner vertex i lies between edges i and i + 1
+                        std::size_t x = chain.inner[s / 2];
+                        _reduced[x] = reduced_n++;
+                        add_edge(u, x, chain, 0, s / 2 + 1);
+                        add_edge(x, v, chain, s / 2 + 1, s + 1);
+                    } else if (s == 1) {
+                        // a digon, keep its only inner vertex
+                        std::size_t x = chain.inner[0];
+                        _reduced[x] = reduced_n++;
+                        add_edge(u, x, chain, 0, 1);
+                        add_edge(x, v, chain, 1, 2);
+                    } else {
+                        std::size_t i1 = s / 3;
+                        std::size_t i2 = (2 * s) / 3;
+                        std::size_t x1 = chain.inner[i1];
+                        std::size_t x2 = chain.inner[i2];
+                        _reduced[x1] = reduced_n++;
+                        _reduced[x2] = reduced_n++;
+                        add_edge(u, x1, chain, 0, i1 + 1);
+                        add_edge(x1, x2, chain, i1 + 1, i2 + 1);
+                        add_edge(x2, v, chain, i2 + 1, s + 1);
+                    }
+                }
+
+                _graph = CSRGraph(reduced_n, endpoints);
+                _degree.clear();
+                _degree.shrink_to_fit();
+                _removed.clear();
+                _removed.shrink_to_fit();
+                _reduced.clear();
+                _reduced.shrink_to_fit();
+            }
+
+            CSRGraph _graph;
+            std::vector<WeightType> _weights;
+            std::vector<std::size_t> _expansion_offsets;
+            std::vector<Edge> _expansion;
+            std::size_t _original_vertices;
+            std::size_t _original_edges;
+
+            // working state of the construction
+            std::vector<std::size_t> _degree;
+            std::vector<bool> _removed;
+            std::vector<std::size_t> _reduced;
+        };
+
+        template<class Graph, class WeightMap>
+        constexpr std::size_t ChainReduction<Graph, WeightMap>::npos;
+
+        /*
+         * Runs the exact algorithm on the reduced graph and expands the cycles back to the
+         * original edges.
+         */
+        template<class Graph, class WeightMap, template<class, class, class > class ExactAlgorithm>
+        class BaseReducedAlgorithm {
+        public:
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef ChainReduction<Graph, WeightMap> Reduction;
+
+            BaseReducedAlgorithm(const Graph &g, const WeightMap &weight_map) :
+                    _reduction(g, weight_map) {
+#ifdef PARMCB_LOGGING
+                std::cout << "Reduced vertices: " << _reduction.original_vertices() << " -> "
+                        << boost::num_vertices(_reduction.graph()) << std::endl;
+                std::cout << "Reduced edges: " << _reduction.original_edges() << " -> "
+                        << boost::num_edges(_reduction.graph()) << std::endl;
+                std::cout << "Reduction ratio: " << _reduction.reduction_ratio() << std::endl;
+#endif
+            }
+
+            template<class CycleOutputIterator>
+            WeightType run(CycleOutputIterator out) {
+                auto reduced_out = _reduction.cycle_output(out);
+                ExactAlgorithm<CSRGraph, typename Reduction::ReducedWeightMap, decltype(reduced_out)> exact_mcb_algo;
+                return exact_mcb_algo(_reduction.graph(), _reduction.weight_map(), reduced_out);
+            }
+
+        private:
+            Reduction _reduction;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef PARMCB_DETAIL_SEARCH_STRATEGY_HPP_
+#define PARMCB_DETAIL_SEARCH_STRATEGY_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <parmcb/forestindex.hpp>
+#include <parmcb/spvecgf2.hpp>
+
+namespace parmcb {
+
+    /*
+     * How the shortest odd cycle of a support vector is searched in the signed graph.
+     */
+    enum class signed_search_mode {
+        // one search from (v,+) to (v,-) for each vertex v
+        all_vertices,
+        // one search between the endpoints of each signed edge, the signed edges not yet
+        // considered are hidden
+        signed_edges
+    };
+
+    /*
+     * Search mode chosen in each iteration.
+     */
+    struct search_strategy_statistics {
+        std::vector<signed_search_mode> modes;
+
+        std::size_t count(signed_search_mode mode) const {
+            return std::count(modes.begin(), modes.end(), mode);
+        }
+    };
+
+    namespace detail {
+
+        /*
+         * Chooses the search mode of each support vector by comparing the expected number of
+         * scanned edges. Each search is weighted by the degrees of the vertices where its two
+         * directions start, relative to the average degree, so that all vertices sum to n. The
+         * weight of a mode is converted to scanned edges by the ratio of the edges scanned to the
+         * weight searched in the previous iterations of the same mode. A mode which has not run
+         * yet borrows the ratio of the other one, thus on regular graphs the first choice compares
+         * the number of signed edges with the number of vertices.
+         */
+        template<class Graph>
+        class SearchStrategySelector {
+        public:
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+
+            SearchStrategySelector(const Graph &g, const ForestIndex<Graph> &forest_index) :
+                    g(g), forest_index(forest_index), index_map(boost::get(boost::vertex_index, g)), last_mode(
+                            signed_search_mode::all_vertices), last_weight(0.0) {
+                std::size_t n = boost::num_vertices(g);
+                average_degree = n == 0 ? 1.0 : 2.0 * boost::num_edges(g) / n;
+                if (average_degree == 0.0) {
+                    average_degree = 1.0;
+                }
+                degree.resize(n);
+                for (const auto &v : boost::make_iterator_range(boost::vertices(g))) {
+                    degree[index_map[v]] = boost::out_degree(v, g);
+                }
+                total_scanned[0] = total_scanned[1] = 0.0;
+                total_weight[0] = total_weight[1] = 0.0;
+            }
+
+            signed_search_mode choose(const SpVecGF2<std::size_t> &support) {
+                last_mode = predict(support, last_weight);
+                stats.modes.push_back(last_mode);
+                return last_mode;
+            }
+
+            /*
+             * Number of searches of the mode which choose() would return for a support vector.
+             */
+            std::size_t searches(const SpVecGF2<std::size_t> &support) const {
+                double weight;
+                if (predict(support, weight) == signed_search_mode::all_vertices) {
+                    return boost::num_vertices(g);
+                }
+                return support.size();
+            }
+
+            /*
+             * Record the edges scanned by the searches of the last choice. When the searches are
+             * split among processes, share is the fraction of the weight which ran locally.
+             */
+            void record(std::size_t scanned_edges, double share = 1.0) {
+                double weight = last_weight * share;
+                if (weight <= 0.0) {
+                    return;
+                }
+                std::size_t m = static_cast<std::size_t>(last_mode);
+                total_scanned[m] += scanned_edges;
+                total_weight[m] += weight;
+            }
+
+            const search_strategy_statistics& statistics() const {
+                return stats;
+            }
+
+        private:
+            /*
+             * The cheaper mode for a support vector and its weight.
+             */
+            signed_search_mode predict(const SpVecGF2<std::size_t> &support, double &weight) const {
+                double all_vertices_weight = boost::num_vertices(g);
+                double signed_edges_weight = 0.0;
+                for (auto id : support) {
+                    auto e = forest_index(id);
+                    signed_edges_weight += degree[index_map[boost::source(e, g)]]
+                            + degree[index_map[boost::target(e, g)]];
+                }
+                signed_edges_weight /= 2.0 * average_degree;
+
+                double all_vertices_cost = all_vertices_weight * scale(signed_search_mode::all_vertices);
+                double signed_edges_cost = signed_edges_weight * scale(signed_search_mode::signed_edges);
+                if (signed_edges_cost < all_vertices_cost) {
+                    weight = signed_edges_weight;
+                    return signed_search_mode::signed_edges;
+                }
+                weight = all_vertices_weight;
+                return signed_search_mode::all_vertices;
+            }
+
+            /*
+             * Scanned edges per unit of weight.
+             */
+            double scale(signed_search_mode mode) const {
+                std::size_t m = static_cast<std::size_t>(mode);
+                if (total_weight[m] > 0.0) {
+                    return total_scanned[m] / total_weight[m];
+                }
+                if (total_weight[1 - m] > 0.0) {
+                    return total_scanned[1 - m] / total_weight[1 - m];
+                }
+                return 1.0;
+            }
+
+            const Graph &g;
+            const ForestIndex<Graph> &forest_index;
+            typename boost::property_map<Graph, boost::vertex_index_t>::const_type index_map;
+            std::vector<std::size_t> degree;
+            double average_degree;
+            signed_search_mode last_mode;
+            double last_weight;
+            double total_scanned[2];
+            double total_weight[2];
+            search_strategy_statistics stats;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
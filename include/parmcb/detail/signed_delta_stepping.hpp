@@ -0,0 +1,317 @@
+#ifndef PARMCB_DETAIL_SIGNED_DELTA_STEPPING_HPP_
+#define PARMCB_DETAIL_SIGNED_DELTA_STEPPING_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <parmcb/config.hpp>
+#include <parmcb/detail/edge_bitmap.hpp>
+#include <parmcb/detail/signed_dijkstra.hpp>
+#include <parmcb/detail/util.hpp>
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/spin_mutex.h>
+
+namespace parmcb {
+
+    namespace detail {
+
+        /*
+         * Storage of the parallel delta-stepping search on the signed graph, with arrays of size 2n
+         * reused across searches. Signed vertices are kept in buckets of width delta, the mean edge
+         * weight. The vertices of the lowest bucket are expanded in parallel until the bucket stays
+         * empty, which settles all signed vertices with a distance in its range.
+         *
+         * A workspace must not be used by two searches concurrently, each search uses all threads.
+         */
+        template<class Graph, class WeightMap>
+        struct SignedDeltaSteppingWorkspace {
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type DistanceType;
+            typedef std::pair<Vertex, bool> SignedVertex;
+            typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
+
+            SignedDeltaSteppingWorkspace(const Graph &g, const WeightMap &weight_map) :
+                    n(boost::num_vertices(g)), dist(new std::atomic<DistanceType>[2 * n]), pred(2 * n), reached(
+                            new std::atomic<std::size_t>[2 * n]), locks(new tbb::spin_mutex[2 * n]), expanded(2 * n, 0), scanned(
+                            2 * n, 0), epoch(0), round(0), scanned_edges(0) {
+                auto index_map = boost::get(boost::vertex_index, g);
+                vertices.resize(n);
+                for (const auto &v : boost::make_iterator_range(boost::vertices(g))) {
+                    vertices[index_map[v]] = v;
+                }
+                for (std::size_t i = 0; i < 2 * n; i++) {
+                    reached[i].store(0, std::memory_order_relaxed);
+                }
+
+                DistanceType total = DistanceType();
+                std::size_t m = 0;
+                for (const auto &e : boost::make_iterator_range(boost::edges(g))) {
+                    total += boost::get(weight_map, e);
+                    m++;
+                }
+                delta = m == 0 ? DistanceType() : static_cast<DistanceType>(total / m);
+                if (!(DistanceType() < delta)) {
+                    delta = DistanceType(1);
+                }
+            }
+
+            SignedDeltaSteppingWorkspace(const SignedDeltaSteppingWorkspace &other) = delete;
+            SignedDeltaSteppingWorkspace& operator=(const SignedDeltaSteppingWorkspace &other) = delete;
+
+            void reset_statistics() {
+                scanned_edges.store(0, std::memory_order_relaxed);
+            }
+
+            const std::size_t n;
+            std::vector<Vertex> vertices;
+            std::unique_ptr<std::atomic<DistanceType>[]> dist;
+            std::vector<Predecessor> pred;
+            // epoch in which each signed vertex was last reached
+            std::unique_ptr<std::atomic<std::size_t>[]> reached;
+            std::unique_ptr<tbb::spin_mutex[]> locks;
+            // round in which each signed vertex was last expanded
+            std::vector<std::size_t> expanded;
+            // epoch in which the edges of each signed vertex were first counted
+            std::vector<std::size_t> scanned;
+            std::size_t epoch;
+            std::size_t round;
+            DistanceType delta;
+            std::map<std::size_t, std::vector<std::size_t>> buckets;
+            std::vector<std::size_t> frontier;
+            tbb::enumerable_thread_specific<std::vector<std::size_t>> improved;
+            std::atomic<std::size_t> scanned_edges;
+        };
+
+        /*
+         * Single source signed graph search from (s,s_pos) to (t,t_pos) by parallel delta-stepping,
+         * with the same results as signed_dijkstra_impl(). Labels are lowered under a lock of the
+         * signed vertex and ties between labels of equal distance go to the predecessor edge with
+         * the smaller index. Every signed vertex on the path is expanded with its final distance
+         * by all its predecessors on shortest paths, thus the path returned does not depend on the
+         * scheduling. For the same reason the scanned edges count the edges of each signed vertex
+         * once, however often it is expanded.
+         */
+        template<class Graph, class WeightMap, class EdgeIndexMap, class EdgeClassifier, class CycleWeightLimit>
+        std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+                typename boost::property_traits<WeightMap>::value_type, bool> signed_delta_stepping_impl(
+                const Graph &g, const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+                const EdgeClassifier &classify, const typename boost::graph_traits<Graph>::vertex_descriptor &s,
+                bool s_pos, const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos,
+                const CycleWeightLimit &cycle_weight_limit, SignedDeltaSteppingWorkspace<Graph, WeightMap> &workspace) {
+
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef typename boost::property_traits<WeightMap>::value_type DistanceType;
+            typedef std::pair<Vertex, bool> SignedVertex;
+            typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
+
+            DistanceType distance_inf = (std::numeric_limits<DistanceType>::max)();
+            closed_plus<DistanceType> combine = closed_plus<DistanceType>();
+            auto index_map = boost::get(boost::vertex_index, g);
+            const std::size_t n = workspace.n;
+            auto signed_index = [&](const Vertex &v, bool pos) {
+                return index_map[v] + (pos ? 0 : n);
+            };
+            auto signed_vertex = [&](std::size_t i) {
+                return i < n ? std::make_pair(workspace.vertices[i], true) : std::make_pair(workspace.vertices[i - n],
+                                       false);
+            };
+            auto bucket = [&](const DistanceType &d) {
+                return static_cast<std::size_t>(d / workspace.delta);
+            };
+
+            if (++workspace.epoch == 0) {
+                // wrap around, now we need to clear
+                for (std::size_t i = 0; i < 2 * n; i++) {
+                    workspace.reached[i].store(0, std::memory_order_relaxed);
+                    workspace.scanned[i] = 0;
+                }
+                workspace.epoch = 1;
+            }
+            const std::size_t epoch = workspace.epoch;
+            workspace.buckets.clear();
+
+            const std::size_t source = signed_index(s, s_pos);
+            const std::size_t target = signed_index(t, t_pos);
+            assert(source != target);
+            workspace.dist[source].store(DistanceType(), std::memory_order_relaxed);
+            workspace.reached[source].store(epoch, std::memory_order_relaxed);
+            workspace.buckets[0].push_back(source);
+
+            auto is_reached = [&](std::size_t i) {
+                return workspace.reached[i].load(std::memory_order_acquire) == epoch;
+            };
+
+            while (!workspace.buckets.empty()) {
+                auto first = workspace.buckets.begin();
+                const std::size_t current = first->first;
+                if (is_reached(target) && bucket(workspace.dist[target].load(std::memory_order_relaxed)) < current) {
+                    // all labels lighter than the target are final
+                    break;
+                }
+
+                // collect each signed vertex of the bucket once
+                workspace.frontier.clear();
+                ++workspace.round;
+                for (std::size_t i : first->second) {
+                    if (workspace.expanded[i] == workspace.round
+                            || bucket(workspace.dist[i].load(std::memory_order_relaxed)) != current) {
+                        continue;
+                    }
+                    workspace.expanded[i] = workspace.round;
+                    if (i != target) {
+                        workspace.frontier.push_back(i);
+                    }
+                }
+                workspace.buckets.erase(first);
+
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, workspace.frontier.size()),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            auto &improved = workspace.improved.local();
+                            std::size_t scanned = 0;
+                            for (std::size_t k = r.begin(); k != r.end(); ++k) {
+                                const std::size_t iu = workspace.frontier[k];
+                                const DistanceType d_u = workspace.dist[iu].load(std::memory_order_relaxed);
+                                if (cycle_weight_limit.exceeded(d_u)) {
+                                    continue;
+                                }
+                                const SignedVertex signed_u = signed_vertex(iu);
+                                const Vertex u = signed_u.first;
+                                if (workspace.scanned[iu] != epoch) {
+                                    workspace.scanned[iu] = epoch;
+                                    scanned += boost::out_degree(u, g);
+                                }
+
+                                auto eiRange = boost::out_edges(u, g);
+                                for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
+                                    auto e = *ei;
+                                    const signed_edge_kind kind = classify(e);
+                                    if (kind == signed_edge_kind::hidden) {
+                                        continue;
+                                    }
+                                    auto w = boost::target(e, g);
+                                    if (w == u) {
+                                        w = boost::source(e, g);
+                                    }
+                                    if (w == u) {
+                                        // self-loop
+                                        continue;
+                                    }
+                                    const WeightType c = combine(d_u, boost::get(weight_map, e));
+                                    if (cycle_weight_limit.prunes(c)) {
+                                        continue;
+                                    }
+
+                                    const bool w_pos = (kind == signed_edge_kind::odd) ? !signed_u.second : signed_u.second;
+                                    const std::size_t iw = signed_index(w, w_pos);
+                                    if (iw == source) {
+                                        continue;
+                                    }
+                                    if (is_reached(iw) && workspace.dist[iw].load(std::memory_order_relaxed) < c) {
+                                        continue;
+                                    }
+
+                                    bool lowered = false;
+                                    {
+                                        tbb::spin_mutex::scoped_lock lock(workspace.locks[iw]);
+                                        const DistanceType d_w = workspace.dist[iw].load(std::memory_order_relaxed);
+                                        if (!is_reached(iw) || c < d_w) {
+                                            workspace.dist[iw].store(c, std::memory_order_relaxed);
+                                            workspace.pred[iw] = std::make_tuple(signed_u, true, e);
+                                            workspace.reached[iw].store(epoch, std::memory_order_release);
+                                            lowered = true;
+                                        } else if (!(d_w < c)
+                                                && edge_index_map[e] < edge_index_map[std::get<2>(workspace.pred[iw])]) {
+                                            // same label, only the predecessor changes
+                                            workspace.pred[iw] = std::make_tuple(signed_u, true, e);
+                                        }
+                                    }
+                                    if (lowered) {
+                                        improved.push_back(iw);
+                                    }
+                                }
+                            }
+                            workspace.scanned_edges.fetch_add(scanned, std::memory_order_relaxed);
+                        });
+
+                for (auto &improved : workspace.improved) {
+                    for (std::size_t i : improved) {
+                        workspace.buckets[bucket(workspace.dist[i].load(std::memory_order_relaxed))].push_back(i);
+                    }
+                    improved.clear();
+                }
+            }
+
+            if (!is_reached(target) || cycle_weight_limit.exceeded(workspace.dist[target].load())) {
+                return std::make_tuple(std::set<Edge> { }, distance_inf, false);
+            }
+
+            std::set<Edge> cycle;
+            WeightType cycle_weight = WeightType();
+            std::size_t cur = target;
+            while (cur != source) {
+                const Predecessor &p = workspace.pred[cur];
+                Edge e = std::get<2>(p);
+                if (!cycle.insert(e).second) {
+                    // duplicate edge, discard cycle
+                    return std::make_tuple(std::set<Edge> { }, distance_inf, false);
+                }
+                cycle_weight += boost::get(weight_map, e);
+                cur = signed_index(std::get<0>(p).first, std::get<0>(p).second);
+            }
+            return std::make_tuple(cycle, cycle_weight, true);
+        }
+
+    } // detail
+
+    /*
+     * Parallel search between two signed vertices where the signed edges are given by their ranks
+     * and the signed edges at position first_hidden or later are hidden. Labels are pruned by the
+     * fixed limit and signed vertices beyond the shared bound are not expanded, as in
+     * bidirectional_signed_dijkstra().
+     */
+    template<class Graph, class WeightMap, class EdgeIndexMap>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> parallel_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+            const parmcb::detail::EdgeRanks &signed_edges, std::size_t first_hidden,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            const SharedCycleWeightBound<typename boost::property_traits<WeightMap>::value_type> &bound,
+            const typename boost::property_traits<WeightMap>::value_type &bound_offset,
+            parmcb::detail::SignedDeltaSteppingWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::rank_edge_classifier<Graph, EdgeIndexMap> classify(edge_index_map, signed_edges,
+                first_hidden);
+        parmcb::detail::shared_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit, bound, bound_offset);
+        return parmcb::detail::signed_delta_stepping_impl(g, weight_map, edge_index_map, classify, s, s_pos, t,
+                t_pos, limit, workspace);
+    }
+
+} // parmcb
+
+#endif
+
+#endif
@@ -6,7 +6,9 @@
 //    (See accompanying file LICENSE_1_0.txt or copy at
 //          https://www.boost.org/LICENSE_1_0.txt)
 
+#include <atomic>
 #include <iostream>
+#include <limits>
 
 #include <boost/scoped_array.hpp>
 #include <boost/throw_exception.hpp>
@@ -18,6 +20,10 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/detail/d_ary_heap.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/detail/edge_bitmap.hpp>
+#include <parmcb/detail/landmarks.hpp>
+#include <parmcb/detail/radix_heap.hpp>
 #include <parmcb/detail/util.hpp>
 
 namespace std {
@@ -31,6 +37,8 @@ namespace std {
 
 namespace parmcb {
 
+    template<class WeightType> class SharedCycleWeightBound;
+
     namespace detail {
 
         template<class Graph, class WeightMap>
@@ -40,16 +48,17 @@ namespace parmcb {
             typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
             typedef std::pair<Vertex, bool> SignedVertex;
 
+            // pointers instead of references keep the functor assignable
             std::size_t n;
-            std::vector<DistanceType> &dist;
-            const VertexIndexMapType &index_map;
+            std::vector<DistanceType> *dist;
+            const VertexIndexMapType *index_map;
 
             SignedDistanceFunctor(std::size_t n, std::vector<DistanceType> &dist, const VertexIndexMapType &index_map) :
-                    n(n), dist(dist), index_map(index_map) {
+                    n(n), dist(&dist), index_map(&index_map) {
             }
 
             DistanceType& operator()(const SignedVertex &v) const {
-                return dist.at(index_map[v.first] + (v.second ? 0 : n));
+                return dist->at((*index_map)[v.first] + (v.second ? 0 : n));
             }
         };
 
@@ -62,15 +71,15 @@ namespace parmcb {
             typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
 
             std::size_t n;
-            std::vector<Predecessor> &pred;
-            const VertexIndexMapType &index_map;
+            std::vector<Predecessor> *pred;
+            const VertexIndexMapType *index_map;
 
             SignedPredecessorFunctor(std::size_t n, std::vector<Predecessor> &pred, const VertexIndexMapType &index_map) :
-                    n(n), pred(pred), index_map(index_map) {
+                    n(n), pred(&pred), index_map(&index_map) {
             }
 
             Predecessor& operator()(const SignedVertex &v) const {
-                return pred.at(index_map[v.first] + (v.second ? 0 : n));
+                return pred->at((*index_map)[v.first] + (v.second ? 0 : n));
             }
         };
 
@@ -81,19 +90,44 @@ namespace parmcb {
             typedef std::pair<Vertex, bool> SignedVertex;
 
             std::size_t n;
-            std::vector<std::size_t> &index_in_heap;
-            const VertexIndexMapType &index_map;
+            std::vector<std::size_t> *index_in_heap;
+            const VertexIndexMapType *index_map;
 
             SignedIndexInHeapFunctor(std::size_t n, std::vector<std::size_t> &index_in_heap,
                     const VertexIndexMapType &index_map) :
-                    n(n), index_in_heap(index_in_heap), index_map(index_map) {
+                    n(n), index_in_heap(&index_in_heap), index_map(&index_map) {
             }
 
             std::size_t& operator()(const SignedVertex &v) const {
-                return index_in_heap.at(index_map[v.first] + (v.second ? 0 : n));
+                return index_in_heap->at((*index_map)[v.first] + (v.second ? 0 : n));
             }
         };
 
+        /*
+         * Whether all edges have the same weight, in which case the signed graph searches
+         * reduce to breadth first search.
+         */
+        template<class Graph, class WeightMap>
+        bool has_uniform_weights(const Graph &g, const WeightMap &weight_map) {
+            auto eiRange = boost::edges(g);
+            if (eiRange.first == eiRange.second) {
+                return false;
+            }
+            auto weight = boost::get(weight_map, *eiRange.first);
+            for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
+                auto c = boost::get(weight_map, *ei);
+                if (c < weight || weight < c) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+         * One direction of a signed graph search. The queue is a radix heap for integral
+         * weights and a 4-ary heap otherwise. When all edges have the same weight a signed
+         * vertex is final the first time it is reached, and a FIFO queue replaces the heap.
+         */
         template<class Graph, class WeightMap>
         struct search_frontier {
             typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
@@ -103,50 +137,104 @@ namespace parmcb {
             typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
             typedef std::pair<Vertex, bool> SignedVertex;
             typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
-            typedef boost::d_ary_heap_indirect<SignedVertex, 4,
+            typedef typename dijkstra_queue<SignedVertex,
                     boost::function_property_map<parmcb::detail::SignedIndexInHeapFunctor<Graph>, SignedVertex,
                             std::size_t&>,
                     boost::function_property_map<parmcb::detail::SignedDistanceFunctor<Graph, WeightMap>, SignedVertex,
-                            DistanceType&>, std::less<DistanceType>> VertexQueue;
+                            DistanceType&>, std::less<DistanceType>>::type VertexQueue;
 
             const Graph &g;
             const VertexIndexMapType index_map;
+            const std::size_t n;
             std::vector<std::size_t> index_in_heap;
             std::vector<DistanceType> dist;
             std::vector<Predecessor> pred;
+            /*
+             * Epoch in which each signed vertex was last reached. Entries whose stamp differs
+             * from the current epoch are treated as unreached, thus a reset never touches the arrays.
+             */
+            std::vector<std::size_t> reached;
+            std::size_t epoch;
             boost::function_property_map<parmcb::detail::SignedIndexInHeapFunctor<Graph>, SignedVertex, std::size_t&> index_in_heap_map;
             boost::function_property_map<parmcb::detail::SignedDistanceFunctor<Graph, WeightMap>, SignedVertex,
                     DistanceType&> dist_map;
             boost::function_property_map<parmcb::detail::SignedPredecessorFunctor<Graph>, SignedVertex, Predecessor&> pred_map;
             std::less<DistanceType> compare;
+            const VertexQueue empty_queue;
             VertexQueue queue;
+            // breadth first search with a FIFO queue
+            const bool uniform_weights;
+            std::vector<SignedVertex> fifo;
+            std::size_t fifo_head;
             SignedVertex source;
+            // statistics, accumulated over all searches
+            std::size_t settled_vertices;
+            std::size_t scanned_edges;
+
+            search_frontier(const Graph &g, bool uniform_weights = false) :
+                    g(g), index_map(boost::get(boost::vertex_index, g)), n(boost::num_vertices(g)), index_in_heap(
+                            2 * n), dist(2 * n, (std::numeric_limits<DistanceType>::max)()), pred(2 * n,
+                            std::make_tuple(std::make_pair(Vertex(), true), false, Edge())), reached(2 * n, 0), epoch(
+                            1), index_in_heap_map(
+                            parmcb::detail::SignedIndexInHeapFunctor<Graph>(n, index_in_heap, index_map)), dist_map(
+                            parmcb::detail::SignedDistanceFunctor<Graph, WeightMap>(n, dist, index_map)), pred_map(
+                            parmcb::detail::SignedPredecessorFunctor<Graph>(n, pred, index_map)), compare(), empty_queue(
+                            dist_map, index_in_heap_map, compare), queue(empty_queue), uniform_weights(uniform_weights), fifo_head(
+                            0), settled_vertices(0), scanned_edges(0) {
+            }
+
+            search_frontier(const search_frontier &other) = delete;
+            search_frontier& operator=(const search_frontier &other) = delete;
+
+            /*
+             * Prepare the frontier for a new search in O(1), apart from emptying
+             * whatever was left in the heap by the previous one.
+             */
+            void reset() {
+                // copy assignment keeps the capacity of the heap
+                queue = empty_queue;
+                fifo.clear();
+                fifo_head = 0;
+                if (++epoch == 0) {
+                    // wrap around, now we need to clear
+                    std::fill(reached.begin(), reached.end(), 0);
+                    epoch = 1;
+                }
+            }
+
+            std::size_t signed_index(const SignedVertex &v) const {
+                return index_map[v.first] + (v.second ? 0 : n);
+            }
+
+            bool empty() const {
+                return uniform_weights ? fifo_head == fifo.size() : queue.empty();
+            }
 
-            search_frontier(const Graph &g) :
-                    g(g), index_map(boost::get(boost::vertex_index, g)), index_in_heap(2 * boost::num_vertices(g)), dist(
-                            2 * boost::num_vertices(g), (std::numeric_limits<DistanceType>::max)()), pred(
-                            2 * boost::num_vertices(g), std::make_tuple(std::make_pair(Vertex(), true), false, Edge())), index_in_heap_map(
-                            parmcb::detail::SignedIndexInHeapFunctor<Graph>(boost::num_vertices(g), index_in_heap,
-                                    index_map)), dist_map(
-                            parmcb::detail::SignedDistanceFunctor<Graph, WeightMap>(boost::num_vertices(g), dist,
-                                    index_map)), pred_map(
-                            parmcb::detail::SignedPredecessorFunctor<Graph>(boost::num_vertices(g), pred, index_map)), compare(), queue(
-                            dist_map, index_in_heap_map, compare) {
+            std::size_t size() const {
+                return uniform_weights ? fifo.size() - fifo_head : queue.size();
             }
 
             SignedVertex poll() {
+                ++settled_vertices;
+                if (uniform_weights) {
+                    return fifo[fifo_head++];
+                }
                 SignedVertex u = queue.top();
                 queue.pop();
                 return u;
             }
 
             const DistanceType& find_min() {
-                SignedVertex u = queue.top();
+                SignedVertex u = uniform_weights ? fifo[fifo_head] : queue.top();
                 return boost::get(dist_map, u);
             }
 
+            bool is_reached(const SignedVertex &u) const {
+                return reached[signed_index(u)] == epoch;
+            }
+
             bool has_finite_dist(const SignedVertex &u) {
-                return u == source || std::get<1>(boost::get(pred_map, u));
+                return u == source || is_reached(u);
             }
 
             const DistanceType& get_dist(const SignedVertex &u) {
@@ -159,7 +247,11 @@ namespace parmcb {
 
             void push_source(SignedVertex s) {
                 boost::put(dist_map, s, DistanceType());
-                queue.push(s);
+                if (uniform_weights) {
+                    fifo.push_back(s);
+                } else {
+                    queue.push(s);
+                }
                 source = s;
             }
 
@@ -167,18 +259,32 @@ namespace parmcb {
                 return source;
             }
 
+            /*
+             * Whether update() would change the label of w.
+             */
+            bool improves(const SignedVertex &w, const DistanceType &c) {
+                if (w == source) {
+                    return false;
+                }
+                return !is_reached(w) || (!uniform_weights && compare(c, boost::get(dist_map, w)));
+            }
+
             void update(SignedVertex w, const DistanceType &c, const SignedVertex &pred, const Edge &pred_e) {
                 if (w == source) {
                     return;
                 }
-                bool visited_w = std::get<1>(boost::get(pred_map, w));
 
-                if (!visited_w) {
+                if (!is_reached(w)) {
                     // first time found
+                    reached[signed_index(w)] = epoch;
                     boost::put(dist_map, w, c);
                     boost::put(pred_map, w, std::make_tuple(pred, true, pred_e));
-                    queue.push(w);
-                } else if (compare(c, boost::get(dist_map, w))) {
+                    if (uniform_weights) {
+                        fifo.push_back(w);
+                    } else {
+                        queue.push(w);
+                    }
+                } else if (!uniform_weights && compare(c, boost::get(dist_map, w))) {
                     // already reached
                     boost::put(dist_map, w, c);
                     boost::put(pred_map, w, std::make_tuple(pred, true, pred_e));
@@ -188,226 +294,760 @@ namespace parmcb {
 
         };
 
-    } // detail
+        /*
+         * Cycle weight limit given by a single value, labels not lighter than the limit are
+         * pruned.
+         */
+        template<class WeightType>
+        struct fixed_cycle_weight_limit {
+            const bool use_limit;
+            const WeightType &limit;
+
+            fixed_cycle_weight_limit(bool use_limit, const WeightType &limit) :
+                    use_limit(use_limit), limit(limit) {
+            }
 
-    template<class Graph, class WeightMap, class SignedEdges, class HiddenEdges>
-    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
-            typename boost::property_traits<WeightMap>::value_type, bool> signed_dijkstra(const Graph &g,
-            const WeightMap &weight_map, const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
-            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
-            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
-            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit) {
+            bool exceeded(const WeightType &d) const {
+                return use_limit && !(d < limit);
+            }
 
-        typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
-        typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
-        typedef typename boost::property_traits<WeightMap>::value_type WeightType;
-        typedef typename boost::property_traits<WeightMap>::value_type DistanceType;
-        typedef std::pair<Vertex, bool> SignedVertex;
-        typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
+            /*
+             * Whether a label d is not inserted at all.
+             */
+            bool prunes(const WeightType &d) const {
+                return exceeded(d);
+            }
+        };
 
-        DistanceType distance_inf = (std::numeric_limits<DistanceType>::max)();
-        std::less<DistanceType> compare;
-        parmcb::detail::closed_plus<DistanceType> combine = parmcb::detail::closed_plus<DistanceType>();
+        /*
+         * A fixed limit combined with a bound shared by concurrent searches. The bound is read
+         * on every check so that cycles found by other searches stop this one as soon as they
+         * are published. Labels are compared with the bound after adding an offset, the weight
+         * which closes the path into a cycle.
+         *
+         * Only the fixed limit prunes labels when they are inserted, the bound stops the search
+         * once it settles a label which exceeds it. The labels inserted, and so the order of the
+         * steps and the path found, are then the same whatever the bound, and a search whose
+         * cycle is not heavier than the final bound returns the same cycle as without it.
+         */
+        template<class WeightType>
+        struct shared_cycle_weight_limit {
+            const fixed_cycle_weight_limit<WeightType> fixed;
+            const SharedCycleWeightBound<WeightType> &bound;
+            const WeightType offset;
+
+            shared_cycle_weight_limit(bool use_limit, const WeightType &limit,
+                    const SharedCycleWeightBound<WeightType> &bound, const WeightType &offset) :
+                    fixed(use_limit, limit), bound(bound), offset(offset) {
+            }
 
-        parmcb::detail::search_frontier<Graph, WeightMap> frontier(g);
-        SignedVertex signed_s = std::make_pair(s, s_pos);
-        SignedVertex signed_t = std::make_pair(t, t_pos);
-        frontier.push_source(signed_s);
+            bool exceeded(const WeightType &d) const {
+                return fixed.exceeded(d) || bound.load() < d + offset;
+            }
 
-        assert(signed_s != signed_t);
+            bool prunes(const WeightType &d) const {
+                return fixed.exceeded(d);
+            }
+        };
 
-        while (!frontier.queue.empty()) {
-            SignedVertex signed_u = frontier.poll();
-            DistanceType d_u = frontier.get_dist(signed_u);
-            auto u = signed_u.first;
+        /*
+         * How an edge is traversed by the signed graph searches.
+         */
+        enum class signed_edge_kind {
+            regular, odd, hidden
+        };
 
-            if (use_cycle_weight_limit && !compare(d_u, cycle_weight_limit)) {
-                // reached limit
-                return std::make_tuple(std::set<Edge> { }, distance_inf, false);
-            }
+        /*
+         * Edge classification using associative containers of signed and hidden edges.
+         */
+        template<class Graph, class SignedEdges, class HiddenEdges>
+        struct set_edge_classifier {
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
 
-            if (signed_u == signed_t) { // found target
-                std::set<Edge> cycle;
-                WeightType cycle_weight = WeightType();
-                SignedVertex signed_cur = signed_t;
-                while (signed_cur != signed_s) {
-                    Predecessor p = frontier.get_pred(signed_cur);
-                    Edge e = std::get<2>(p);
-                    if (!cycle.insert(e).second) {
-                        // duplicate edge, discard cycle
-                        return std::make_pair(std::set<Edge> { }, distance_inf);
-                    } else {
-                        cycle_weight += get(weight_map, e);
-                    }
-                    signed_cur = std::get<0>(p);
-                }
-                return std::make_tuple(cycle, cycle_weight, true);
+            const SignedEdges &signed_edges;
+            const HiddenEdges &hidden_edges;
+            const bool use_hidden_edges;
+
+            set_edge_classifier(const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
+                    bool use_hidden_edges) :
+                    signed_edges(signed_edges), hidden_edges(hidden_edges), use_hidden_edges(use_hidden_edges) {
             }
 
-            auto eiRange = boost::out_edges(signed_u.first, g);
-            for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
-                auto e = *ei;
+            signed_edge_kind operator()(const Edge &e) const {
                 if (use_hidden_edges && hidden_edges.find(e) != hidden_edges.end()) {
-                    continue;
+                    return signed_edge_kind::hidden;
                 }
+                return signed_edges.find(e) != signed_edges.end() ? signed_edge_kind::odd : signed_edge_kind::regular;
+            }
+        };
 
-                auto w = boost::target(e, g);
-                if (w == u) {
-                    w = boost::source(e, g);
-                }
-                if (w == u) {
-                    // self-loop
-                    continue;
+        /*
+         * Edge classification using bitmaps indexed by a dense edge id. The id of each scanned
+         * edge is looked up once and then both memberships are single bit tests.
+         */
+        template<class Graph, class EdgeIndexMap>
+        struct bitmap_edge_classifier {
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+
+            const EdgeIndexMap &edge_index_map;
+            const EdgeBitmap &signed_edges;
+            const EdgeBitmap &hidden_edges;
+            const bool use_hidden_edges;
+
+            bitmap_edge_classifier(const EdgeIndexMap &edge_index_map, const EdgeBitmap &signed_edges,
+                    const EdgeBitmap &hidden_edges, bool use_hidden_edges) :
+                    edge_index_map(edge_index_map), signed_edges(signed_edges), hidden_edges(hidden_edges), use_hidden_edges(
+                            use_hidden_edges) {
+            }
+
+            signed_edge_kind operator()(const Edge &e) const {
+                std::size_t id = boost::get(edge_index_map, e);
+                if (use_hidden_edges && hidden_edges.test(id)) {
+                    return signed_edge_kind::hidden;
                 }
-                const WeightType c = combine(d_u, get(weight_map, e));
+                return signed_edges.test(id) ? signed_edge_kind::odd : signed_edge_kind::regular;
+            }
+        };
+
+        /*
+         * Edge classification using the ranks of the signed edges, where the signed edges at
+         * position first_hidden or later are hidden.
+         */
+        template<class Graph, class EdgeIndexMap>
+        struct rank_edge_classifier {
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+
+            const EdgeIndexMap &edge_index_map;
+            const EdgeRanks &signed_edges;
+            const std::size_t first_hidden;
 
-                if (use_cycle_weight_limit && !compare(c, cycle_weight_limit)) {
-                    // never insert if more than current minimum
-                    continue;
+            rank_edge_classifier(const EdgeIndexMap &edge_index_map, const EdgeRanks &signed_edges,
+                    std::size_t first_hidden) :
+                    edge_index_map(edge_index_map), signed_edges(signed_edges), first_hidden(first_hidden) {
+            }
+
+            signed_edge_kind operator()(const Edge &e) const {
+                std::size_t id = boost::get(edge_index_map, e);
+                if (!signed_edges.test(id)) {
+                    return signed_edge_kind::regular;
                 }
+                return signed_edges.hidden(id, first_hidden) ? signed_edge_kind::hidden : signed_edge_kind::odd;
+            }
+        };
 
-                bool is_signed = (signed_edges.find(e) != signed_edges.end());
-                SignedVertex signed_w = std::make_pair(w, is_signed ? (!signed_u.second) : signed_u.second);
+        /*
+         * Lower bound on the remaining distance of a search, none at all.
+         */
+        template<class Graph, class WeightType>
+        struct no_distance_bound {
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+
+            static constexpr bool enabled = false;
 
-                frontier.update(signed_w, c, signed_u, e);
+            WeightType operator()(bool, const Vertex&) const {
+                return WeightType();
             }
+        };
 
-        }
+        /*
+         * Landmark lower bounds on the distance from a vertex to the target of the forward
+         * search or to the source of the backward search.
+         */
+        template<class Graph, class WeightMap>
+        struct landmark_distance_bound {
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
 
-        return std::make_tuple(std::set<Edge> { }, distance_inf, false);
-    }
+            static constexpr bool enabled = true;
 
-    template<class Graph, class WeightMap, class SignedEdges, class HiddenEdges>
-    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
-            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
-            const WeightMap &weight_map, const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
-            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
-            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
-            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit) {
+            const Landmarks<Graph, WeightMap> &landmarks;
+            const WeightType *source_row;
+            const WeightType *target_row;
 
-        typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
-        typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
-        typedef typename boost::property_traits<WeightMap>::value_type WeightType;
-        typedef typename boost::property_traits<WeightMap>::value_type DistanceType;
-        typedef std::pair<Vertex, bool> SignedVertex;
-        typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
+            landmark_distance_bound(const Landmarks<Graph, WeightMap> &landmarks, const Vertex &s, const Vertex &t) :
+                    landmarks(landmarks), source_row(landmarks.row(s)), target_row(landmarks.row(t)) {
+            }
 
-        DistanceType distance_inf = (std::numeric_limits<DistanceType>::max)();
-        std::less<DistanceType> compare;
-        parmcb::detail::closed_plus<DistanceType> combine = parmcb::detail::closed_plus<DistanceType>();
+            WeightType operator()(bool forward, const Vertex &w) const {
+                return landmarks.lower_bound(landmarks.row(w), forward ? target_row : source_row);
+            }
+        };
 
-        SignedVertex signed_s = std::make_pair(s, s_pos);
-        parmcb::detail::search_frontier<Graph, WeightMap> f_frontier(g);
-        f_frontier.push_source(signed_s);
+    } // detail
+
+    /*
+     * Alternation policies of bidirectional_signed_dijkstra(). Before each step the policy is given
+     * the frontier about to be expanded and the other one, and returns true to expand the other
+     * one instead. Both frontiers are non-empty. The stopping condition does not depend on the
+     * order of the steps, thus the policies differ only in which of several shortest paths is
+     * found.
+     */
+
+    /*
+     * Expand the two frontiers in turns, one settled vertex at a time.
+     */
+    struct strict_alternation {
+        template<class Frontier>
+        bool operator()(const Frontier&, const Frontier&) const {
+            return false;
+        }
+    };
+
+    /*
+     * Expand the frontier with fewer queued vertices, ties alternate.
+     */
+    struct smaller_queue_first {
+        template<class Frontier>
+        bool operator()(const Frontier &current, const Frontier &other) const {
+            return other.size() < current.size();
+        }
+    };
+
+    /*
+     * Expand the frontier with the smaller settled radius, ties alternate.
+     */
+    struct smaller_radius_first {
+        template<class Frontier>
+        bool operator()(Frontier &current, Frontier &other) const {
+            return other.find_min() < current.find_min();
+        }
+    };
+
+    /*
+     * Upper bound on the weight of the lightest odd cycle, shared by concurrent searches and
+     * lowered with compare and swap. Searches stop at labels strictly heavier than the bound,
+     * thus cycles of equal weight survive and the caller breaks ties deterministically.
+     */
+    template<class WeightType>
+    class SharedCycleWeightBound {
+    public:
+        SharedCycleWeightBound() :
+                _bound((std::numeric_limits<WeightType>::max)()) {
+        }
 
-        SignedVertex signed_t = std::make_pair(t, t_pos);
-        parmcb::detail::search_frontier<Graph, WeightMap> b_frontier(g);
-        b_frontier.push_source(signed_t);
+        SharedCycleWeightBound(const SharedCycleWeightBound &other) = delete;
+        SharedCycleWeightBound& operator=(const SharedCycleWeightBound &other) = delete;
 
-        assert(signed_s != signed_t);
+        void reset() {
+            _bound.store((std::numeric_limits<WeightType>::max)(), std::memory_order_relaxed);
+        }
 
-        std::reference_wrapper<parmcb::detail::search_frontier<Graph, WeightMap>> frontier = std::ref(f_frontier);
-        std::reference_wrapper<parmcb::detail::search_frontier<Graph, WeightMap>> other_frontier = std::ref(b_frontier);
-        DistanceType best_path = distance_inf;
-        bool best_path_set = false;
-        SignedVertex best_path_common_vertex;
+        WeightType load() const {
+            return _bound.load(std::memory_order_relaxed);
+        }
 
-        while (true) {
-            // stopping condition
-            if (frontier.get().queue.empty() || other_frontier.get().queue.empty()
-                    || (best_path_set
-                            && !compare(combine(frontier.get().find_min(), other_frontier.get().find_min()), best_path))) {
-                break;
+        /*
+         * Lower the bound to weight if smaller, returns true if it changed.
+         */
+        bool improve(const WeightType &weight) {
+            WeightType current = _bound.load(std::memory_order_relaxed);
+            while (weight < current) {
+                if (_bound.compare_exchange_weak(current, weight, std::memory_order_relaxed)) {
+                    return true;
+                }
             }
+            return false;
+        }
 
-            // frontier scan
-            SignedVertex signed_u = frontier.get().poll();
-            DistanceType d_u = frontier.get().get_dist(signed_u);
-            auto u = signed_u.first;
+    private:
+        std::atomic<WeightType> _bound;
+    };
+
+    /*
+     * Reusable storage for the signed graph searches. Passing the same workspace to consecutive calls of
+     * signed_dijkstra() or bidirectional_signed_dijkstra() avoids allocating and initializing arrays of
+     * size 2n per call. A workspace must not be used by two searches concurrently.
+     *
+     * When landmarks are given, bidirectional_signed_dijkstra() prunes the labels whose weight plus
+     * the landmark lower bound on the remaining distance cannot give a lighter cycle. The landmarks
+     * must outlive the workspace and may be shared by several workspaces.
+     */
+    template<class Graph, class WeightMap>
+    class SignedDijkstraWorkspace {
+    public:
+        explicit SignedDijkstraWorkspace(const Graph &g) :
+                _forward(g), _backward(g), _landmarks(nullptr) {
+        }
 
-            if (use_cycle_weight_limit && !compare(d_u, cycle_weight_limit)) {
-                // reached limit
-                return std::make_tuple(std::set<Edge> { }, distance_inf, false);
-            }
+        /*
+         * Workspace for searches with the given weights, the searches are breadth first if all
+         * edges have the same weight. It must not be used with other weights.
+         */
+        SignedDijkstraWorkspace(const Graph &g, const WeightMap &weight_map,
+                const parmcb::detail::Landmarks<Graph, WeightMap> *landmarks = nullptr) :
+                _forward(g, parmcb::detail::has_uniform_weights(g, weight_map)), _backward(g,
+                        _forward.uniform_weights), _landmarks(
+                        landmarks != nullptr && landmarks->size() > 0 ? landmarks : nullptr) {
+        }
 
-            auto eiRange = boost::out_edges(signed_u.first, g);
-            for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
-                auto e = *ei;
-                if (use_hidden_edges && hidden_edges.find(e) != hidden_edges.end()) {
-                    continue;
-                }
-                auto w = boost::target(e, g);
-                if (w == u) {
-                    w = boost::source(e, g);
-                }
-                if (w == u) {
-                    // self-loop
-                    continue;
+        SignedDijkstraWorkspace(const SignedDijkstraWorkspace &other) = delete;
+        SignedDijkstraWorkspace& operator=(const SignedDijkstraWorkspace &other) = delete;
+
+        parmcb::detail::search_frontier<Graph, WeightMap>& forward() {
+            return _forward;
+        }
+
+        parmcb::detail::search_frontier<Graph, WeightMap>& backward() {
+            return _backward;
+        }
+
+        bool uniform_weights() const {
+            return _forward.uniform_weights;
+        }
+
+        const parmcb::detail::Landmarks<Graph, WeightMap>* landmarks() const {
+            return _landmarks;
+        }
+
+        std::size_t settled_vertices() const {
+            return _forward.settled_vertices + _backward.settled_vertices;
+        }
+
+        std::size_t scanned_edges() const {
+            return _forward.scanned_edges + _backward.scanned_edges;
+        }
+
+        void reset_statistics() {
+            _forward.settled_vertices = _backward.settled_vertices = 0;
+            _forward.scanned_edges = _backward.scanned_edges = 0;
+        }
+
+    private:
+        parmcb::detail::search_frontier<Graph, WeightMap> _forward;
+        parmcb::detail::search_frontier<Graph, WeightMap> _backward;
+        const parmcb::detail::Landmarks<Graph, WeightMap> *_landmarks;
+    };
+
+    namespace detail {
+
+        /*
+         * Signed graph searches, parameterized by how each scanned edge is classified.
+         */
+        template<class Graph, class WeightMap, class EdgeClassifier, class CycleWeightLimit>
+        std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+                typename boost::property_traits<WeightMap>::value_type, bool> signed_dijkstra_impl(const Graph &g,
+                const WeightMap &weight_map, const EdgeClassifier &classify,
+                const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+                const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos,
+                const CycleWeightLimit &cycle_weight_limit, SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef typename boost::property_traits<WeightMap>::value_type DistanceType;
+            typedef std::pair<Vertex, bool> SignedVertex;
+            typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
+
+            DistanceType distance_inf = (std::numeric_limits<DistanceType>::max)();
+            closed_plus<DistanceType> combine = closed_plus<DistanceType>();
+
+            search_frontier<Graph, WeightMap> &frontier = workspace.forward();
+            frontier.reset();
+            SignedVertex signed_s = std::make_pair(s, s_pos);
+            SignedVertex signed_t = std::make_pair(t, t_pos);
+            frontier.push_source(signed_s);
+
+            assert(signed_s != signed_t);
+
+            while (!frontier.empty()) {
+                SignedVertex signed_u = frontier.poll();
+                DistanceType d_u = frontier.get_dist(signed_u);
+                auto u = signed_u.first;
+
+                if (cycle_weight_limit.exceeded(d_u)) {
+                    // reached limit
+                    return std::make_tuple(std::set<Edge> { }, distance_inf, false);
                 }
 
-                const WeightType c = combine(d_u, get(weight_map, e));
-                if (use_cycle_weight_limit && !frontier.get().compare(c, cycle_weight_limit)) {
-                    // never insert if more than current minimum
-                    continue;
+                if (signed_u == signed_t) { // found target
+                    std::set<Edge> cycle;
+                    WeightType cycle_weight = WeightType();
+                    SignedVertex signed_cur = signed_t;
+                    while (signed_cur != signed_s) {
+                        Predecessor p = frontier.get_pred(signed_cur);
+                        Edge e = std::get<2>(p);
+                        if (!cycle.insert(e).second) {
+                            // duplicate edge, discard cycle
+                            return std::make_tuple(std::set<Edge> { }, distance_inf, false);
+                        } else {
+                            cycle_weight += get(weight_map, e);
+                        }
+                        signed_cur = std::get<0>(p);
+                    }
+                    return std::make_tuple(cycle, cycle_weight, true);
                 }
 
-                bool is_signed = (signed_edges.find(e) != signed_edges.end());
-                SignedVertex signed_w = std::make_pair(w, is_signed ? (!signed_u.second) : signed_u.second);
+                auto eiRange = boost::out_edges(signed_u.first, g);
+                for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
+                    auto e = *ei;
+                    ++frontier.scanned_edges;
+                    const signed_edge_kind kind = classify(e);
+                    if (kind == signed_edge_kind::hidden) {
+                        continue;
+                    }
 
-                frontier.get().update(signed_w, c, signed_u, e);
+                    auto w = boost::target(e, g);
+                    if (w == u) {
+                        w = boost::source(e, g);
+                    }
+                    if (w == u) {
+                        // self-loop
+                        continue;
+                    }
+                    const WeightType c = combine(d_u, get(weight_map, e));
 
-                if (other_frontier.get().has_finite_dist(signed_w)) {
-                    // check path with w's distance from other frontier
-                    DistanceType path_distance = combine(c, other_frontier.get().get_dist(signed_w));
-                    if (compare(path_distance, best_path)) {
-                        best_path_set = true;
-                        best_path = path_distance;
-                        best_path_common_vertex = signed_w;
+                    if (cycle_weight_limit.prunes(c)) {
+                        // never insert if more than current minimum
+                        continue;
                     }
+
+                    bool is_signed = (kind == signed_edge_kind::odd);
+                    SignedVertex signed_w = std::make_pair(w, is_signed ? (!signed_u.second) : signed_u.second);
+
+                    frontier.update(signed_w, c, signed_u, e);
                 }
 
             }
 
-            // swap frontiers
-            std::swap(frontier, other_frontier);
-        }
-
-        if (!best_path_set || (use_cycle_weight_limit && !compare(best_path, cycle_weight_limit))) {
             return std::make_tuple(std::set<Edge> { }, distance_inf, false);
         }
 
-        // create path if found
-        std::set<Edge> cycle;
-        WeightType cycle_weight = WeightType();
-
-        SignedVertex signed_cur = best_path_common_vertex;
-        SignedVertex signed_goal = frontier.get().get_source();
-        while (signed_cur != signed_goal) {
-            Predecessor p = frontier.get().get_pred(signed_cur);
-            Edge e = std::get<2>(p);
-            if (!cycle.insert(e).second) {
-                // duplicate edge, discard cycle
+        template<class AlternationPolicy, class Graph, class WeightMap, class EdgeClassifier, class CycleWeightLimit,
+                class DistanceBound>
+        std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+                typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra_search(
+                const Graph &g, const WeightMap &weight_map, const EdgeClassifier &classify,
+                const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+                const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos,
+                const CycleWeightLimit &cycle_weight_limit, const DistanceBound &distance_bound,
+                SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef typename boost::property_traits<WeightMap>::value_type DistanceType;
+            typedef std::pair<Vertex, bool> SignedVertex;
+            typedef std::tuple<SignedVertex, bool, Edge> Predecessor;
+
+            DistanceType distance_inf = (std::numeric_limits<DistanceType>::max)();
+            std::less<DistanceType> compare;
+            closed_plus<DistanceType> combine = closed_plus<DistanceType>();
+
+            SignedVertex signed_s = std::make_pair(s, s_pos);
+            search_frontier<Graph, WeightMap> &f_frontier = workspace.forward();
+            f_frontier.reset();
+            f_frontier.push_source(signed_s);
+
+            SignedVertex signed_t = std::make_pair(t, t_pos);
+            search_frontier<Graph, WeightMap> &b_frontier = workspace.backward();
+            b_frontier.reset();
+            b_frontier.push_source(signed_t);
+
+            assert(signed_s != signed_t);
+
+            std::reference_wrapper<search_frontier<Graph, WeightMap>> frontier = std::ref(f_frontier);
+            std::reference_wrapper<search_frontier<Graph, WeightMap>> other_frontier = std::ref(b_frontier);
+            bool forward = true;
+            AlternationPolicy alternation;
+            DistanceType best_path = distance_inf;
+            bool best_path_set = false;
+            SignedVertex best_path_common_vertex;
+
+            while (true) {
+                // stopping condition
+                if (frontier.get().empty() || other_frontier.get().empty()
+                        || (best_path_set
+                                && !compare(combine(frontier.get().find_min(), other_frontier.get().find_min()), best_path))) {
+                    break;
+                }
+
+                // choose the side to expand
+                if (alternation(frontier.get(), other_frontier.get())) {
+                    std::swap(frontier, other_frontier);
+                    forward = !forward;
+                }
+
+                // frontier scan
+                SignedVertex signed_u = frontier.get().poll();
+                DistanceType d_u = frontier.get().get_dist(signed_u);
+                auto u = signed_u.first;
+
+                if (cycle_weight_limit.exceeded(d_u)) {
+                    // reached limit
+                    return std::make_tuple(std::set<Edge> { }, distance_inf, false);
+                }
+
+                auto eiRange = boost::out_edges(signed_u.first, g);
+                for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
+                    auto e = *ei;
+                    ++frontier.get().scanned_edges;
+                    const signed_edge_kind kind = classify(e);
+                    if (kind == signed_edge_kind::hidden) {
+                        continue;
+                    }
+                    auto w = boost::target(e, g);
+                    if (w == u) {
+                        w = boost::source(e, g);
+                    }
+                    if (w == u) {
+                        // self-loop
+                        continue;
+                    }
+
+                    const WeightType c = combine(d_u, get(weight_map, e));
+                    if (cycle_weight_limit.prunes(c)) {
+                        // never insert if more than current minimum
+                        continue;
+                    }
+
+                    bool is_signed = (kind == signed_edge_kind::odd);
+                    SignedVertex signed_w = std::make_pair(w, is_signed ? (!signed_u.second) : signed_u.second);
+
+                    if (DistanceBound::enabled && frontier.get().improves(signed_w, c)) {
+                        // any path through w is at least as heavy as the estimate
+                        const WeightType remaining = distance_bound(forward, w);
+                        if (remaining == distance_inf) {
+                            continue;
+                        }
+                        const WeightType estimate = combine(c, remaining);
+                        if (cycle_weight_limit.prunes(estimate) || (best_path_set && !compare(estimate, best_path))) {
+                            continue;
+                        }
+                    }
+
+                    frontier.get().update(signed_w, c, signed_u, e);
+
+                    if (other_frontier.get().has_finite_dist(signed_w)) {
+                        // check path with w's distance from other frontier
+                        DistanceType path_distance = combine(c, other_frontier.get().get_dist(signed_w));
+                        if (compare(path_distance, best_path)) {
+                            best_path_set = true;
+                            best_path = path_distance;
+                            best_path_common_vertex = signed_w;
+                        }
+                    }
+
+                }
+
+                // swap frontiers
+                std::swap(frontier, other_frontier);
+                forward = !forward;
+            }
+
+            if (!best_path_set || cycle_weight_limit.exceeded(best_path)) {
                 return std::make_tuple(std::set<Edge> { }, distance_inf, false);
-            } else {
-                cycle_weight += boost::get(weight_map, e);
             }
-            signed_cur = std::get<0>(p);
+
+            // create path if found
+            std::set<Edge> cycle;
+            WeightType cycle_weight = WeightType();
+
+            SignedVertex signed_cur = best_path_common_vertex;
+            SignedVertex signed_goal = frontier.get().get_source();
+            while (signed_cur != signed_goal) {
+                Predecessor p = frontier.get().get_pred(signed_cur);
+                Edge e = std::get<2>(p);
+                if (!cycle.insert(e).second) {
+                    // duplicate edge, discard cycle
+                    return std::make_tuple(std::set<Edge> { }, distance_inf, false);
+                } else {
+                    cycle_weight += boost::get(weight_map, e);
+                }
+                signed_cur = std::get<0>(p);
+            }
+
+            signed_cur = best_path_common_vertex;
+            signed_goal = other_frontier.get().get_source();
+            while (signed_cur != signed_goal) {
+                Predecessor p = other_frontier.get().get_pred(signed_cur);
+                Edge e = std::get<2>(p);
+                if (!cycle.insert(e).second) {
+                    // duplicate edge, discard cycle
+                    return std::make_tuple(std::set<Edge> { }, distance_inf, false);
+                } else {
+                    cycle_weight += boost::get(weight_map, e);
+                }
+                signed_cur = std::get<0>(p);
+            }
+            return std::make_tuple(cycle, cycle_weight, true);
         }
 
-        signed_cur = best_path_common_vertex;
-        signed_goal = other_frontier.get().get_source();
-        while (signed_cur != signed_goal) {
-            Predecessor p = other_frontier.get().get_pred(signed_cur);
-            Edge e = std::get<2>(p);
-            if (!cycle.insert(e).second) {
-                // duplicate edge, discard cycle
-                return std::make_tuple(std::set<Edge> { }, distance_inf, false);
-            } else {
-                cycle_weight += boost::get(weight_map, e);
+        template<class AlternationPolicy, class Graph, class WeightMap, class EdgeClassifier, class CycleWeightLimit>
+        std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+                typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra_impl(
+                const Graph &g, const WeightMap &weight_map, const EdgeClassifier &classify,
+                const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+                const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos,
+                const CycleWeightLimit &cycle_weight_limit, SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+            if (workspace.landmarks() != nullptr) {
+                landmark_distance_bound<Graph, WeightMap> distance_bound(*workspace.landmarks(), s, t);
+                return bidirectional_signed_dijkstra_search<AlternationPolicy>(g, weight_map, classify, s, s_pos, t,
+                        t_pos, cycle_weight_limit, distance_bound, workspace);
             }
-            signed_cur = std::get<0>(p);
+            no_distance_bound<Graph, typename boost::property_traits<WeightMap>::value_type> distance_bound;
+            return bidirectional_signed_dijkstra_search<AlternationPolicy>(g, weight_map, classify, s, s_pos, t, t_pos,
+                    cycle_weight_limit, distance_bound, workspace);
         }
-        return std::make_tuple(cycle, cycle_weight, true);
+
+    } // detail
+
+    template<class Graph, class WeightMap, class SignedEdges, class HiddenEdges>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::set_edge_classifier<Graph, SignedEdges, HiddenEdges> classify(signed_edges, hidden_edges,
+                use_hidden_edges);
+        parmcb::detail::fixed_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit);
+        return parmcb::detail::signed_dijkstra_impl(g, weight_map, classify, s, s_pos, t, t_pos, limit, workspace);
+    }
+
+    template<class AlternationPolicy = parmcb::strict_alternation, class Graph, class WeightMap, class SignedEdges,
+            class HiddenEdges>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::set_edge_classifier<Graph, SignedEdges, HiddenEdges> classify(signed_edges, hidden_edges,
+                use_hidden_edges);
+        parmcb::detail::fixed_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit);
+        return parmcb::detail::bidirectional_signed_dijkstra_impl<AlternationPolicy>(g, weight_map, classify, s, s_pos,
+                t, t_pos, limit, workspace);
+    }
+
+    /*
+     * Variants where membership in the signed and hidden edge sets is given by bitmaps indexed
+     * by a dense edge id, which the edge index map provides for every edge of the graph.
+     */
+    template<class Graph, class WeightMap, class EdgeIndexMap>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+            const parmcb::detail::EdgeBitmap &signed_edges, const parmcb::detail::EdgeBitmap &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::bitmap_edge_classifier<Graph, EdgeIndexMap> classify(edge_index_map, signed_edges,
+                hidden_edges, use_hidden_edges);
+        parmcb::detail::fixed_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit);
+        return parmcb::detail::signed_dijkstra_impl(g, weight_map, classify, s, s_pos, t, t_pos, limit, workspace);
+    }
+
+    template<class AlternationPolicy = parmcb::strict_alternation, class Graph, class WeightMap, class EdgeIndexMap>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+            const parmcb::detail::EdgeBitmap &signed_edges, const parmcb::detail::EdgeBitmap &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::bitmap_edge_classifier<Graph, EdgeIndexMap> classify(edge_index_map, signed_edges,
+                hidden_edges, use_hidden_edges);
+        parmcb::detail::fixed_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit);
+        return parmcb::detail::bidirectional_signed_dijkstra_impl<AlternationPolicy>(g, weight_map, classify, s, s_pos,
+                t, t_pos, limit, workspace);
+    }
+
+    /*
+     * Bitmap variant which additionally stops at a bound shared by concurrent searches. The
+     * search stops when it settles a label d with d + bound_offset strictly heavier than the
+     * bound.
+     */
+    template<class AlternationPolicy = parmcb::strict_alternation, class Graph, class WeightMap, class EdgeIndexMap>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+            const parmcb::detail::EdgeBitmap &signed_edges, const parmcb::detail::EdgeBitmap &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            const SharedCycleWeightBound<typename boost::property_traits<WeightMap>::value_type> &bound,
+            const typename boost::property_traits<WeightMap>::value_type &bound_offset,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::bitmap_edge_classifier<Graph, EdgeIndexMap> classify(edge_index_map, signed_edges,
+                hidden_edges, use_hidden_edges);
+        parmcb::detail::shared_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit, bound, bound_offset);
+        return parmcb::detail::bidirectional_signed_dijkstra_impl<AlternationPolicy>(g, weight_map, classify, s, s_pos,
+                t, t_pos, limit, workspace);
+    }
+
+    /*
+     * Variants where the signed edges are given by their ranks and the signed edges at position
+     * first_hidden or later are hidden, EdgeRanks::none hides nothing.
+     */
+    template<class AlternationPolicy = parmcb::strict_alternation, class Graph, class WeightMap, class EdgeIndexMap>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+            const parmcb::detail::EdgeRanks &signed_edges, std::size_t first_hidden,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::rank_edge_classifier<Graph, EdgeIndexMap> classify(edge_index_map, signed_edges,
+                first_hidden);
+        parmcb::detail::fixed_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit);
+        return parmcb::detail::bidirectional_signed_dijkstra_impl<AlternationPolicy>(g, weight_map, classify, s, s_pos,
+                t, t_pos, limit, workspace);
+    }
+
+    template<class AlternationPolicy = parmcb::strict_alternation, class Graph, class WeightMap, class EdgeIndexMap>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const EdgeIndexMap &edge_index_map,
+            const parmcb::detail::EdgeRanks &signed_edges, std::size_t first_hidden,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit,
+            const SharedCycleWeightBound<typename boost::property_traits<WeightMap>::value_type> &bound,
+            const typename boost::property_traits<WeightMap>::value_type &bound_offset,
+            SignedDijkstraWorkspace<Graph, WeightMap> &workspace) {
+        parmcb::detail::rank_edge_classifier<Graph, EdgeIndexMap> classify(edge_index_map, signed_edges,
+                first_hidden);
+        parmcb::detail::shared_cycle_weight_limit<typename boost::property_traits<WeightMap>::value_type> limit(
+                use_cycle_weight_limit, cycle_weight_limit, bound, bound_offset);
+        return parmcb::detail::bidirectional_signed_dijkstra_impl<AlternationPolicy>(g, weight_map, classify, s, s_pos,
+                t, t_pos, limit, workspace);
+    }
+
+    template<class Graph, class WeightMap, class SignedEdges, class HiddenEdges>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit) {
+        SignedDijkstraWorkspace<Graph, WeightMap> workspace(g);
+        return signed_dijkstra(g, weight_map, signed_edges, hidden_edges, use_hidden_edges, s, s_pos, t, t_pos,
+                use_cycle_weight_limit, cycle_weight_limit, workspace);
+    }
+
+    template<class AlternationPolicy = parmcb::strict_alternation, class Graph, class WeightMap, class SignedEdges,
+            class HiddenEdges>
+    std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
+            typename boost::property_traits<WeightMap>::value_type, bool> bidirectional_signed_dijkstra(const Graph &g,
+            const WeightMap &weight_map, const SignedEdges &signed_edges, const HiddenEdges &hidden_edges,
+            bool use_hidden_edges, const typename boost::graph_traits<Graph>::vertex_descriptor &s, bool s_pos,
+            const typename boost::graph_traits<Graph>::vertex_descriptor &t, bool t_pos, bool use_cycle_weight_limit,
+            const typename boost::property_traits<WeightMap>::value_type &cycle_weight_limit) {
+        SignedDijkstraWorkspace<Graph, WeightMap> workspace(g);
+        return bidirectional_signed_dijkstra<AlternationPolicy>(g, weight_map, signed_edges, hidden_edges,
+                use_hidden_edges, s, s_pos,
+                t, t_pos, use_cycle_weight_limit, cycle_weight_limit, workspace);
     }
 
 } // parmcb
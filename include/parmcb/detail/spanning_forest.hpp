@@ -6,16 +6,31 @@
 //    (See accompanying file LICENSE_1_0.txt or copy at
 //          https://www.boost.org/LICENSE_1_0.txt)
 
-#include <map>
-#include <queue>
-#include <set>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <boost/graph/adjacency_list.hpp>
 
+#include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 namespace parmcb {
 
     namespace detail {
 
+        /*
+         * Breadth first search spanning forest. Vertices are kept in a flat array indexed by
+         * the vertex index and roots are chosen in index order. Returns the number of
+         * connected components.
+         */
         template<class Graph, class OutputIterator>
         std::size_t spanning_forest(const Graph &g, OutputIterator spanning_forest_edges) {
 
@@ -23,30 +38,28 @@ namespace parmcb {
                 return 0;
 
             typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
-            typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
             typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
 
             BOOST_CONCEPT_ASSERT(( boost::VertexListGraphConcept<Graph> ));
             BOOST_CONCEPT_ASSERT(( boost::OutputIteratorConcept<OutputIterator, Edge> ));
 
-            std::queue<Vertex> queue;
-            std::unordered_set<Vertex> unreached;
-            VertexIt ui, uiend;
-            for (boost::tie(ui, uiend) = boost::vertices(g); ui != uiend; ++ui) {
-                unreached.insert(*ui);
-            }
+            auto index_map = boost::get(boost::vertex_index, g);
+            std::size_t n = boost::num_vertices(g);
+            std::vector<bool> reached(n, false);
+            std::vector<Vertex> queue;
+            queue.reserve(n);
 
             std::size_t c = 0;
-            while (!unreached.empty()) {
-                auto vi = unreached.begin();
-                auto v = *vi;
-                unreached.erase(vi);
-                queue.push(v);
-
-                while (!queue.empty()) {
-                    auto u = queue.front();
-                    queue.pop();
+            for (const auto &v : boost::make_iterator_range(boost::vertices(g))) {
+                if (reached[index_map[v]]) {
+                    continue;
+                }
+                reached[index_map[v]] = true;
+                queue.clear();
+                queue.push_back(v);
 
+                for (std::size_t head = 0; head < queue.size(); head++) {
+                    auto u = queue[head];
                     auto eiRange = boost::out_edges(u, g);
                     for (auto ei = eiRange.first; ei != eiRange.second; ++ei) {
                         auto e = *ei;
@@ -55,14 +68,13 @@ namespace parmcb {
                             // ignore self-loop
                             continue;
                         }
-
-                        auto wit = unreached.find(w);
-                        if (wit == unreached.end()) {
+                        auto wi = index_map[w];
+                        if (reached[wi]) {
                             continue;
                         }
-                        unreached.erase(wit);
+                        reached[wi] = true;
                         *spanning_forest_edges++ = e;
-                        queue.push(w);
+                        queue.push_back(w);
                     }
                 }
                 c++;
@@ -71,6 +83,158 @@ namespace parmcb {
             return c;
         }
 
+#ifdef PARMCB_HAVE_TBB
+
+        /*
+         * Concurrent union-find where roots are linked below the root with the smaller index
+         * using compare and swap.
+         */
+        class ConcurrentUnionFind {
+        public:
+            explicit ConcurrentUnionFind(std::size_t n) :
+                    parent(new std::atomic<std::size_t>[n]) {
+                for (std::size_t i = 0; i < n; i++) {
+                    parent[i].store(i, std::memory_order_relaxed);
+                }
+            }
+
+            std::size_t find(std::size_t x) {
+                while (true) {
+                    std::size_t p = parent[x].load(std::memory_order_acquire);
+                    if (p == x) {
+                        return x;
+                    }
+                    std::size_t gp = parent[p].load(std::memory_order_acquire);
+                    if (gp != p) {
+                        // path halving
+                        parent[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+                    }
+                    x = gp;
+                }
+            }
+
+            /*
+             * Returns true if the call joined two different sets.
+             */
+            bool unite(std::size_t x, std::size_t y) {
+                while (true) {
+                    x = find(x);
+                    y = find(y);
+                    if (x == y) {
+                        return false;
+                    }
+                    if (x > y) {
+                        std::swap(x, y);
+                    }
+                    std::size_t expected = y;
+                    if (parent[y].compare_exchange_strong(expected, x, std::memory_order_acq_rel)) {
+                        return true;
+                    }
+                }
+            }
+
+        private:
+            std::unique_ptr<std::atomic<std::size_t>[]> parent;
+        };
+
+        /*
+         * Spanning forest using parallel Boruvka rounds where each component picks its
+         * first outgoing edge in the order of boost::edges(). This is the minimum spanning
+         * forest with the edge positions as weights, so the forest is the one a sequential
+         * union-find in edge order would build and does not depend on the scheduling of the
+         * threads. The edges are reported in the order of boost::edges(). Returns the number
+         * of connected components.
+         */
+        template<class Graph, class OutputIterator>
+        std::size_t spanning_forest_tbb(const Graph &g, OutputIterator spanning_forest_edges) {
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            const std::size_t npos = static_cast<std::size_t>(-1);
+
+            auto index_map = boost::get(boost::vertex_index, g);
+            std::size_t n = boost::num_vertices(g);
+            std::vector<Edge> edges;
+            std::vector<std::pair<std::size_t, std::size_t>> ends;
+            edges.reserve(boost::num_edges(g));
+            ends.reserve(boost::num_edges(g));
+            for (const auto &e : boost::make_iterator_range(boost::edges(g))) {
+                edges.push_back(e);
+                ends.emplace_back(index_map[boost::source(e, g)], index_map[boost::target(e, g)]);
+            }
+
+            ConcurrentUnionFind uf(n);
+            std::vector<std::size_t> component(n);
+            std::unique_ptr<std::atomic<std::size_t>[]> first(new std::atomic<std::size_t>[n]);
+            std::vector<char> on_forest(edges.size(), 0);
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](const tbb::blocked_range<std::size_t> &r) {
+                for (std::size_t v = r.begin(); v != r.end(); ++v) {
+                    component[v] = v;
+                }
+            });
+
+            auto lower = [](std::atomic<std::size_t> &a, std::size_t i) {
+                std::size_t cur = a.load(std::memory_order_relaxed);
+                while (i < cur && !a.compare_exchange_weak(cur, i, std::memory_order_relaxed)) {
+                }
+            };
+
+            // every round at least halves the number of components with an outgoing edge
+            std::atomic<bool> merged(true);
+            while (merged.load()) {
+                merged.store(false);
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            for (std::size_t v = r.begin(); v != r.end(); ++v) {
+                                first[v].store(npos, std::memory_order_relaxed);
+                            }
+                        });
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, edges.size()),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            for (std::size_t i = r.begin(); i != r.end(); ++i) {
+                                std::size_t cu = component[ends[i].first];
+                                std::size_t cv = component[ends[i].second];
+                                if (cu != cv) {
+                                    lower(first[cu], i);
+                                    lower(first[cv], i);
+                                }
+                            }
+                        });
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            for (std::size_t c = r.begin(); c != r.end(); ++c) {
+                                std::size_t i = first[c].load(std::memory_order_relaxed);
+                                if (i == npos) {
+                                    continue;
+                                }
+                                // when both components pick the same edge the smaller one marks it
+                                std::size_t cu = component[ends[i].first];
+                                std::size_t d = cu == c ? component[ends[i].second] : cu;
+                                if (d > c || first[d].load(std::memory_order_relaxed) != i) {
+                                    on_forest[i] = 1;
+                                }
+                                uf.unite(c, d);
+                                merged.store(true, std::memory_order_relaxed);
+                            }
+                        });
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            for (std::size_t v = r.begin(); v != r.end(); ++v) {
+                                component[v] = uf.find(component[v]);
+                            }
+                        });
+            }
+
+            std::size_t forest_edges = 0;
+            for (std::size_t i = 0; i < edges.size(); i++) {
+                if (on_forest[i]) {
+                    *spanning_forest_edges++ = edges[i];
+                    forest_edges++;
+                }
+            }
+            return n - forest_edges;
+        }
+
+#endif
+
     } // detail
 
 } // parmcb
@@ -0,0 +1,355 @@
+#ifndef PARMCB_DETAIL_SUPPORT_VECTORS_HPP_
+#define PARMCB_DETAIL_SUPPORT_VECTORS_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include <parmcb/config.hpp>
+#include <parmcb/detail/m4rm.hpp>
+#include <parmcb/detail/numa.hpp>
+#include <parmcb/spvecgf2.hpp>
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
+namespace parmcb {
+
+    /*
+     * How the support vectors are kept orthogonal to the cycles found so far.
+     */
+    enum class support_update {
+        // after each cycle all remaining support vectors are updated
+        eager,
+        // vectors after the current block are updated once per block using GF(2) matrix products
+        blocked
+    };
+
+    namespace detail {
+
+        /*
+         * The support vectors of the de Pina scheme. Vector k starts as the k-th unit vector and
+         * when cycle k is found every vector l > k with odd intersection gets vector k added.
+         *
+         * With blocked updates only the vectors inside the current block of BLOCK_SIZE are
+         * updated after each cycle. When the block completes, let M be the matrix of inner
+         * products of the block vectors with the block cycles, which is unit upper triangular,
+         * and a the inner products of a later vector S with the block cycles. Then S + (a M^-1) B,
+         * where B are the block vectors, is orthogonal to all block cycles. Both products use
+         * Method of Four Russians tables on packed bits. When the block vectors are sparse, fewer ones
+         * in total than eight times the words of a vector, the rows of B are instead added as sparse
+         * vectors, which avoids building the tables and keeps sparse later vectors sparse.
+         *
+         * The vectors can be distributed among NUMA nodes in chunks of BLOCK_SIZE, assigned round
+         * robin, and each node then updates the vectors it owns.
+         */
+        template<bool ParallelUsingTBB>
+        class SupportVectors {
+        public:
+            typedef SpVecGF2<std::size_t> vector_type;
+
+            static constexpr std::size_t BLOCK_SIZE = 64;
+
+            SupportVectors(std::size_t csd, support_update strategy = support_update::eager) :
+                    strategy(strategy), words_per_vector((csd + 63) / 64) {
+                support.reserve(csd);
+                for (std::size_t k = 0; k < csd; k++) {
+                    support.emplace_back(k);
+                }
+                if (strategy == support_update::blocked) {
+                    cycle_words.assign(csd, 0);
+                }
+            }
+
+            std::size_t size() const {
+                return support.size();
+            }
+
+#ifdef PARMCB_HAVE_TBB
+            /*
+             * Move the vectors to the nodes which own them, all later updates run on these nodes.
+             */
+            void distribute(NumaDomains &domains) {
+                this->domains = &domains;
+                parallel_for_owned(0, support.size(), [&](std::size_t l) {
+                    support[l] = vector_type(support[l]);
+                });
+            }
+#endif
+
+            vector_type& operator[](std::size_t k) {
+                return support[k];
+            }
+
+            const vector_type& operator[](std::size_t k) const {
+                return support[k];
+            }
+
+            /*
+             * Vectors in [k, fresh_end(k)) are up to date with all cycles found before cycle k
+             * and are therefore the candidates for it.
+             */
+            std::size_t fresh_end(std::size_t k) const {
+                if (strategy == support_update::eager) {
+                    return support.size();
+                }
+                return (std::min)(block_begin(k) + BLOCK_SIZE, support.size());
+            }
+
+            /*
+             * Called before the pivot of cycle k is chosen. With blocked updates, at the start of
+             * each block all later vectors are up to date, and the sparsest of them are moved into
+             * the block, ordered by size and then by position. Thus the sparsest support heuristic
+             * is not limited to the vectors which happen to share the block with k.
+             */
+            void gather_candidates(std::size_t k) {
+                if (strategy == support_update::eager || k != block_begin(k)) {
+                    return;
+                }
+                std::size_t b = fresh_end(k) - k;
+                std::vector<std::size_t> order(support.size() - k);
+                for (std::size_t i = 0; i < order.size(); i++) {
+                    order[i] = k + i;
+                }
+                auto sparser = [&](std::size_t l, std::size_t r) {
+                    return support[l].size() < support[r].size() || (support[l].size() == support[r].size() && l < r);
+                };
+                std::partial_sort(order.begin(), order.begin() + b, order.end(), sparser);
+                std::sort(order.begin() + b, order.end());
+
+                std::vector<vector_type> moved;
+                moved.reserve(order.size());
+                for (auto l : order) {
+                    moved.push_back(std::move(support[l]));
+                }
+                for (std::size_t i = 0; i < moved.size(); i++) {
+                    support[k + i] = std::move(moved[i]);
+                }
+            }
+
+            /*
+             * Record cycle k, given by its edge ids, and update the remaining support vectors.
+             */
+            void update(std::size_t k, const std::set<std::size_t> &cyclek) {
+                std::size_t end = fresh_end(k);
+                add_where_odd(k, k + 1, end, cyclek);
+
+                if (strategy == support_update::blocked && end < support.size()) {
+                    std::uint64_t bit = std::uint64_t(1) << (k - block_begin(k));
+                    for (auto id : cyclek) {
+                        if (id < support.size()) {
+                            cycle_words[id] |= bit;
+                        }
+                    }
+                    if (k + 1 == end) {
+                        flush(block_begin(k), end);
+                    }
+                }
+            }
+
+        private:
+            static std::size_t block_begin(std::size_t k) {
+                return k - k % BLOCK_SIZE;
+            }
+
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void add_where_odd(std::size_t k, std::size_t first, std::size_t last, const std::set<std::size_t> &cyclek,
+                    typename std::enable_if<!is_tbb_enabled>::type* = 0) {
+                for (std::size_t l = first; l < last; l++) {
+                    if (support[l] * cyclek == 1) {
+                        support[l] += support[k];
+                    }
+                }
+            }
+
+#ifdef PARMCB_HAVE_TBB
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void add_where_odd(std::size_t k, std::size_t first, std::size_t last, const std::set<std::size_t> &cyclek,
+                    typename std::enable_if<is_tbb_enabled>::type* = 0) {
+                if (first >= last) {
+                    return;
+                }
+                parallel_for_owned(first, last, [&](std::size_t l) {
+                    if (support[l] * cyclek == 1) {
+                        support[l] += support[k];
+                    }
+                });
+            }
+
+            /*
+             * Call f(l) for each l in [first, last) in parallel, on the owning nodes if distributed.
+             */
+            template<class F>
+            void parallel_for_owned(std::size_t first, std::size_t last, F f) {
+                if (domains == nullptr) {
+                    tbb::parallel_for(tbb::blocked_range<std::size_t>(first, last),
+                            [&](const tbb::blocked_range<std::size_t> &r) {
+                                for (std::size_t l = r.begin(); l != r.end(); ++l) {
+                                    f(l);
+                                }
+                            });
+                    return;
+                }
+                const std::size_t nodes = domains->size();
+                domains->for_each([&](std::size_t i) {
+                    // first chunk of node i which intersects [first, last)
+                    std::size_t begin = first / BLOCK_SIZE;
+                    begin += (i + nodes - begin % nodes) % nodes;
+                    if (begin * BLOCK_SIZE >= last) {
+                        return;
+                    }
+                    std::size_t chunks = ((last - 1) / BLOCK_SIZE - begin) / nodes + 1;
+                    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, chunks),
+                            [&](const tbb::blocked_range<std::size_t> &r) {
+                                for (std::size_t c = r.begin(); c != r.end(); ++c) {
+                                    std::size_t chunk = begin + c * nodes;
+                                    std::size_t e = (std::min)(last, (chunk + 1) * BLOCK_SIZE);
+                                    for (std::size_t l = (std::max)(first, chunk * BLOCK_SIZE); l < e; l++) {
+                                        f(l);
+                                    }
+                                }
+                            });
+                });
+            }
+#endif
+
+            /*
+             * Inner products of a vector with the cycles of the current block, one bit per cycle.
+             */
+            std::uint64_t block_products(const vector_type &v) const {
+                std::uint64_t a = 0;
+                v.for_each([&](std::size_t p) {
+                    a ^= cycle_words[p];
+                });
+                return a;
+            }
+
+            /*
+             * Apply the deferred updates of the completed block [first, last) to all later vectors.
+             */
+            void flush(std::size_t first, std::size_t last) {
+                std::size_t b = last - first;
+
+                // columns of the unit upper triangular matrix M
+                std::vector<std::uint64_t> columns(b, 0);
+                for (std::size_t i = 0; i < b; i++) {
+                    std::uint64_t row = block_products(support[first + i]);
+                    assert(((row >> i) & 1) == 1);
+                    for (std::size_t j = i + 1; j < b; j++) {
+                        columns[j] |= ((row >> j) & 1) << i;
+                    }
+                }
+
+                // rows of M^-1, by solving x M = e_i
+                std::vector<std::uint64_t> inverse_rows(b);
+                for (std::size_t i = 0; i < b; i++) {
+                    std::uint64_t x = 0;
+                    for (std::size_t j = 0; j < b; j++) {
+                        std::uint64_t bit = (j == i ? 1 : 0) ^ (popcount64(x & columns[j]) & 1);
+                        x |= bit << j;
+                    }
+                    inverse_rows[i] = x;
+                }
+                std::vector<const std::uint64_t*> inverse_ptrs;
+                for (std::size_t i = 0; i < b; i++) {
+                    inverse_ptrs.push_back(&inverse_rows[i]);
+                }
+                inverse_table.build(inverse_ptrs, 1);
+
+                block_first = first;
+                std::size_t block_ones = 0;
+                for (std::size_t i = 0; i < b; i++) {
+                    block_ones += support[first + i].size();
+                }
+                sparse_block = block_ones < 8 * words_per_vector;
+                if (!sparse_block) {
+                    // block vectors as packed rows
+                    block_rows.assign(b * words_per_vector, 0);
+                    std::vector<const std::uint64_t*> block_ptrs;
+                    for (std::size_t i = 0; i < b; i++) {
+                        support[first + i].xor_into(&block_rows[i * words_per_vector], words_per_vector);
+                        block_ptrs.push_back(&block_rows[i * words_per_vector]);
+                    }
+                    block_table.build(block_ptrs, words_per_vector);
+                }
+
+                apply_block(last, support.size());
+
+                std::fill(cycle_words.begin(), cycle_words.end(), 0);
+            }
+
+            void apply_block_to(std::size_t l, std::vector<std::uint64_t> &buffer) {
+                std::uint64_t a = block_products(support[l]);
+                if (a == 0) {
+                    return;
+                }
+                std::uint64_t x = 0;
+                inverse_table.multiply(a, &x);
+                if (sparse_block) {
+                    for (; x != 0; x &= x - 1) {
+                        support[l] += support[block_first + ctz64(x)];
+                    }
+                    return;
+                }
+                std::fill(buffer.begin(), buffer.end(), 0);
+                block_table.multiply(x, buffer.data());
+                support[l].add_words(buffer.data(), buffer.size());
+            }
+
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void apply_block(std::size_t first, std::size_t last, typename std::enable_if<!is_tbb_enabled>::type* = 0) {
+                std::vector<std::uint64_t> buffer(words_per_vector);
+                for (std::size_t l = first; l < last; l++) {
+                    apply_block_to(l, buffer);
+                }
+            }
+
+#ifdef PARMCB_HAVE_TBB
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void apply_block(std::size_t first, std::size_t last, typename std::enable_if<is_tbb_enabled>::type* = 0) {
+                if (first >= last) {
+                    return;
+                }
+                tbb::enumerable_thread_specific<std::vector<std::uint64_t>> buffers(words_per_vector);
+                parallel_for_owned(first, last, [&](std::size_t l) {
+                    apply_block_to(l, buffers.local());
+                });
+            }
+#endif
+
+            support_update strategy;
+            std::size_t words_per_vector;
+            std::vector<vector_type> support;
+#ifdef PARMCB_HAVE_TBB
+            NumaDomains *domains = nullptr;
+#endif
+
+            // bit j of cycle_words[p] is set if edge p belongs to the j-th cycle of the block
+            std::vector<std::uint64_t> cycle_words;
+            std::size_t block_first = 0;
+            bool sparse_block = false;
+            std::vector<std::uint64_t> block_rows;
+            M4RMTable inverse_table;
+            M4RMTable block_table;
+        };
+
+        template<bool ParallelUsingTBB>
+        constexpr std::size_t SupportVectors<ParallelUsingTBB>::BLOCK_SIZE;
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -49,14 +49,14 @@ namespace parmcb {
             typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
 
             std::vector<V> &values;
-            const VertexIndexMapType &index_map;
+            VertexIndexMapType index_map;
 
             VertexIndexFunctor(std::vector<V> &values, const VertexIndexMapType &index_map) :
                     values(values), index_map(index_map) {
             }
 
             V& operator()(const Vertex &v) const {
-                return values.at(index_map[v]);
+                return values[index_map[v]];
             }
         };
 
@@ -0,0 +1,167 @@
+#ifndef PARMCB_EXECUTION_CONTEXT_HPP_
+#define PARMCB_EXECUTION_CONTEXT_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <parmcb/config.hpp>
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/info.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#endif
+
+namespace parmcb {
+
+    /*
+     * Threads used by the parallel algorithms. The algorithm runs in its own task arena with at
+     * most concurrency threads, zero uses all threads of the calling arena. A non-negative NUMA
+     * node restricts the threads to the cores of that node, which needs the TBBBind library of
+     * oneTBB. When pin_threads is set each thread of the arena is bound to a single core, chosen
+     * among the cores it may run on when it joins the arena, which is ignored outside Linux.
+     *
+     * With numa_replication the algorithms which support it run one task arena per NUMA node
+     * instead, each working on its own copy of the read-only data, see NumaDomains. The NUMA
+     * nodes are found by libnuma or from /sys, and numa_node then selects a single node.
+     *
+     * The default context runs in the calling arena, so a parallel algorithm called from another
+     * one shares its threads. Conversion from a single number keeps the older calls which passed
+     * a hardware concurrency hint. The context follows the output iterator in all entry points.
+     */
+    struct execution_context {
+        execution_context(std::size_t concurrency = 0) :
+                execution_context(concurrency, -1) {
+        }
+
+        explicit execution_context(std::size_t concurrency, int numa_node, bool pin_threads = false,
+                bool numa_replication = false) :
+                concurrency(concurrency), numa_node(numa_node), pin_threads(pin_threads), numa_replication(
+                        numa_replication) {
+        }
+
+        bool is_default() const {
+            return concurrency == 0 && numa_node < 0 && !pin_threads && !numa_replication;
+        }
+
+        std::size_t concurrency;
+        int numa_node;
+        bool pin_threads;
+        bool numa_replication;
+    };
+
+    namespace detail {
+
+#if defined(PARMCB_HAVE_TBB) && defined(__linux__)
+        /*
+         * Binds each thread entering the arena to the given cores, or to one of them if single_core
+         * is set where the arena slot picks the core. Without cores the thread is bound to one of
+         * the cores it may run on when it joins. The previous affinity is restored when the thread
+         * leaves.
+         */
+        class ThreadPinningObserver: public tbb::task_scheduler_observer {
+        public:
+            explicit ThreadPinningObserver(tbb::task_arena &arena, const std::vector<int> &cores =
+                    std::vector<int>(), bool single_core = true) :
+                    tbb::task_scheduler_observer(arena), cores(cores), single_core(single_core) {
+                observe(true);
+            }
+
+            ~ThreadPinningObserver() {
+                observe(false);
+            }
+
+            void on_scheduler_entry(bool) override {
+                cpu_set_t &previous = saved.local();
+                if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &previous) != 0) {
+                    return;
+                }
+                std::vector<int> allowed = cores;
+                if (allowed.empty()) {
+                    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                        if (CPU_ISSET(cpu, &previous)) {
+                            allowed.push_back(cpu);
+                        }
+                    }
+                }
+                int slot = tbb::this_task_arena::current_thread_index();
+                if (allowed.empty() || slot < 0) {
+                    return;
+                }
+                cpu_set_t pinned;
+                CPU_ZERO(&pinned);
+                if (single_core) {
+                    CPU_SET(allowed[static_cast<std::size_t>(slot) % allowed.size()], &pinned);
+                } else {
+                    for (int cpu : allowed) {
+                        CPU_SET(cpu, &pinned);
+                    }
+                }
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &pinned);
+            }
+
+            void on_scheduler_exit(bool) override {
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved.local());
+            }
+
+        private:
+            const std::vector<int> cores;
+            const bool single_core;
+            tbb::enumerable_thread_specific<cpu_set_t> saved;
+        };
+#endif
+
+        /*
+         * Runs f according to the execution context and returns its result.
+         */
+        template<class F>
+        auto execute(const execution_context &context, F f) -> decltype(f()) {
+#ifdef PARMCB_HAVE_TBB
+            if (context.is_default() || context.numa_replication) {
+                // with replication the algorithm creates the arenas of the NUMA nodes
+                return f();
+            }
+
+            tbb::task_arena::constraints constraints;
+            if (context.concurrency > 0) {
+                constraints.set_max_concurrency(static_cast<int>(context.concurrency));
+            }
+            if (context.numa_node >= 0) {
+                std::vector<tbb::numa_node_id> nodes = tbb::info::numa_nodes();
+                if (std::find(nodes.begin(), nodes.end(), context.numa_node) == nodes.end()) {
+                    throw std::invalid_argument("Unknown NUMA node");
+                }
+                constraints.set_numa_id(context.numa_node);
+            }
+            tbb::task_arena arena(constraints);
+            arena.initialize();
+#ifdef __linux__
+            if (context.pin_threads) {
+                ThreadPinningObserver observer(arena);
+                return arena.execute(f);
+            }
+#endif
+            return arena.execute(f);
+#else
+            (void) context;
+            return f();
+#endif
+        }
+
+    } // detail
+
+} // parmcb
+
+#endif
@@ -6,52 +6,120 @@
 //    (See accompanying file LICENSE_1_0.txt or copy at
 //          https://www.boost.org/LICENSE_1_0.txt)
 
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
 #include <vector>
-#include <map>
-#include <queue>
-#include <set>
 
+#include <boost/functional/hash.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+#include <boost/property_map/function_property_map.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/graph_concepts.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/concept/assert.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/detail/spanning_forest.hpp>
 
 namespace parmcb {
 
-    template<class Graph>
+    namespace detail {
+
+        /*
+         * Edge ids for graphs without an edge index property, assigned in the order of
+         * boost::edges(). Copies share the same table.
+         */
+        template<class Graph>
+        class HashEdgeIndexMap: public boost::put_get_helper<std::size_t, HashEdgeIndexMap<Graph>> {
+        public:
+            typedef typename boost::graph_traits<Graph>::edge_descriptor key_type;
+            typedef std::size_t value_type;
+            typedef std::size_t reference;
+            typedef boost::readable_property_map_tag category;
+
+            HashEdgeIndexMap() {
+            }
+
+            explicit HashEdgeIndexMap(const Graph &g) :
+                    ids(build(g)) {
+            }
+
+            std::size_t operator[](const key_type &e) const {
+                return ids->at(e);
+            }
+
+        private:
+            typedef std::unordered_map<key_type, std::size_t, boost::hash<key_type>> Table;
+
+            static std::shared_ptr<const Table> build(const Graph &g) {
+                auto table = std::make_shared<Table>();
+                table->reserve(boost::num_edges(g));
+                std::size_t id = 0;
+                for (const auto &e : boost::make_iterator_range(boost::edges(g))) {
+                    table->emplace(e, id++);
+                }
+                return table;
+            }
+
+            std::shared_ptr<const Table> ids;
+        };
+
+        template<class EdgeIndexMap>
+        struct MarkEdgeFunctor {
+            std::vector<bool> *marked;
+            const EdgeIndexMap *edge_index;
+
+            template<class Edge>
+            void operator()(const Edge &e) const {
+                (*marked)[boost::get(*edge_index, e)] = true;
+            }
+        };
+
+        /*
+         * The edge index used by a forest index when none is supplied.
+         */
+        template<class Graph>
+        struct ForestIndexDefaultEdgeIndex {
+            typedef HashEdgeIndexMap<Graph> type;
+
+            static type make(const Graph &g) {
+                return type(g);
+            }
+        };
+
+        template<>
+        struct ForestIndexDefaultEdgeIndex<CSRGraph> {
+            typedef CSREdgeIndexMap type;
+
+            static type make(const CSRGraph&) {
+                return type();
+            }
+        };
+
+    } // detail
+
+    /*
+     * Dense ids of the edges of a graph. The edges not on a spanning forest get the ids
+     * [0, cycle_space_dimension()) and the forest edges the remaining ones. Lookups go through
+     * a contiguous edge index, either the one of the graph or a user supplied map with values
+     * in [0, m).
+     */
+    template<class Graph, class EdgeIndexMap = typename parmcb::detail::ForestIndexDefaultEdgeIndex<Graph>::type>
     class ForestIndex {
 
     public:
         typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
         typedef typename std::size_t size_type;
 
-        explicit ForestIndex(const Graph &g) {
-            create_index(g);
+        explicit ForestIndex(const Graph &g, bool parallel = false) :
+                edge_index(parmcb::detail::ForestIndexDefaultEdgeIndex<Graph>::make(g)) {
+            create_index(g, parallel);
         }
 
-        ForestIndex(const ForestIndex &ei) {
-            n = ei.n;
-            m = ei.m;
-            k = ei.k;
-            index = ei.index;
-            reverse_index = ei.reverse_index;
-        }
-
-        ~ForestIndex(void) {
-        }
-
-        ForestIndex& operator=(const ForestIndex &ei) {
-            if (this == &ei) {
-                return *this;
-            }
-            n = ei.n;
-            m = ei.m;
-            k = ei.k;
-            index = ei.index;
-            reverse_index = ei.reverse_index;
-            return *this;
+        ForestIndex(const Graph &g, const EdgeIndexMap &edge_index, bool parallel = false) :
+                edge_index(edge_index) {
+            create_index(g, parallel);
         }
 
         const Edge& operator()(const size_type &i) const {
@@ -59,11 +127,11 @@ namespace parmcb {
         }
 
         const size_type& operator()(const Edge &e) const {
-            return index.at(e);
+            return index[boost::get(edge_index, e)];
         }
 
         bool is_on_forest(const Edge &e) const {
-            return index.at(e) >= cycle_space_dimension();
+            return (*this)(e) >= cycle_space_dimension();
         }
 
         size_type cycle_space_dimension() const {
@@ -75,36 +143,46 @@ namespace parmcb {
         }
 
     private:
-        typedef typename boost::graph_traits<Graph>::edge_iterator EdgeIt;
-
         size_type n = 0;
         size_type m = 0;
         size_type k = 0;
-        std::map<Edge, size_type> index;
+        EdgeIndexMap edge_index;
+        std::vector<size_type> index;
         std::vector<Edge> reverse_index;
 
-        void create_index(const Graph &g) {
-            std::set<Edge> forest;
+        void create_index(const Graph &g, bool parallel) {
             n = boost::num_vertices(g);
             m = boost::num_edges(g);
-            k = parmcb::detail::spanning_forest(g, std::inserter(forest, forest.begin()));
 
-            index.clear();
+            std::vector<bool> forest(m, false);
+            auto mark_forest = boost::make_function_output_iterator(
+                    parmcb::detail::MarkEdgeFunctor<EdgeIndexMap> { &forest, &edge_index });
+#ifdef PARMCB_HAVE_TBB
+            if (parallel) {
+                k = parmcb::detail::spanning_forest_tbb(g, mark_forest);
+            } else {
+                k = parmcb::detail::spanning_forest(g, mark_forest);
+            }
+#else
+            (void) parallel;
+            k = parmcb::detail::spanning_forest(g, mark_forest);
+#endif
+
+            index.resize(m);
             reverse_index.resize(m);
 
             size_type csd = m - n + k; // cycle space dimension
             size_type low = 0;
             size_type high = csd;
 
-            EdgeIt ei, eiend;
-            for (boost::tie(ei, eiend) = boost::edges(g); ei != eiend; ++ei) {
-                auto e = *ei;
-                if (forest.find(e) == forest.end()) {
-                    index[e] = low;
+            for (const auto &e : boost::make_iterator_range(boost::edges(g))) {
+                auto id = boost::get(edge_index, e);
+                if (!forest[id]) {
+                    index[id] = low;
                     reverse_index[low] = e;
                     low++;
                 } else {
-                    index[e] = high;
+                    index[id] = high;
                     reverse_index[high] = e;
                     high++;
                 }
@@ -113,6 +191,37 @@ namespace parmcb {
 
     };
 
+    namespace detail {
+
+        template<class Graph>
+        struct ForestIndexEdgeIdFunctor {
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+
+            const ForestIndex<Graph> *forest_index;
+
+            explicit ForestIndexEdgeIdFunctor(const ForestIndex<Graph> &forest_index) :
+                    forest_index(&forest_index) {
+            }
+
+            std::size_t operator()(const Edge &e) const {
+                return (*forest_index)(e);
+            }
+        };
+
+    } // detail
+
+    /*
+     * Readable property map from edges to their dense id in a forest index.
+     */
+    template<class Graph>
+    using ForestIndexEdgeIdMap = boost::function_property_map<parmcb::detail::ForestIndexEdgeIdFunctor<Graph>,
+            typename boost::graph_traits<Graph>::edge_descriptor, std::size_t>;
+
+    template<class Graph>
+    ForestIndexEdgeIdMap<Graph> make_forest_index_edge_id_map(const ForestIndex<Graph> &forest_index) {
+        return ForestIndexEdgeIdMap<Graph>(parmcb::detail::ForestIndexEdgeIdFunctor<Graph>(forest_index));
+    }
+
 } // namespace parmcb
 
 #endif
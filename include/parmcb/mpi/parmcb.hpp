@@ -10,3 +10,4 @@
 #endif
 
 #include <parmcb/mpi/parmcb_sva_trees.hpp>
+#include <parmcb/mpi/parmcb_bcc_sva.hpp>
@@ -0,0 +1,124 @@
+#ifndef PARMCB_MPI_BCC_SVA_HPP_
+#define PARMCB_MPI_BCC_SVA_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include <parmcb/config.hpp>
+#include <parmcb/detail/biconnected.hpp>
+#include <parmcb/parmcb_approx_sva_signed.hpp>
+#include <parmcb/parmcb_approx_sva_trees.hpp>
+
+namespace parmcb {
+
+    /*
+     * Solves the biconnected components on different ranks. Blocks are assigned to the least
+     * loaded rank by decreasing size, the cycles are gathered at rank 0 and reported there in
+     * block order. All ranks return the weight of the basis.
+     */
+    template<template<class, class, class > class ExactAlgorithm, class Graph, class WeightMap,
+            class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type _bcc_mcb_mpi(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, boost::mpi::communicator &world) {
+
+        typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+        typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+        typedef parmcb::detail::BiconnectedBlocks<Graph, WeightMap> Blocks;
+        typedef std::list<std::list<parmcb::detail::CSREdge>> BlockCycles;
+        typedef ExactAlgorithm<parmcb::detail::CSRGraph, typename Blocks::BlockWeightMap,
+                std::back_insert_iterator<BlockCycles>> BlockAlgorithm;
+
+        Blocks blocks(g, weight_map);
+        std::size_t ranks = world.size();
+
+        // same assignment on all ranks, edges times dimension estimates the cost of a block
+        std::vector<std::size_t> owner(blocks.size());
+        std::vector<std::size_t> load(ranks, 0);
+        for (std::size_t i = 0; i < blocks.size(); i++) {
+            std::size_t r = std::min_element(load.begin(), load.end()) - load.begin();
+            owner[i] = r;
+            load[r] += boost::num_edges(blocks[i].graph) * blocks[i].cycle_space_dimension();
+        }
+
+        // local cycles encoded as cycle length followed by the block edge ids
+        std::vector<std::size_t> local;
+        for (std::size_t i = 0; i < blocks.size(); i++) {
+            if (owner[i] != static_cast<std::size_t>(world.rank())) {
+                continue;
+            }
+            BlockCycles cycles;
+            BlockAlgorithm exact_mcb_algo;
+            exact_mcb_algo(blocks[i].graph, blocks[i].weight_map(), std::back_inserter(cycles));
+            for (const auto &c : cycles) {
+                local.push_back(c.size());
+                for (const auto &e : c) {
+                    local.push_back(e.id);
+                }
+            }
+        }
+
+        WeightType mcb_weight = WeightType();
+        if (world.rank() == 0) {
+            std::vector<std::vector<std::size_t>> all;
+            boost::mpi::gather(world, local, all, 0);
+
+            std::vector<std::size_t> pos(ranks, 0);
+            for (std::size_t i = 0; i < blocks.size(); i++) {
+                const auto &block = blocks[i];
+                const auto &encoded = all[owner[i]];
+                std::size_t &p = pos[owner[i]];
+                for (std::size_t k = 0; k < block.cycle_space_dimension(); k++) {
+                    std::size_t length = encoded[p++];
+                    std::list<Edge> cycle;
+                    for (std::size_t j = 0; j < length; j++) {
+                        std::size_t id = encoded[p++];
+                        cycle.push_back(block.edges[id]);
+                        mcb_weight += block.weights[id];
+                    }
+                    *out++ = cycle;
+                }
+            }
+        } else {
+            boost::mpi::gather(world, local, 0);
+        }
+        boost::mpi::broadcast(world, mcb_weight, 0);
+
+        return mcb_weight;
+    }
+
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type bcc_mcb_sva_signed_mpi(const Graph &g,
+            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world) {
+        return _bcc_mcb_mpi<parmcb::detail::mcb_sva_signed>(g, weight_map, out, world);
+    }
+
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type bcc_mcb_sva_fvs_trees_mpi(const Graph &g,
+            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world) {
+        return _bcc_mcb_mpi<parmcb::detail::mcb_sva_fvs_trees>(g, weight_map, out, world);
+    }
+
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type bcc_mcb_sva_iso_trees_mpi(const Graph &g,
+            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world) {
+        return _bcc_mcb_mpi<parmcb::detail::mcb_sva_iso_trees>(g, weight_map, out, world);
+    }
+
+} // namespace mcb
+
+#endif
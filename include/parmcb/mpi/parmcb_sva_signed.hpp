@@ -6,6 +6,7 @@
 //    (See accompanying file LICENSE_1_0.txt or copy at
 //          https://www.boost.org/LICENSE_1_0.txt)
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <iostream>
@@ -23,13 +24,18 @@
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/timer.hpp>
 
-#include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_reduce.h>
 
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/detail/edge_bitmap.hpp>
+#include <parmcb/detail/search_strategy.hpp>
 #include <parmcb/detail/signed_dijkstra.hpp>
 #include <parmcb/mpi/sptrees.hpp>
+#include <parmcb/mpi/support_vectors.hpp>
+#include <parmcb/execution_context.hpp>
 #include <parmcb/forestindex.hpp>
 #include <parmcb/spvecgf2.hpp>
 #include <parmcb/util.hpp>
@@ -38,14 +44,21 @@ namespace parmcb {
 
     namespace detail {
 
+        /*
+         * The searches of the chosen mode are split among the ranks, local_share receives the
+         * fraction which ran on this rank. The cycle is returned at rank 0, or at all ranks if
+         * all_ranks is set.
+         */
         template<class Graph, class WeightMap>
         std::tuple<std::set<typename boost::graph_traits<Graph>::edge_descriptor>,
                 typename boost::property_traits<WeightMap>::value_type, bool> find_shortest_odd_cycle_mpi(
                 const Graph &g, const WeightMap &weight_map,
                 const std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> &allVertices,
                 const ForestIndex<Graph> &forest_index,
-                const std::set<typename boost::graph_traits<Graph>::edge_descriptor> &signed_edges,
-                boost::mpi::communicator &world) {
+                const SpVecGF2<std::size_t> &support, EdgeRanks &signed_edges,
+                tbb::enumerable_thread_specific<SignedDijkstraWorkspace<Graph, WeightMap>> &workspaces,
+                signed_search_mode mode, double &local_share, boost::mpi::communicator &world, bool all_ranks =
+                        false) {
 
             typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
             typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
@@ -70,57 +83,33 @@ namespace parmcb {
                 return c2;
             };
 
-            if (signed_edges.size() == 1) {
-                if (world.rank() == 0) {
-                    auto se = *signed_edges.begin();
-                    auto se_v = boost::source(se, g);
-                    auto se_u = boost::target(se, g);
-                    auto res = bidirectional_signed_dijkstra(g, weight_map, std::set<Edge> { }, signed_edges, true,
-                            se_v, true, se_u, true, std::get<2>(best), std::get<1>(best));
-                    if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
-                        std::get<1>(res) += boost::get(weight_map, se);
-                        if (!std::get<2>(best) || compare(std::get<1>(res), std::get<1>(best))) {
-                            std::get<0>(res).insert(se);
-                            best = res;
-                            assert(std::get<2>(best));
-                        }
-                    }
-                }
-            } else if (signed_edges.size() < boost::num_vertices(g)) {
+            auto edge_id_map = make_forest_index_edge_id_map(forest_index);
+            signed_edges.assign(support.begin(), support.end());
+
+            if (mode == signed_search_mode::signed_edges) {
                 /*
-                 * Heuristic in case number of signed edges is small compared to the number of vertices.
+                 * Signed edges are ordered by their forest index id, thus all ranks agree on the split.
                  */
-                std::map<Edge, std::set<Edge>> hidden_edges_per_edge;
-                std::vector<Edge> signed_edges_as_vector;
-                std::set<Edge> tmp_signed_edges = signed_edges;
-                while (!tmp_signed_edges.empty()) {
-                    auto bit = tmp_signed_edges.begin();
-                    hidden_edges_per_edge.insert(std::make_pair(*bit, tmp_signed_edges));
-                    signed_edges_as_vector.push_back(*bit);
-                    tmp_signed_edges.erase(bit);
-                }
-
-                std::vector<Edge> local_signed_edges_as_vector;
-                std::size_t total = signed_edges_as_vector.size();
+                std::size_t total = support.size();
                 std::size_t stride = ceil((double) total / world.size());
-                std::size_t istart = world.rank() * stride;
-                std::size_t iend = istart + stride;
-                for (std::size_t i = istart; i < iend && i < total; i++) {
-                    local_signed_edges_as_vector.push_back(signed_edges_as_vector[i]);
-                }
+                std::size_t istart = std::min(total, world.rank() * stride);
+                std::size_t iend = std::min(total, istart + stride);
+                local_share = total == 0 ? 0.0 : (double) (iend - istart) / total;
 
                 std::tuple<std::set<Edge>, WeightType, bool> best_local_cycle = tbb::parallel_reduce(
-                        tbb::blocked_range<std::size_t>(0, local_signed_edges_as_vector.size()),
+                        tbb::blocked_range<std::size_t>(istart, iend),
                         std::make_tuple(std::set<Edge>(), (std::numeric_limits<WeightType>::max)(), false),
                         [&](tbb::blocked_range<std::size_t> r, auto running_min) {
+                            auto &workspace = workspaces.local();
                             for (std::size_t i = r.begin(); i < r.end(); i++) {
-                                auto se = local_signed_edges_as_vector.at(i);
+                                auto se_id = *(support.begin() + i);
+                                auto se = forest_index(se_id);
                                 auto se_v = boost::source(se, g);
                                 auto se_u = boost::target(se, g);
-                                auto hidden_edges = hidden_edges_per_edge.at(se);
-                                auto res = bidirectional_signed_dijkstra(g, weight_map, signed_edges, hidden_edges,
-                                        true, se_v, true, se_u, true, std::get<2>(running_min),
-                                        std::get<1>(running_min));
+                                // signed edges at position i or later are hidden from the i-th search
+                                auto res = bidirectional_signed_dijkstra<smaller_queue_first>(g, weight_map,
+                                        edge_id_map, signed_edges, i, se_v, true, se_u, true, std::get<2>(running_min),
+                                        std::get<1>(running_min), workspace);
                                 if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
                                     std::get<1>(res) += boost::get(weight_map, se);
                                     if (!std::get<2>(running_min)
@@ -141,8 +130,13 @@ namespace parmcb {
                         std::get<1>(best_local_cycle), std::get<2>(best_local_cycle));
                 SerializableMinOddCycle<Graph, WeightMap> global_min_odd_cycle;
 
-                boost::mpi::reduce(world, local_min_odd_cycle, global_min_odd_cycle,
-                        SerializableMinOddCycleMinOp<Graph, WeightMap>(), 0);
+                if (all_ranks) {
+                    boost::mpi::all_reduce(world, local_min_odd_cycle, global_min_odd_cycle,
+                            SerializableMinOddCycleMinOp<Graph, WeightMap>());
+                } else {
+                    boost::mpi::reduce(world, local_min_odd_cycle, global_min_odd_cycle,
+                            SerializableMinOddCycleMinOp<Graph, WeightMap>(), 0);
+                }
 
                 convert_edges(global_min_odd_cycle.edges, std::inserter(std::get<0>(best), std::get<0>(best).end()),
                         forest_index);
@@ -158,17 +152,18 @@ namespace parmcb {
                 for (std::size_t i = istart; i < iend && i < total; i++) {
                     localVertices.push_back(allVertices[i]);
                 }
+                local_share = total == 0 ? 0.0 : (double) localVertices.size() / total;
 
                 std::tuple<std::set<Edge>, WeightType, bool> best_local_cycle = tbb::parallel_reduce(
                         tbb::blocked_range<std::size_t>(0, localVertices.size()),
                         std::make_tuple(std::set<Edge>(), (std::numeric_limits<WeightType>::max)(), false),
                         [&](tbb::blocked_range<std::size_t> r, auto running_min) {
+                            auto &workspace = workspaces.local();
                             for (std::size_t i = r.begin(); i < r.end(); i++) {
                                 auto v = localVertices[i];
-                                const bool use_hidden_edges = false;
-                                auto res = bidirectional_signed_dijkstra(g, weight_map, signed_edges,
-                                        std::set<Edge> { }, use_hidden_edges, v, true, v, false,
-                                        std::get<2>(running_min), std::get<1>(running_min));
+                                auto res = bidirectional_signed_dijkstra<smaller_queue_first>(g, weight_map,
+                                        edge_id_map, signed_edges, EdgeRanks::none, v, true, v, false,
+                                        std::get<2>(running_min), std::get<1>(running_min), workspace);
                                 if (std::get<2>(res)
                                         && (!std::get<2>(running_min)
                                                 || compare(std::get<1>(res), std::get<1>(running_min)))) {
@@ -186,8 +181,13 @@ namespace parmcb {
                         std::get<1>(best_local_cycle), std::get<2>(best_local_cycle));
                 SerializableMinOddCycle<Graph, WeightMap> global_min_odd_cycle;
 
-                boost::mpi::reduce(world, local_min_odd_cycle, global_min_odd_cycle,
-                        SerializableMinOddCycleMinOp<Graph, WeightMap>(), 0);
+                if (all_ranks) {
+                    boost::mpi::all_reduce(world, local_min_odd_cycle, global_min_odd_cycle,
+                            SerializableMinOddCycleMinOp<Graph, WeightMap>());
+                } else {
+                    boost::mpi::reduce(world, local_min_odd_cycle, global_min_odd_cycle,
+                            SerializableMinOddCycleMinOp<Graph, WeightMap>(), 0);
+                }
 
                 convert_edges(global_min_odd_cycle.edges, std::inserter(std::get<0>(best), std::get<0>(best).end()),
                         forest_index);
@@ -201,8 +201,9 @@ namespace parmcb {
     } // detail
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
-    typename boost::property_traits<WeightMap>::value_type mcb_sva_signed_mpi(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out, boost::mpi::communicator &world, const std::size_t hardware_concurrency_hint = 0) {
+    typename boost::property_traits<WeightMap>::value_type _mcb_sva_signed_mpi(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, boost::mpi::communicator &world,
+            support_placement placement = support_placement::root) {
 
         typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
         typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
@@ -225,12 +226,7 @@ namespace parmcb {
         /*
          * Initialize support vectors
          */
-        tbb::concurrent_vector<SpVecGF2<std::size_t>> support;
-        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, csd), [&](const tbb::blocked_range<std::size_t> &r) {
-            for (std::size_t i = r.begin(); i != r.end(); ++i) {
-                support.push_back(SpVecGF2<std::size_t> { i });
-            }
-        });
+        parmcb::detail::MPISupportVectors<true> support(csd, world, placement);
 
         boost::mpi::timer total_timer;
 
@@ -238,6 +234,10 @@ namespace parmcb {
          * Main loop
          */
         WeightType mcb_weight = WeightType();
+        tbb::enumerable_thread_specific<SignedDijkstraWorkspace<Graph, WeightMap>> workspaces(std::cref(g),
+                weight_map);
+        parmcb::detail::EdgeRanks signed_edges(boost::num_edges(g));
+        parmcb::detail::SearchStrategySelector<Graph> selector(g, forest_index);
         for (std::size_t k = 0; k < csd; k++) {
 #ifdef PARMCB_LOGGING
             if (k % 250 == 0) {
@@ -247,36 +247,39 @@ namespace parmcb {
 
             // TODO: check if sparsest support heuristic makes sense here
 
-            // broadcast support vector
+            // support vector from its owner
+            const SpVecGF2<std::size_t> &supportk = support.fetch(k);
+
+            // rank 0 chooses the search mode from its own search effort
+            int mode = 0;
             if (world.rank() == 0) {
-                boost::mpi::broadcast(world, support[k], 0);
-            } else {
-                SpVecGF2<std::size_t> received;
-                boost::mpi::broadcast(world, received, 0);
-                support[k] = received;
+                mode = static_cast<int>(selector.choose(supportk));
             }
+            boost::mpi::broadcast(world, mode, 0);
 
-            std::set<Edge> signed_edges;
-            convert_edges(support[k], std::inserter(signed_edges, signed_edges.end()), forest_index);
+            for (auto &workspace : workspaces) {
+                workspace.reset_statistics();
+            }
+            double local_share = 0.0;
             std::tuple<std::set<Edge>, WeightType, bool> best = parmcb::detail::find_shortest_odd_cycle_mpi(g, weight_map,
-                    vertices, forest_index, signed_edges, world);
-
+                    vertices, forest_index, supportk, signed_edges, workspaces,
+                    static_cast<signed_search_mode>(mode), local_share, world, support.distributed());
             if (world.rank() == 0) {
-                /*
-                 * Update support vectors
-                 */
-                std::set<std::size_t> cyclek;
-                convert_edges(std::get<0>(best), std::inserter(cyclek, cyclek.end()), forest_index);
-                tbb::parallel_for(tbb::blocked_range<std::size_t>(k + 1, csd),
-                        [&](const tbb::blocked_range<std::size_t> &r) {
-                            auto e = r.end();
-                            for (std::size_t i = r.begin(); i != e; ++i) {
-                                if (support[i] * cyclek == 1) {
-                                    support[i] += support[k];
-                                }
-                            }
-                        });
+                std::size_t scanned_edges = 0;
+                for (const auto &workspace : workspaces) {
+                    scanned_edges += workspace.scanned_edges();
+                }
+                selector.record(scanned_edges, local_share);
+            }
+
+            /*
+             * Update support vectors
+             */
+            std::set<std::size_t> cyclek;
+            convert_edges(std::get<0>(best), std::inserter(cyclek, cyclek.end()), forest_index);
+            support.update(k, cyclek);
 
+            if (world.rank() == 0) {
                 /*
                  * Output cycles
                  */
@@ -291,12 +294,32 @@ namespace parmcb {
         if (world.rank() == 0) {
 #ifdef PARMCB_LOGGING
             std::cout << "Total time: " << total_timer.elapsed() << " (sec)" << std::endl;
+            std::cout << "search modes: all vertices "
+                    << selector.statistics().count(signed_search_mode::all_vertices) << ", signed edges "
+                    << selector.statistics().count(signed_search_mode::signed_edges) << std::endl;
 #endif
         }
 
         return mcb_weight;
     }
 
+    /*
+     * Runs on an immutable CSR snapshot of the graph, cycles are reported using the edges of g.
+     * The threads of each process are given by the execution context. With the distributed
+     * placement each rank stores and updates only its share of the support vectors.
+     */
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type mcb_sva_signed_mpi(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, boost::mpi::communicator &world,
+            const execution_context &context = execution_context(), support_placement placement =
+                    support_placement::root) {
+        return parmcb::detail::execute(context, [&] {
+            parmcb::detail::CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+            auto csr_out = snapshot.cycle_output(out);
+            return _mcb_sva_signed_mpi(snapshot.graph(), snapshot.weight_map(), csr_out, world, placement);
+        });
+    }
+
 } // namespace parmcb
 
 #endif
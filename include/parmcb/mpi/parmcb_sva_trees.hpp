@@ -25,18 +25,22 @@
 #include <cmath>
 
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/forestindex.hpp>
 #include <parmcb/spvecgf2.hpp>
 #include <parmcb/detail/fvs.hpp>
 #include <parmcb/detail/cycles.hpp>
+#include <parmcb/execution_context.hpp>
 #include <parmcb/util.hpp>
 #include <parmcb/mpi/sptrees.hpp>
+#include <parmcb/mpi/support_vectors.hpp>
 
 namespace parmcb {
 
     template<class Graph, class WeightMap, class CycleOutputIterator, class CyclesBuilder, bool ParallelUsingTBB>
     typename boost::property_traits<WeightMap>::value_type _mcb_sva_trees_mpi(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out, boost::mpi::communicator &world) {
+            CycleOutputIterator out, boost::mpi::communicator &world,
+            support_placement placement = support_placement::root) {
 
         typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
         typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
@@ -58,10 +62,7 @@ namespace parmcb {
         /*
          * Initialize support vectors
          */
-        std::vector<SpVecGF2<std::size_t>> support;
-        for (std::size_t k = 0; k < csd; k++) {
-            support.emplace_back(k);
-        }
+        parmcb::detail::MPISupportVectors<ParallelUsingTBB> support(csd, world, placement);
 
         /**
          * Scatter candidate cycles
@@ -126,15 +127,20 @@ namespace parmcb {
         /*
          * Build trees for local candidate cycles
          */
+        std::vector<Vertex> sources;
+        std::vector<std::vector<Edge>> tree_edges;
+        for (auto &p : perVertexCandidates) {
+            sources.push_back(p.first);
+            tree_edges.push_back(std::move(p.second));
+        }
         std::vector<parmcb::SPTree<Graph, WeightMap>> trees;
         std::vector<parmcb::CandidateCycle<Graph, WeightMap>> cycles;
-        for (auto const &p : perVertexCandidates) {
-            SPTree<Graph, WeightMap> tree(trees.size(), g, boost::get(boost::vertex_index, g), weight_map, p.first);
-            trees.push_back(tree);
-            std::vector<CandidateCycle<Graph, WeightMap>> tree_cycles = tree.create_candidate_cycles(p.second.begin(),
-                    p.second.end());
-            cycles.insert(cycles.end(), tree_cycles.begin(), tree_cycles.end());
-        }
+        SPTrees<Graph, WeightMap, ParallelUsingTBB> builder(g, weight_map);
+        builder.build_trees(sources, trees);
+        builder.build_candidate_cycles(trees, cycles, [&](const SPTree<Graph, WeightMap> &tree) {
+            const auto &edges = tree_edges[tree.id()];
+            return tree.create_candidate_cycles(edges.begin(), edges.end());
+        });
 #ifdef PARMCB_LOGGING
         std::cout << "Total candidate cycles: " << cycles.size() << std::endl;
 #endif
@@ -147,6 +153,8 @@ namespace parmcb {
         }
         ShortestOddCycleLookup<Graph, WeightMap, ParallelUsingTBB> cycle_lookup(g, weight_map, trees, cycles,
                 sorted_cycles);
+        // the lookup keeps its own copy of the candidates
+        std::vector<parmcb::CandidateCycle<Graph, WeightMap>>().swap(cycles);
 
         /*
          * Main loop
@@ -159,19 +167,11 @@ namespace parmcb {
             }
 #endif
 
-            // broadcast support vector
-            if (world.rank() == 0) {
-                boost::mpi::broadcast(world, support[k], 0);
-            } else {
-                SpVecGF2<std::size_t> received;
-                boost::mpi::broadcast(world, received, 0);
-                support[k] = received;
-            }
-
-            //std::cout << "Rank " << world.rank() << " has support = " << support[k] << std::endl;
+            // support vector from its owner
+            const SpVecGF2<std::size_t> &supportk = support.fetch(k);
 
             std::set<Edge> signed_edges;
-            convert_edges(support[k], std::inserter(signed_edges, signed_edges.end()), forest_index);
+            convert_edges(supportk, std::inserter(signed_edges, signed_edges.end()), forest_index);
 
             std::tuple<std::set<Edge>, WeightType, bool> best_local_cycle = cycle_lookup(signed_edges);
 
@@ -182,20 +182,19 @@ namespace parmcb {
                     std::get<1>(best_local_cycle), std::get<2>(best_local_cycle));
             SerializableMinOddCycle<Graph, WeightMap> global_min_odd_cycle;
 
-            boost::mpi::reduce(world, local_min_odd_cycle, global_min_odd_cycle,
-                    SerializableMinOddCycleMinOp<Graph, WeightMap>(), 0);
+            // with distributed support vectors every rank updates its own with the cycle
+            if (support.distributed()) {
+                boost::mpi::all_reduce(world, local_min_odd_cycle, global_min_odd_cycle,
+                        SerializableMinOddCycleMinOp<Graph, WeightMap>());
+            } else {
+                boost::mpi::reduce(world, local_min_odd_cycle, global_min_odd_cycle,
+                        SerializableMinOddCycleMinOp<Graph, WeightMap>(), 0);
+            }
 
-            if (world.rank() == 0) {
-                std::set<std::size_t> cyclek;
-                for (std::size_t e : global_min_odd_cycle.edges) {
-                    cyclek.insert(e);
-                }
-                for (std::size_t l = k + 1; l < csd; l++) {
-                    if (support[l] * cyclek == 1) {
-                        support[l] += support[k];
-                    }
-                }
+            std::set<std::size_t> cyclek(global_min_odd_cycle.edges.begin(), global_min_odd_cycle.edges.end());
+            support.update(k, cyclek);
 
+            if (world.rank() == 0) {
                 std::list<Edge> cyclek_edgelist;
                 convert_edges(global_min_odd_cycle.edges, std::inserter(cyclek_edgelist, cyclek_edgelist.end()),
                         forest_index);
@@ -214,32 +213,61 @@ namespace parmcb {
 
     }
 
+    /*
+     * Runs on an immutable CSR snapshot of the graph, cycles are reported using the edges of g.
+     * With the distributed placement each rank stores and updates only its share of the support
+     * vectors.
+     */
+    template<template<class, class, bool > class CyclesBuilder, bool ParallelUsingTBB, class Graph, class WeightMap,
+            class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type _mcb_sva_trees_snapshot_mpi(const Graph &g,
+            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world,
+            support_placement placement) {
+        typedef parmcb::detail::CSRSnapshot<Graph, WeightMap> Snapshot;
+        typedef typename Snapshot::CSRWeightMap CSRWeightMap;
+        Snapshot snapshot(g, weight_map);
+        auto csr_out = snapshot.cycle_output(out);
+        return _mcb_sva_trees_mpi<parmcb::detail::CSRGraph, CSRWeightMap, decltype(csr_out),
+                CyclesBuilder<parmcb::detail::CSRGraph, CSRWeightMap, ParallelUsingTBB>, ParallelUsingTBB>(snapshot.graph(),
+                snapshot.weight_map(), csr_out, world, placement);
+    }
+
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_fvs_trees_mpi(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out, boost::mpi::communicator &world) {
-        return _mcb_sva_trees_mpi<Graph, WeightMap, CycleOutputIterator,
-                parmcb::detail::FVSCyclesBuilder<Graph, WeightMap>, false>(g, weight_map, out, world);
+            CycleOutputIterator out, boost::mpi::communicator &world,
+            support_placement placement = support_placement::root) {
+        return _mcb_sva_trees_snapshot_mpi<parmcb::detail::FVSCyclesBuilder, false>(g, weight_map, out, world,
+                placement);
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_fvs_trees_tbb_mpi(const Graph &g,
-            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world) {
-        return _mcb_sva_trees_mpi<Graph, WeightMap, CycleOutputIterator,
-                parmcb::detail::FVSCyclesBuilder<Graph, WeightMap>, true>(g, weight_map, out, world);
+            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world,
+            const execution_context &context = execution_context(), support_placement placement =
+                    support_placement::root) {
+        return parmcb::detail::execute(context, [&] {
+            return _mcb_sva_trees_snapshot_mpi<parmcb::detail::FVSCyclesBuilder, true>(g, weight_map, out, world,
+                    placement);
+        });
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_iso_trees_mpi(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out, boost::mpi::communicator &world) {
-        return _mcb_sva_trees_mpi<Graph, WeightMap, CycleOutputIterator,
-                parmcb::detail::ISOCyclesBuilder<Graph, WeightMap>, false>(g, weight_map, out, world);
+            CycleOutputIterator out, boost::mpi::communicator &world,
+            support_placement placement = support_placement::root) {
+        return _mcb_sva_trees_snapshot_mpi<parmcb::detail::ISOCyclesBuilder, false>(g, weight_map, out, world,
+                placement);
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_iso_trees_tbb_mpi(const Graph &g,
-            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world) {
-        return _mcb_sva_trees_mpi<Graph, WeightMap, CycleOutputIterator,
-                parmcb::detail::ISOCyclesBuilder<Graph, WeightMap>, true>(g, weight_map, out, world);
+            WeightMap weight_map, CycleOutputIterator out, boost::mpi::communicator &world,
+            const execution_context &context = execution_context(), support_placement placement =
+                    support_placement::root) {
+        return parmcb::detail::execute(context, [&] {
+            return _mcb_sva_trees_snapshot_mpi<parmcb::detail::ISOCyclesBuilder, true>(g, weight_map, out, world,
+                    placement);
+        });
     }
 
 } // namespace mcb
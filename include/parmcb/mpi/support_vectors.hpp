@@ -0,0 +1,213 @@
+#ifndef PARMCB_MPI_SUPPORT_VECTORS_HPP_
+#define PARMCB_MPI_SUPPORT_VECTORS_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <set>
+#include <vector>
+
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/request.hpp>
+#include <boost/mpi/nonblocking.hpp>
+
+#include <parmcb/config.hpp>
+#include <parmcb/spvecgf2.hpp>
+
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
+namespace parmcb {
+
+    /*
+     * Where the support vectors of the MPI algorithms are kept.
+     */
+    enum class support_placement {
+        // rank 0 stores and updates all support vectors
+        root,
+        // vector l is stored and updated by rank l mod the number of ranks
+        distributed
+    };
+
+    namespace detail {
+
+        /*
+         * The support vectors of the MPI algorithms. Each vector is owned by a single rank, which
+         * keeps it up to date, and vector k is sent by its owner to all other ranks at iteration k.
+         *
+         * After cycle k is known the owner of vector k + 1 updates it first and sends it, while the
+         * ranks update the rest of their vectors, so the transfer overlaps with the update. With
+         * the distributed placement both the memory and the update work of the vectors are divided
+         * among the ranks, which then all need cycle k.
+         */
+        template<bool ParallelUsingTBB>
+        class MPISupportVectors {
+        public:
+            typedef SpVecGF2<std::size_t> vector_type;
+
+            MPISupportVectors(std::size_t csd, const boost::mpi::communicator &world, support_placement placement =
+                    support_placement::root) :
+                    csd(csd), placement(placement), comm(world, boost::mpi::comm_duplicate), rank(world.rank()), ranks(
+                            world.size()), pending(csd) {
+                for (std::size_t l = first_owned(0); l < csd; l = first_owned(l + 1)) {
+                    local.emplace_back(l);
+                }
+            }
+
+            MPISupportVectors(const MPISupportVectors &other) = delete;
+            MPISupportVectors& operator=(const MPISupportVectors &other) = delete;
+
+            ~MPISupportVectors() {
+                boost::mpi::wait_all(requests.begin(), requests.end());
+            }
+
+            /*
+             * Whether every rank updates vectors and therefore needs each cycle.
+             */
+            bool distributed() const {
+                return placement == support_placement::distributed && ranks > 1;
+            }
+
+            /*
+             * Number of vectors stored at this rank.
+             */
+            std::size_t stored() const {
+                return local.size();
+            }
+
+            /*
+             * Vector k on all ranks, valid until update(k) returns.
+             */
+            const vector_type& fetch(std::size_t k) {
+                if (pending != k) {
+                    transfer(k);
+                }
+                boost::mpi::wait_all(requests.begin(), requests.end());
+                requests.clear();
+                pending = csd;
+                if (owner(k) == rank) {
+                    return local[index(k)];
+                }
+                return received[k % 2];
+            }
+
+            /*
+             * Record cycle k, given by its edge ids, and update the vectors after k owned by this
+             * rank. Vector k must have been fetched.
+             */
+            void update(std::size_t k, const std::set<std::size_t> &cyclek) {
+                const vector_type &sk = owner(k) == rank ? local[index(k)] : received[k % 2];
+                std::size_t next = k + 1;
+                if (next < csd) {
+                    if (owner(next) == rank) {
+                        vector_type &s = local[index(next)];
+                        if (s * cyclek == 1) {
+                            s += sk;
+                        }
+                    }
+                    transfer(next);
+                }
+
+                std::size_t first = first_owned(next + 1);
+                if (first >= csd) {
+                    return;
+                }
+                add_where_odd(sk, index(first), local.size(), cyclek);
+            }
+
+        private:
+            int owner(std::size_t l) const {
+                if (placement == support_placement::root) {
+                    return 0;
+                }
+                return static_cast<int>(l % static_cast<std::size_t>(ranks));
+            }
+
+            /*
+             * First vector at or after l owned by this rank, csd if none.
+             */
+            std::size_t first_owned(std::size_t l) const {
+                if (l >= csd) {
+                    return csd;
+                }
+                if (placement == support_placement::root) {
+                    return rank == 0 ? l : csd;
+                }
+                std::size_t p = static_cast<std::size_t>(ranks);
+                std::size_t first = l + (static_cast<std::size_t>(rank) + p - l % p) % p;
+                return first < csd ? first : csd;
+            }
+
+            std::size_t index(std::size_t l) const {
+                if (placement == support_placement::root) {
+                    return l;
+                }
+                return l / static_cast<std::size_t>(ranks);
+            }
+
+            /*
+             * Start sending vector k from its owner, received in the buffer of k's parity.
+             */
+            void transfer(std::size_t k) {
+                const int tag = 0;
+                int from = owner(k);
+                if (from == rank) {
+                    for (int r = 0; r < ranks; r++) {
+                        if (r != rank) {
+                            requests.push_back(comm.isend(r, tag, local[index(k)]));
+                        }
+                    }
+                } else {
+                    requests.push_back(comm.irecv(from, tag, received[k % 2]));
+                }
+                pending = k;
+            }
+
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void add_where_odd(const vector_type &sk, std::size_t first, std::size_t last,
+                    const std::set<std::size_t> &cyclek, typename std::enable_if<!is_tbb_enabled>::type* = 0) {
+                for (std::size_t i = first; i < last; i++) {
+                    if (local[i] * cyclek == 1) {
+                        local[i] += sk;
+                    }
+                }
+            }
+
+#ifdef PARMCB_HAVE_TBB
+            template<bool is_tbb_enabled = ParallelUsingTBB>
+            void add_where_odd(const vector_type &sk, std::size_t first, std::size_t last,
+                    const std::set<std::size_t> &cyclek, typename std::enable_if<is_tbb_enabled>::type* = 0) {
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(first, last),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            for (std::size_t i = r.begin(); i != r.end(); ++i) {
+                                if (local[i] * cyclek == 1) {
+                                    local[i] += sk;
+                                }
+                            }
+                        });
+            }
+#endif
+
+            const std::size_t csd;
+            const support_placement placement;
+            boost::mpi::communicator comm;
+            const int rank;
+            const int ranks;
+            // vectors owned by this rank, in increasing order
+            std::vector<vector_type> local;
+            // vectors of other ranks, two buffers so that k + 1 arrives while k is in use
+            vector_type received[2];
+            std::vector<boost::mpi::request> requests;
+            // vector whose transfer has started, csd if none
+            std::size_t pending;
+        };
+
+    } // detail
+
+} // parmcb
+
+#endif
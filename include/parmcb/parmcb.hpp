@@ -7,11 +7,20 @@
 
 #include <parmcb/parmcb_sva_signed.hpp>
 #include <parmcb/parmcb_sva_trees.hpp>
+#include <parmcb/parmcb_sva_hybrid.hpp>
 #include <parmcb/parmcb_approx_sva_signed.hpp>
 #include <parmcb/parmcb_approx_sva_trees.hpp>
+#include <parmcb/parmcb_bcc_sva_signed.hpp>
+#include <parmcb/parmcb_bcc_sva_trees.hpp>
+#include <parmcb/parmcb_reduced_sva_signed.hpp>
+#include <parmcb/parmcb_reduced_sva_trees.hpp>
 
 #ifdef PARMCB_HAVE_TBB
     #include <parmcb/parmcb_sva_signed_tbb.hpp>
     #include <parmcb/parmcb_approx_sva_signed_tbb.hpp>
     #include <parmcb/parmcb_approx_sva_trees_tbb.hpp>
+    #include <parmcb/parmcb_bcc_sva_signed_tbb.hpp>
+    #include <parmcb/parmcb_bcc_sva_trees_tbb.hpp>
+    #include <parmcb/parmcb_reduced_sva_signed_tbb.hpp>
+    #include <parmcb/parmcb_reduced_sva_trees_tbb.hpp>
 #endif
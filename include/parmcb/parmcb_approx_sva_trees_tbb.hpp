@@ -34,25 +34,25 @@ struct mcb_sva_iso_trees_tbb{
 template<class Graph, class WeightMap, class CycleOutputIterator>
 typename boost::property_traits<WeightMap>::value_type approx_mcb_sva_fvs_trees_tbb(
         const Graph &g, const WeightMap &weight, std::size_t k,
-        CycleOutputIterator out, const std::size_t hardware_concurrency_hint = 0) {
-
-    // TODO: support calling with hardware_concurrency_hint
+        CycleOutputIterator out, const execution_context &context = execution_context()) {
 
     typedef typename parmcb::detail::mcb_sva_fvs_trees_tbb<Graph,WeightMap,CycleOutputIterator> ExactAlgo;
-    parmcb::detail::BaseApproxSpannerAlgorithm<Graph, WeightMap, ExactAlgo, true> algo(g, weight, boost::get(boost::vertex_index, g), k);
-    return algo.run(out);
+    return parmcb::detail::execute(context, [&] {
+        parmcb::detail::BaseApproxSpannerAlgorithm<Graph, WeightMap, ExactAlgo, true> algo(g, weight, boost::get(boost::vertex_index, g), k);
+        return algo.run(out);
+    });
 }
 
 template<class Graph, class WeightMap, class CycleOutputIterator>
 typename boost::property_traits<WeightMap>::value_type approx_mcb_sva_iso_trees_tbb(
         const Graph &g, const WeightMap &weight, std::size_t k,
-        CycleOutputIterator out, const std::size_t hardware_concurrency_hint = 0) {
-
-    // TODO: support calling with hardware_concurrency_hint
+        CycleOutputIterator out, const execution_context &context = execution_context()) {
 
     typedef typename parmcb::detail::mcb_sva_iso_trees_tbb<Graph,WeightMap,CycleOutputIterator> ExactAlgo;
-    parmcb::detail::BaseApproxSpannerAlgorithm<Graph, WeightMap, ExactAlgo, true> algo(g, weight, boost::get(boost::vertex_index, g), k);
-    return algo.run(out);
+    return parmcb::detail::execute(context, [&] {
+        parmcb::detail::BaseApproxSpannerAlgorithm<Graph, WeightMap, ExactAlgo, true> algo(g, weight, boost::get(boost::vertex_index, g), k);
+        return algo.run(out);
+    });
 }
 
 } // parmcb
@@ -0,0 +1,27 @@
+#ifndef PARMCB_BCC_SVA_SIGNED_TBB_HPP_
+#define PARMCB_BCC_SVA_SIGNED_TBB_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2023.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <parmcb/detail/biconnected.hpp>
+#include <parmcb/parmcb_approx_sva_signed_tbb.hpp>
+
+namespace parmcb {
+
+template<class Graph, class WeightMap, class CycleOutputIterator>
+typename boost::property_traits<WeightMap>::value_type bcc_mcb_sva_signed_tbb(
+        const Graph &g, const WeightMap &weight, CycleOutputIterator out,
+        const execution_context &context = execution_context()) {
+
+    return parmcb::detail::execute(context, [&] {
+        parmcb::detail::BaseBiconnectedAlgorithm<Graph, WeightMap, parmcb::detail::mcb_sva_signed_tbb, true> algo(g, weight);
+        return algo.run(out);
+    });
+}
+
+} // parmcb
+
+#endif
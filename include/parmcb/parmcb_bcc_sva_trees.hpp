@@ -0,0 +1,32 @@
+#ifndef PARMCB_BCC_SVA_TREES_HPP_
+#define PARMCB_BCC_SVA_TREES_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2023.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <parmcb/detail/biconnected.hpp>
+#include <parmcb/parmcb_approx_sva_trees.hpp>
+
+namespace parmcb {
+
+template<class Graph, class WeightMap, class CycleOutputIterator>
+typename boost::property_traits<WeightMap>::value_type bcc_mcb_sva_fvs_trees(
+        const Graph &g, const WeightMap &weight, CycleOutputIterator out) {
+
+    parmcb::detail::BaseBiconnectedAlgorithm<Graph, WeightMap, parmcb::detail::mcb_sva_fvs_trees, false> algo(g, weight);
+    return algo.run(out);
+}
+
+template<class Graph, class WeightMap, class CycleOutputIterator>
+typename boost::property_traits<WeightMap>::value_type bcc_mcb_sva_iso_trees(
+        const Graph &g, const WeightMap &weight, CycleOutputIterator out) {
+
+    parmcb::detail::BaseBiconnectedAlgorithm<Graph, WeightMap, parmcb::detail::mcb_sva_iso_trees, false> algo(g, weight);
+    return algo.run(out);
+}
+
+} // parmcb
+
+#endif
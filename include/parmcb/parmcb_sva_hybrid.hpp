@@ -0,0 +1,402 @@
+#ifndef PARMCB_SVA_HYBRID_HPP_
+#define PARMCB_SVA_HYBRID_HPP_
+
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/tuple/detail/tuple_basic.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <set>
+#include <vector>
+
+#include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/detail/fvs.hpp>
+#include <parmcb/detail/support_vectors.hpp>
+#include <parmcb/execution_context.hpp>
+#include <parmcb/forestindex.hpp>
+#include <parmcb/parmcb_sva_signed.hpp>
+#include <parmcb/sptrees.hpp>
+#include <parmcb/spvecgf2.hpp>
+#include <parmcb/util.hpp>
+
+#ifdef PARMCB_HAVE_TBB
+#include <parmcb/parmcb_sva_signed_tbb.hpp>
+#endif
+
+namespace parmcb {
+
+    /*
+     * Memory in bytes for the shortest path trees and candidate cycles of the hybrid algorithm.
+     */
+    constexpr std::size_t DEFAULT_HYBRID_MEMORY_BUDGET = std::size_t(1) << 28;
+
+    /*
+     * Per iteration counts of the methods used by the hybrid algorithm.
+     */
+    struct hybrid_statistics {
+        // iterations which queried the candidate cycles
+        std::size_t lookups = 0;
+        // lookups which found an odd candidate cycle
+        std::size_t hits = 0;
+        // iterations answered by the lookup alone
+        std::size_t lookup_answers = 0;
+        // iterations which ran the signed graph searches bounded by a lookup hit
+        std::size_t bounded_searches = 0;
+        // iterations which ran the signed graph searches without a bound
+        std::size_t searches = 0;
+    };
+
+    namespace detail {
+
+        /*
+         * Approximate memory per vertex of a shortest path tree and per candidate cycle.
+         */
+        constexpr std::size_t HYBRID_BYTES_PER_ENTRY = 64;
+
+        /*
+         * Chooses per iteration between the candidate lookup, followed by signed graph searches
+         * when its answer is not known to be exact, and the signed graph searches alone. Both
+         * are estimated by exponential moving averages of their measured wall clock time, the
+         * searches per Dijkstra so that the estimate scales with the support vector. The method
+         * not chosen is tried again every explore_interval iterations to keep its estimate current.
+         */
+        class HybridCostModel {
+        public:
+            enum class method {
+                lookup, search
+            };
+
+            explicit HybridCostModel(bool lookup_available) :
+                    lookup_available(lookup_available) {
+            }
+
+            method choose(std::size_t searches) {
+                iterations++;
+                if (!lookup_available) {
+                    return method::search;
+                }
+                if (lookup_samples == 0) {
+                    return method::lookup;
+                }
+                if (search_samples == 0) {
+                    return method::search;
+                }
+                double verify_per_search = bounded_samples > 0 ? bounded_per_search : search_per_search;
+                double lookup_cost = lookup_time + verify_rate * verify_per_search * searches;
+                double search_cost = search_per_search * searches;
+                method preferred = lookup_cost <= search_cost ? method::lookup : method::search;
+                if (iterations % explore_interval == 0) {
+                    return preferred == method::lookup ? method::search : method::lookup;
+                }
+                return preferred;
+            }
+
+            void record_lookup(double seconds, bool verified) {
+                update(lookup_time, seconds, lookup_samples);
+                update(verify_rate, verified ? 1.0 : 0.0, verify_samples);
+            }
+
+            void record_search(std::size_t searches, double seconds, bool bounded) {
+                double per_search = seconds / (std::max)(searches, std::size_t(1));
+                if (bounded) {
+                    update(bounded_per_search, per_search, bounded_samples);
+                } else {
+                    update(search_per_search, per_search, search_samples);
+                }
+            }
+
+        private:
+            static constexpr double alpha = 0.25;
+            static constexpr std::size_t explore_interval = 32;
+
+            static void update(double &average, double value, std::size_t &samples) {
+                average = samples == 0 ? value : (1.0 - alpha) * average + alpha * value;
+                samples++;
+            }
+
+            const bool lookup_available;
+            std::size_t iterations = 0;
+            double lookup_time = 0.0;
+            double verify_rate = 0.0;
+            double bounded_per_search = 0.0;
+            double search_per_search = 0.0;
+            std::size_t lookup_samples = 0;
+            std::size_t verify_samples = 0;
+            std::size_t bounded_samples = 0;
+            std::size_t search_samples = 0;
+        };
+
+        /*
+         * Signed graph searches of the hybrid algorithm, seeded with an odd cycle whose weight
+         * bounds them. The seed is returned unless a strictly lighter cycle exists.
+         */
+        template<class Graph, class WeightMap, bool ParallelUsingTBB>
+        class HybridSignedSearch;
+
+        template<class Graph, class WeightMap>
+        class HybridSignedSearch<Graph, WeightMap, false> {
+        public:
+            typedef typename SignedOddCycleSearch<Graph, WeightMap>::Cycle Cycle;
+
+            HybridSignedSearch(const Graph &g, const WeightMap &weight_map, const ForestIndex<Graph> &forest_index) :
+                    search(g, weight_map, forest_index) {
+            }
+
+            std::size_t searches(const SpVecGF2<std::size_t> &support) const {
+                return search.searches(support);
+            }
+
+            Cycle find(const SpVecGF2<std::size_t> &support, const Cycle &seed) {
+                Cycle best = seed;
+                search.assign(support);
+                search.find(support, best, [](const Cycle&) {
+                });
+                return best;
+            }
+
+        private:
+            SignedOddCycleSearch<Graph, WeightMap> search;
+        };
+
+#ifdef PARMCB_HAVE_TBB
+        template<class Graph, class WeightMap>
+        class HybridSignedSearch<Graph, WeightMap, true> {
+        public:
+            typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef std::tuple<std::set<Edge>, WeightType, bool> Cycle;
+
+            HybridSignedSearch(const Graph &g, const WeightMap &weight_map, const ForestIndex<Graph> &forest_index) :
+                    vertices(boost::vertices(g).first, boost::vertices(g).second), finder(g, weight_map, forest_index,
+                            vertices) {
+            }
+
+            std::size_t searches(const SpVecGF2<std::size_t> &support) const {
+                return finder.searches(support);
+            }
+
+            Cycle find(const SpVecGF2<std::size_t> &support, const Cycle &seed) {
+                return finder.find(support, seed);
+            }
+
+        private:
+            const std::vector<Vertex> vertices;
+            OddCycleFinder<Graph, WeightMap> finder;
+        };
+#endif
+
+        inline double wall_seconds(const boost::timer::cpu_timer &timer) {
+            return timer.elapsed().wall / 1e9;
+        }
+
+    } // detail
+
+    /*
+     * Hybrid of the candidate cycle lookup and the signed graph searches. The candidates come
+     * from the shortest path trees rooted at a feedback vertex set, using as many trees as the
+     * memory budget allows. When all trees fit the lookup is exact, otherwise its answer is an
+     * upper bound which prunes the signed graph searches that verify it. Each iteration uses
+     * the method which the cost model expects to be cheaper.
+     */
+    template<class Graph, class WeightMap, class CycleOutputIterator, bool ParallelUsingTBB>
+    typename boost::property_traits<WeightMap>::value_type _mcb_sva_hybrid(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, support_update strategy = support_update::eager, std::size_t memory_budget =
+                    DEFAULT_HYBRID_MEMORY_BUDGET, hybrid_statistics *statistics = nullptr) {
+
+        typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+        typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+        typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+        typedef parmcb::detail::HybridCostModel::method method;
+
+        /*
+         * Index the graph
+         */
+        ForestIndex<Graph> forest_index(g, ParallelUsingTBB);
+        auto csd = forest_index.cycle_space_dimension();
+#ifdef PARMCB_LOGGING
+        std::cout << "Cycle space dimension: " << csd << std::endl;
+#endif
+
+        /*
+         * Initialize support vectors
+         */
+        parmcb::detail::SupportVectors<ParallelUsingTBB> support(csd, strategy);
+
+        boost::timer::cpu_timer cycle_timer;
+        cycle_timer.stop();
+        boost::timer::cpu_timer support_timer;
+        support_timer.stop();
+        boost::timer::cpu_timer trees_timer;
+        trees_timer.stop();
+
+        /*
+         * Shortest path trees of the feedback vertex set which fit the memory budget
+         */
+        trees_timer.resume();
+        std::vector<Vertex> roots;
+        parmcb::greedy_fvs(g, std::back_inserter(roots));
+        std::size_t tree_bytes = (boost::num_vertices(g) + boost::num_edges(g))
+                * parmcb::detail::HYBRID_BYTES_PER_ENTRY;
+        std::size_t max_trees = memory_budget / (std::max)(tree_bytes, std::size_t(1));
+        const bool exact_lookup = roots.size() <= max_trees;
+        if (!exact_lookup) {
+            roots.resize(max_trees);
+        }
+        std::vector<parmcb::SPTree<Graph, WeightMap>> trees;
+        std::vector<parmcb::CandidateCycle<Graph, WeightMap>> cycles;
+        parmcb::SPTrees<Graph, WeightMap, ParallelUsingTBB> builder(g, weight_map);
+        builder.build_trees(roots, trees);
+        builder.build_candidate_cycles(trees, cycles);
+        std::sort(cycles.begin(), cycles.end(), [](const auto &a, const auto &b) {
+            return a.weight() < b.weight();
+        });
+        ShortestOddCycleLookup<Graph, WeightMap, ParallelUsingTBB> cycle_lookup(g, weight_map, trees, cycles, true);
+        // the lookup keeps its own copy of the candidates
+        std::vector<parmcb::CandidateCycle<Graph, WeightMap>>().swap(cycles);
+        trees_timer.stop();
+#ifdef PARMCB_LOGGING
+        std::cout << "Hybrid trees: " << trees.size() << (exact_lookup ? " (exact)" : " (partial)") << std::endl;
+#endif
+
+        /*
+         * Main loop
+         */
+        WeightType mcb_weight = WeightType();
+        parmcb::detail::HybridSignedSearch<Graph, WeightMap, ParallelUsingTBB> signed_search(g, weight_map,
+                forest_index);
+        parmcb::detail::HybridCostModel cost_model(!trees.empty());
+        hybrid_statistics stats;
+        for (std::size_t k = 0; k < csd; k++) {
+            /*
+             * Choose the sparsest support heuristic
+             */
+            support.gather_candidates(k);
+            auto min_support = k;
+            for (auto r = k + 1; r < support.fresh_end(k); ++r) {
+                if (support[r].size() < support[min_support].size())
+                    min_support = r;
+                if (support[min_support].size() < 5) {
+                    break;
+                }
+            }
+            if (min_support != k) {  // swap
+                std::swap(support[k], support[min_support]);
+            }
+
+            /*
+             * Compute shortest odd cycle
+             */
+            cycle_timer.resume();
+            std::size_t searches = signed_search.searches(support[k]);
+            std::tuple<std::set<Edge>, WeightType, bool> best = std::make_tuple(std::set<Edge>(),
+                    (std::numeric_limits<WeightType>::max)(), false);
+            bool verify = true;
+            if (cost_model.choose(searches) == method::lookup) {
+                std::set<Edge> signed_edges;
+                convert_edges(support[k], std::inserter(signed_edges, signed_edges.end()), forest_index);
+                boost::timer::cpu_timer lookup_timer;
+                best = cycle_lookup(signed_edges);
+                verify = !exact_lookup || !std::get<2>(best);
+                cost_model.record_lookup(parmcb::detail::wall_seconds(lookup_timer), verify);
+                stats.lookups++;
+                if (std::get<2>(best)) {
+                    stats.hits++;
+                }
+                if (!verify) {
+                    stats.lookup_answers++;
+                }
+            }
+            if (verify) {
+                const bool bounded = std::get<2>(best);
+                boost::timer::cpu_timer search_timer;
+                best = signed_search.find(support[k], best);
+                cost_model.record_search(searches, parmcb::detail::wall_seconds(search_timer), bounded);
+                if (bounded) {
+                    stats.bounded_searches++;
+                } else {
+                    stats.searches++;
+                }
+            }
+            assert(std::get<2>(best));
+            cycle_timer.stop();
+
+            /*
+             * Update support vectors
+             */
+            support_timer.resume();
+            std::set<std::size_t> cyclek;
+            convert_edges(std::get<0>(best), std::inserter(cyclek, cyclek.end()), forest_index);
+            support.update(k, cyclek);
+            support_timer.stop();
+
+            /*
+             * Output new cycle
+             */
+            std::list<Edge> cyclek_edgelist;
+            std::copy(std::get<0>(best).begin(), std::get<0>(best).end(), std::back_inserter(cyclek_edgelist));
+            *out++ = cyclek_edgelist;
+            mcb_weight += std::get<1>(best);
+        }
+
+#ifdef PARMCB_LOGGING
+        std::cout << "trees   timer" << trees_timer.format();
+        std::cout << "cycle   timer" << cycle_timer.format();
+        std::cout << "support timer" << support_timer.format();
+        std::cout << "lookups " << stats.lookups << " (" << stats.hits << " hits, " << stats.lookup_answers
+                << " answers), bounded searches " << stats.bounded_searches << ", searches " << stats.searches
+                << std::endl;
+#endif
+        if (statistics != nullptr) {
+            *statistics = stats;
+        }
+
+        return mcb_weight;
+    }
+
+    /*
+     * Runs on an immutable CSR snapshot of the graph, cycles are reported using the edges of g.
+     * When given, statistics receives the number of iterations answered by each method.
+     */
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type mcb_sva_hybrid(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, support_update strategy = support_update::eager, std::size_t memory_budget =
+                    DEFAULT_HYBRID_MEMORY_BUDGET, hybrid_statistics *statistics = nullptr) {
+        parmcb::detail::CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+        auto csr_out = snapshot.cycle_output(out);
+        return _mcb_sva_hybrid<parmcb::detail::CSRGraph, typename parmcb::detail::CSRSnapshot<Graph, WeightMap>::CSRWeightMap,
+                decltype(csr_out), false>(snapshot.graph(), snapshot.weight_map(), csr_out, strategy, memory_budget,
+                statistics);
+    }
+
+#ifdef PARMCB_HAVE_TBB
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type mcb_sva_hybrid_tbb(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, const execution_context &context = execution_context(), support_update strategy =
+                    support_update::eager, std::size_t memory_budget = DEFAULT_HYBRID_MEMORY_BUDGET,
+            hybrid_statistics *statistics = nullptr) {
+        return parmcb::detail::execute(context, [&] {
+            parmcb::detail::CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+            auto csr_out = snapshot.cycle_output(out);
+            return _mcb_sva_hybrid<parmcb::detail::CSRGraph,
+                    typename parmcb::detail::CSRSnapshot<Graph, WeightMap>::CSRWeightMap, decltype(csr_out), true>(
+                    snapshot.graph(), snapshot.weight_map(), csr_out, strategy, memory_budget, statistics);
+        });
+    }
+#endif
+
+} // parmcb
+
+#endif
@@ -20,19 +20,138 @@
 #include <vector>
 
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/detail/cycle_cache.hpp>
+#include <parmcb/detail/edge_bitmap.hpp>
+#include <parmcb/detail/search_strategy.hpp>
 #include <parmcb/detail/signed_dijkstra.hpp>
+#include <parmcb/detail/support_vectors.hpp>
 #include <parmcb/forestindex.hpp>
 #include <parmcb/spvecgf2.hpp>
 #include <parmcb/util.hpp>
 
 namespace parmcb {
 
+    /*
+     * Number of previously found cycles kept to seed the weight limit of the searches.
+     */
+    constexpr std::size_t DEFAULT_CYCLE_CACHE_CAPACITY = 64;
+
+    namespace detail {
+
+        /*
+         * Shortest odd cycle search on the signed graph. Either one search runs from (v,+) to
+         * (v,-) for each vertex v, or one search runs for each signed edge, where the signed
+         * edges not yet considered are hidden, as chosen by the search strategy selector.
+         * Searches only report cycles strictly lighter than the current best, which may be seeded
+         * by the caller with any odd cycle. With landmarks the searches also prune by the landmark
+         * lower bounds on the remaining distance. Each bidirectional search expands the side with
+         * fewer queued vertices first.
+         */
+        template<class Graph, class WeightMap>
+        class SignedOddCycleSearch {
+        public:
+            typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+            typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
+            typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef std::tuple<std::set<Edge>, WeightType, bool> Cycle;
+
+            SignedOddCycleSearch(const Graph &g, const WeightMap &weight_map, const ForestIndex<Graph> &forest_index,
+                    std::size_t landmark_count = 0) :
+                    g(g), weight_map(weight_map), forest_index(forest_index), landmarks(g, weight_map, landmark_count), workspace(
+                            g, weight_map, &landmarks), edge_id_map(
+                            make_forest_index_edge_id_map(forest_index)), signed_edges(boost::num_edges(g)), hidden_edges(
+                            boost::num_edges(g)), selector(g, forest_index) {
+            }
+
+            /*
+             * Mark the edges of the support vector as signed, must precede find().
+             */
+            const EdgeBitmap& assign(const SpVecGF2<std::size_t> &support) {
+                signed_edges.assign(support.begin(), support.end());
+                return signed_edges;
+            }
+
+            /*
+             * Number of signed Dijkstra searches of the mode which find() will choose for a
+             * support vector.
+             */
+            std::size_t searches(const SpVecGF2<std::size_t> &support) const {
+                return selector.searches(support);
+            }
+
+            /*
+             * Improve best using the support vector given to the last assign(). Each improvement is
+             * also passed to on_cycle.
+             */
+            template<class OnCycle>
+            void find(const SpVecGF2<std::size_t> &support, Cycle &best, OnCycle on_cycle) {
+                workspace.reset_statistics();
+                if (selector.choose(support) == signed_search_mode::all_vertices) {
+                    VertexIt vi, viend;
+                    for (boost::tie(vi, viend) = boost::vertices(g); vi != viend; ++vi) {
+                        auto v = *vi;
+                        const bool use_hidden_edges = false;
+                        auto res = bidirectional_signed_dijkstra<smaller_queue_first>(g, weight_map, edge_id_map,
+                                signed_edges, hidden_edges, use_hidden_edges, v, true, v, false, std::get<2>(best),
+                                std::get<1>(best), workspace);
+                        if (std::get<2>(res) && (!std::get<2>(best) || compare(std::get<1>(res), std::get<1>(best)))) {
+                            best = res;
+                            on_cycle(best);
+                        }
+                    }
+                } else {
+                    /*
+                     * Heuristic in case number of signed edges is small compared to the number of vertices.
+                     */
+                    hidden_edges.assign(support.begin(), support.end());
+                    for (auto sei = support.begin(); sei != support.end(); ++sei) {
+                        auto se = forest_index(*sei);
+                        auto se_v = boost::source(se, g);
+                        auto se_u = boost::target(se, g);
+                        auto res = bidirectional_signed_dijkstra<smaller_queue_first>(g, weight_map, edge_id_map,
+                                signed_edges, hidden_edges, true, se_v, true, se_u, true, std::get<2>(best),
+                                std::get<1>(best), workspace);
+                        hidden_edges.reset(*sei);
+                        if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
+                            std::get<1>(res) += boost::get(weight_map, se);
+                            if (!std::get<2>(best) || compare(std::get<1>(res), std::get<1>(best))) {
+                                std::get<0>(res).insert(se);
+                                best = res;
+                                on_cycle(best);
+                            }
+                        }
+                    }
+                }
+                selector.record(workspace.scanned_edges());
+            }
+
+            const search_strategy_statistics& strategy_statistics() const {
+                return selector.statistics();
+            }
+
+        private:
+            const Graph &g;
+            const WeightMap &weight_map;
+            const ForestIndex<Graph> &forest_index;
+            const std::less<WeightType> compare = std::less<WeightType>();
+            const Landmarks<Graph, WeightMap> landmarks;
+            SignedDijkstraWorkspace<Graph, WeightMap> workspace;
+            const ForestIndexEdgeIdMap<Graph> edge_id_map;
+            EdgeBitmap signed_edges;
+            EdgeBitmap hidden_edges;
+            SearchStrategySelector<Graph> selector;
+        };
+
+    } // detail
+
     template<class Graph, class WeightMap, class CycleOutputIterator>
-    typename boost::property_traits<WeightMap>::value_type mcb_sva_signed(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out) {
+    typename boost::property_traits<WeightMap>::value_type _mcb_sva_signed(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, support_update strategy = support_update::eager,
+            cycle_cache_statistics *cache_statistics = nullptr, search_strategy_statistics *strategy_statistics =
+                    nullptr, std::size_t landmarks = 0, std::size_t cache_capacity = DEFAULT_CYCLE_CACHE_CAPACITY) {
 
         typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
-        typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
         typedef typename boost::property_traits<WeightMap>::value_type WeightType;
 
         /*
@@ -44,10 +163,7 @@ namespace parmcb {
         /*
          * Initialize support vectors
          */
-        std::vector<SpVecGF2<std::size_t>> support;
-        for (std::size_t k = 0; k < csd; k++) {
-            support.emplace_back(k);
-        }
+        parmcb::detail::SupportVectors<false> support(csd, strategy);
 
         boost::timer::cpu_timer cycle_timer;
         cycle_timer.stop();
@@ -58,12 +174,22 @@ namespace parmcb {
          * Main loop
          */
         WeightType mcb_weight = WeightType();
+        parmcb::detail::SignedOddCycleSearch<Graph, WeightMap> search(g, weight_map, forest_index,
+                landmarks);
+        parmcb::detail::CycleCache<WeightType> cycle_cache(cache_capacity);
+        auto cache_cycle = [&](const std::set<Edge> &cycle, const WeightType &weight) {
+            std::vector<std::size_t> ids;
+            ids.reserve(cycle.size());
+            convert_edges(cycle, std::back_inserter(ids), forest_index);
+            cycle_cache.insert(std::move(ids), weight);
+        };
         for (std::size_t k = 0; k < csd; k++) {
             /*
              * Choose the sparsest support heuristic
              */
+            support.gather_candidates(k);
             auto min_support = k;
-            for (auto r = k + 1; r < csd; ++r) {
+            for (auto r = k + 1; r < support.fresh_end(k); ++r) {
                 if (support[r].size() < support[min_support].size())
                     min_support = r;
                 if (support[min_support].size() < 5) {
@@ -78,47 +204,24 @@ namespace parmcb {
              * Compute shortest odd cycle
              */
             cycle_timer.resume();
-            std::less<WeightType> compare = std::less<WeightType>();
             std::tuple<std::set<Edge>, WeightType, bool> best = std::make_tuple(std::set<Edge>(),
                     (std::numeric_limits<WeightType>::max)(), false);
-            std::set<Edge> signed_edges;
-            convert_edges(support[k], std::inserter(signed_edges, signed_edges.end()), forest_index);
-
-            if (signed_edges.size() >= boost::num_vertices(g)) {
-                VertexIt vi, viend;
-                for (boost::tie(vi, viend) = boost::vertices(g); vi != viend; ++vi) {
-                    auto v = *vi;
-                    const bool use_hidden_edges = false;
-                    auto res = bidirectional_signed_dijkstra(g, weight_map, signed_edges, std::set<Edge> { },
-                            use_hidden_edges, v, true, v, false, std::get<2>(best), std::get<1>(best));
-                    if (std::get<2>(res) && (!std::get<2>(best) || compare(std::get<1>(res), std::get<1>(best)))) {
-                        best = res;
-                        assert(std::get<2>(best));
-                    }
-                }
-            } else {
-                /*
-                 * Heuristic in case number of signed edges is small compared to the number of vertices.
-                 */
-                std::set<Edge> hidden_edges;
-                std::copy(signed_edges.begin(), signed_edges.end(), std::inserter(hidden_edges, hidden_edges.begin()));
-                for (auto sei = signed_edges.begin(); sei != signed_edges.end(); ++sei) {
-                    auto se = *sei;
-                    auto se_v = boost::source(se, g);
-                    auto se_u = boost::target(se, g);
-                    auto res = bidirectional_signed_dijkstra(g, weight_map, signed_edges, hidden_edges, true, se_v,
-                            true, se_u, true, std::get<2>(best), std::get<1>(best));
-                    hidden_edges.erase(hidden_edges.begin());
-                    if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
-                        std::get<1>(res) += boost::get(weight_map, se);
-                        if (!std::get<2>(best) || compare(std::get<1>(res), std::get<1>(best))) {
-                            std::get<0>(res).insert(se);
-                            best = res;
-                            assert(std::get<2>(best));
-                        }
-                    }
-                }
+            const auto &signed_edges = search.assign(support[k]);
+
+            // the lightest cached odd cycle bounds the searches, which only report lighter ones
+            bool from_cache = false;
+            std::size_t cached = cycle_cache.lightest_odd(signed_edges);
+            if (cached != parmcb::detail::CycleCache<WeightType>::npos) {
+                std::set<Edge> cycle;
+                convert_edges(cycle_cache.cycle(cached), std::inserter(cycle, cycle.end()), forest_index);
+                best = std::make_tuple(cycle, cycle_cache.weight(cached), true);
+                from_cache = true;
             }
+
+            search.find(support[k], best, [&](const std::tuple<std::set<Edge>, WeightType, bool> &cycle) {
+                cache_cycle(std::get<0>(cycle), std::get<1>(cycle));
+                from_cache = false;
+            });
             assert(std::get<2>(best));
             cycle_timer.stop();
 
@@ -128,12 +231,12 @@ namespace parmcb {
             support_timer.resume();
             std::set<std::size_t> cyclek;
             convert_edges(std::get<0>(best), std::inserter(cyclek, cyclek.end()), forest_index);
-            for (std::size_t l = k + 1; l < csd; l++) {
-                if (support[l] * cyclek == 1) {
-                    support[l] += support[k];
-                }
-            }
+            support.update(k, cyclek);
             support_timer.stop();
+            if (from_cache) {
+                cycle_cache.record_answer();
+            }
+            cycle_cache.erase(std::vector<std::size_t>(cyclek.begin(), cyclek.end()));
 
             /*
              * Output new cycle
@@ -147,11 +250,41 @@ namespace parmcb {
 #ifdef PARMCB_LOGGING
         std::cout << "cycle   timer" << cycle_timer.format();
         std::cout << "support timer" << support_timer.format();
+        std::cout << "cycle cache hit rate " << cycle_cache.statistics().hit_rate() << " ("
+                << cycle_cache.statistics().answers << " answers)" << std::endl;
+        std::cout << "search modes: all vertices "
+                << search.strategy_statistics().count(signed_search_mode::all_vertices) << ", signed edges "
+                << search.strategy_statistics().count(signed_search_mode::signed_edges) << std::endl;
 #endif
+        if (cache_statistics != nullptr) {
+            *cache_statistics = cycle_cache.statistics();
+        }
+        if (strategy_statistics != nullptr) {
+            *strategy_statistics = search.strategy_statistics();
+        }
 
         return mcb_weight;
     }
 
+    /*
+     * Runs on an immutable CSR snapshot of the graph, cycles are reported using the edges of g.
+     * When given, cache_statistics receives the statistics of the pool of cycles which seeds
+     * the weight limit of each search and strategy_statistics the search mode of each iteration.
+     * A positive number of landmarks precomputes shortest path trees from as many vertices, using
+     * n values per landmark, whose lower bounds prune the searches. The pool keeps at most
+     * cache_capacity cycles, zero disables it.
+     */
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type mcb_sva_signed(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, support_update strategy = support_update::eager,
+            cycle_cache_statistics *cache_statistics = nullptr, search_strategy_statistics *strategy_statistics =
+                    nullptr, std::size_t landmarks = 0, std::size_t cache_capacity = DEFAULT_CYCLE_CACHE_CAPACITY) {
+        parmcb::detail::CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+        auto csr_out = snapshot.cycle_output(out);
+        return _mcb_sva_signed(snapshot.graph(), snapshot.weight_map(), csr_out, strategy, cache_statistics,
+                strategy_statistics, landmarks, cache_capacity);
+    }
+
 } // parmcb
 
 #endif
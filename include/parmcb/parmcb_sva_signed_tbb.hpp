@@ -11,7 +11,9 @@
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <boost/graph/graph_traits.hpp>
@@ -23,11 +25,22 @@
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_reduce.h>
 #include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/info.h>
+#include <tbb/task_arena.h>
 #include <tbb/task_group.h>
 #endif
 
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/detail/edge_bitmap.hpp>
+#include <parmcb/detail/graph_replica.hpp>
+#include <parmcb/detail/numa.hpp>
+#include <parmcb/detail/search_strategy.hpp>
+#include <parmcb/detail/signed_delta_stepping.hpp>
 #include <parmcb/detail/signed_dijkstra.hpp>
+#include <parmcb/detail/support_vectors.hpp>
+#include <parmcb/execution_context.hpp>
 #include <parmcb/forestindex.hpp>
 #include <parmcb/spvecgf2.hpp>
 #include <parmcb/util.hpp>
@@ -36,137 +49,276 @@ namespace parmcb {
 
     namespace detail {
 
+        /*
+         * Data read by the searches of the threads of one NUMA node.
+         */
+        template<class Graph, class WeightMap>
+        struct SignedSearchReplica {
+            SignedSearchReplica(const Graph &g, const WeightMap &weight_map, const ForestIndex<Graph> &forest_index,
+                    const Landmarks<Graph, WeightMap> *landmarks) :
+                    g(g), weight_map(weight_map), forest_index(forest_index), edge_id_map(
+                            make_forest_index_edge_id_map(forest_index)), signed_edges(boost::num_edges(g)), workspaces(
+                            std::cref(g), weight_map, landmarks) {
+            }
+
+            const Graph &g;
+            const WeightMap weight_map;
+            const ForestIndex<Graph> &forest_index;
+            const ForestIndexEdgeIdMap<Graph> edge_id_map;
+            EdgeRanks signed_edges;
+            tbb::enumerable_thread_specific<SignedDijkstraWorkspace<Graph, WeightMap>> workspaces;
+        };
+
+        /*
+         * Finds the shortest odd cycle of each support vector by parallel searches in the signed
+         * graph. Given NUMA domains, each node copies the graph and the searches are split among
+         * the nodes, each node working on its copy.
+         */
         template<class Graph, class WeightMap>
         struct OddCycleFinder {
             typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
             typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
             typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+            typedef std::tuple<std::set<Edge>, WeightType, bool> cycle_t;
+            typedef SignedSearchReplica<Graph, WeightMap> Replica;
 
             OddCycleFinder(const Graph &g, const WeightMap &weight_map, const ForestIndex<Graph> &forest_index,
-                    const std::vector<Vertex> &vertices) :
+                    const std::vector<Vertex> &vertices, std::size_t landmark_count = 0, NumaDomains *domains =
+                            nullptr) :
                     g(g), weight_map(weight_map), forest_index(forest_index), vertices(vertices), compare(
-                            std::less<WeightType>()) {
+                            std::less<WeightType>()), landmarks(g, weight_map, landmark_count), domains(domains), selector(
+                            g, forest_index) {
+                if (domains == nullptr) {
+                    replicas.emplace_back(new Replica(g, weight_map, forest_index, &landmarks));
+                    return;
+                }
+                // constructed by the threads of each node, so that the memory is local to it
+                copies.resize(domains->size());
+                replicas.resize(domains->size());
+                domains->for_each([&](std::size_t i) {
+                    copies[i].reset(new GraphReplica<Graph, WeightMap>(g, weight_map, forest_index));
+                    replicas[i].reset(
+                            new Replica(copies[i]->graph(), copies[i]->weight_map(), copies[i]->forest_index(),
+                                    &landmarks));
+                });
             }
 
-            std::tuple<std::set<Edge>, WeightType, bool> find(const SpVecGF2<std::size_t> &support) {
-                std::set<Edge> signed_edges;
-                convert_edges(support, std::inserter(signed_edges, signed_edges.end()), forest_index);
-                if (signed_edges.size() == 1) {
-                    return find_single_edge(*signed_edges.begin());
-                } else if (signed_edges.size() >= boost::num_vertices(g)) {
-                    return find_all_vertices(signed_edges);
-                } else {
-                    return find_less_than_vertices(signed_edges);
+            cycle_t find(const SpVecGF2<std::size_t> &support) {
+                assign_signed_edges(support);
+                bound.reset();
+                return search(support);
+            }
+
+            /*
+             * Same as find() but seeded with a known odd cycle, whose weight bounds the searches.
+             * The seed is returned unless a strictly lighter cycle exists.
+             */
+            cycle_t find(const SpVecGF2<std::size_t> &support, const cycle_t &seed) {
+                assign_signed_edges(support);
+                bound.reset();
+                if (!std::get<2>(seed)) {
+                    return search(support);
                 }
+                bound.improve(std::get<1>(seed));
+                auto res = search(support);
+                if (std::get<2>(res) && compare(std::get<1>(res), std::get<1>(seed))) {
+                    return res;
+                }
+                return seed;
             }
 
-            std::tuple<std::set<Edge>, WeightType, bool> find_single_edge(const Edge &se) {
-                std::tuple<std::set<Edge>, WeightType, bool> best;
-
-                auto se_v = boost::source(se, g);
-                auto se_u = boost::target(se, g);
-                auto res = bidirectional_signed_dijkstra(g, weight_map, std::set<Edge> { }, std::set<Edge> { se }, true,
-                        se_v, true, se_u, true, std::get<2>(best), std::get<1>(best));
-                if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
-                    std::get<1>(res) += boost::get(weight_map, se);
-                    if (!std::get<2>(best) || compare(std::get<1>(res), std::get<1>(best))) {
-                        std::get<0>(res).insert(se);
-                        best = res;
-                    }
+            cycle_t search(const SpVecGF2<std::size_t> &support) {
+                signed_search_mode mode = selector.choose(support);
+                winner_t winner;
+                std::size_t searches;
+                if (mode == signed_search_mode::all_vertices) {
+                    winner = find_all_vertices();
+                    searches = boost::num_vertices(g);
+                } else {
+                    winner = find_signed_edges(support);
+                    searches = support.size();
                 }
-                return best;
+                if (winner.position == npos) {
+                    return not_found();
+                }
+
+                /*
+                 * The shared bound only stops the searches, thus the winning search inserts the
+                 * same labels, finds the same cycle and scans the same edges as if it ran alone.
+                 * Its edges, extrapolated to all searches of the mode, feed the selector.
+                 */
+                selector.record(winner.scanned_edges * searches);
+                return winner.cycle;
             }
 
-            std::tuple<std::set<Edge>, WeightType, bool> find_all_vertices(const std::set<Edge> &signed_edges) {
-                typedef std::tuple<std::set<Edge>, WeightType, bool> cycle_t;
-                auto cycle_min = [&](const cycle_t &c1, const cycle_t &c2) {
-                    if (!std::get<2>(c1) || !std::get<2>(c2)) {
-                        if (std::get<2>(c1)) {
-                            return c1;
-                        } else {
-                            return c2;
-                        }
-                    }
-                    // both valid, compare
-                    if (!compare(std::get<1>(c2), std::get<1>(c1))) {
-                        return c1;
-                    }
-                    return c2;
-                };
-
-                return tbb::parallel_reduce(tbb::blocked_range<std::size_t>(0, boost::num_vertices(g)),
-                        std::make_tuple(std::set<Edge>(), (std::numeric_limits<WeightType>::max)(), false),
-                        [&](tbb::blocked_range<std::size_t> r, auto running_min) {
-                            for (std::size_t i = r.begin(); i < r.end(); i++) {
-                                auto v = vertices[i];
-                                const bool use_hidden_edges = false;
-                                auto res = bidirectional_signed_dijkstra(g, weight_map, signed_edges,
-                                        std::set<Edge> { }, use_hidden_edges, v, true, v, false,
-                                        std::get<2>(running_min), std::get<1>(running_min));
-                                if (std::get<2>(res)
-                                        && (!std::get<2>(running_min)
-                                                || compare(std::get<1>(res), std::get<1>(running_min)))) {
-                                    running_min = res;
-                                }
-                            }
-                            return running_min;
-                        },
-                        cycle_min);
+            const search_strategy_statistics& strategy_statistics() const {
+                return selector.statistics();
+            }
 
+            /*
+             * Number of signed Dijkstra searches of the mode which find() will choose for a
+             * support vector.
+             */
+            std::size_t searches(const SpVecGF2<std::size_t> &support) const {
+                return selector.searches(support);
             }
 
-            std::tuple<std::set<Edge>, WeightType, bool> find_less_than_vertices(const std::set<Edge> &signed_edges) {
-                /*
-                 * Heuristic in case number of signed edges is small compared to the number of vertices.
-                 */
-                typedef std::tuple<std::set<Edge>, WeightType, bool> cycle_t;
-                auto cycle_min = [&](const cycle_t &c1, const cycle_t &c2) {
-                    if (!std::get<2>(c1) || !std::get<2>(c2)) {
-                        if (std::get<2>(c1)) {
-                            return c1;
-                        } else {
-                            return c2;
-                        }
-                    }
-                    // both valid, compare
-                    if (!compare(std::get<1>(c2), std::get<1>(c1))) {
-                        return c1;
-                    }
-                    return c2;
-                };
-
-                std::map<Edge, std::set<Edge>> hidden_edges_per_edge;
-                std::vector<Edge> signed_edges_as_vector;
-                std::set<Edge> tmp_signed_edges = signed_edges;
-                while (!tmp_signed_edges.empty()) {
-                    auto bit = tmp_signed_edges.begin();
-                    hidden_edges_per_edge.insert(std::make_pair(*bit, tmp_signed_edges));
-                    signed_edges_as_vector.push_back(*bit);
-                    tmp_signed_edges.erase(bit);
+        private:
+            /*
+             * The lightest cycle, the position of the search which found it, npos if none, and
+             * the edges that search scanned.
+             */
+            struct winner_t {
+                cycle_t cycle;
+                std::size_t position;
+                std::size_t scanned_edges;
+            };
+
+            static constexpr std::size_t npos = (std::numeric_limits<std::size_t>::max)();
+
+            /*
+             * The searches are not limited by the lightest cycle of their own range, which would
+             * prune cycles of equal weight. Only the shared bound stops them, thus every search
+             * with the lightest weight finds its cycle and the lowest position wins.
+             */
+            winner_t find_all_vertices() {
+                return reduce(boost::num_vertices(g), [&](Replica &replica, std::size_t first, std::size_t last) {
+                    return tbb::parallel_reduce(tbb::blocked_range<std::size_t>(first, last), no_winner(),
+                            [&](tbb::blocked_range<std::size_t> r, winner_t running_min) {
+                                auto &workspace = replica.workspaces.local();
+                                for (std::size_t i = r.begin(); i < r.end(); i++) {
+                                    auto v = vertices[i];
+                                    std::size_t scanned = workspace.scanned_edges();
+                                    auto res = bidirectional_signed_dijkstra<smaller_queue_first>(replica.g,
+                                            replica.weight_map, replica.edge_id_map, replica.signed_edges,
+                                            EdgeRanks::none, v, true, v, false, false, WeightType(), bound,
+                                            WeightType(), workspace);
+                                    if (std::get<2>(res)) {
+                                        bound.improve(std::get<1>(res));
+                                        running_min = winner_min(std::move(running_min),
+                                                winner_t { std::move(res), i, workspace.scanned_edges() - scanned });
+                                    }
+                                }
+                                return running_min;
+                            }, [&](const winner_t &w1, const winner_t &w2) {
+                                return winner_min(w1, w2);
+                            });
+                });
+            }
+
+            winner_t find_signed_edges(const SpVecGF2<std::size_t> &support) {
+                if (domains == nullptr && support.size() < static_cast<std::size_t>(tbb::info::default_concurrency())) {
+                    return find_signed_edges_delta_stepping(support);
                 }
-                return tbb::parallel_reduce(tbb::blocked_range<std::size_t>(0, signed_edges_as_vector.size()),
-                        std::make_tuple(std::set<Edge>(), (std::numeric_limits<WeightType>::max)(), false),
-                        [&](tbb::blocked_range<std::size_t> r, auto running_min) {
-                            for (std::size_t i = r.begin(); i < r.end(); i++) {
-                                auto se = signed_edges_as_vector.at(i);
-                                auto se_v = boost::source(se, g);
-                                auto se_u = boost::target(se, g);
-                                auto hidden_edges = hidden_edges_per_edge.at(se);
-                                auto res = bidirectional_signed_dijkstra(g, weight_map, signed_edges, hidden_edges,
-                                        true, se_v, true, se_u, true, std::get<2>(running_min),
-                                        std::get<1>(running_min));
-                                if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
-                                    std::get<1>(res) += boost::get(weight_map, se);
-                                    if (!std::get<2>(running_min)
-                                            || compare(std::get<1>(res), std::get<1>(running_min))) {
-                                        std::get<0>(res).insert(se);
-                                        running_min = res;
+
+                return reduce(support.size(), [&](Replica &replica, std::size_t first, std::size_t last) {
+                    return tbb::parallel_reduce(tbb::blocked_range<std::size_t>(first, last), no_winner(),
+                            [&](tbb::blocked_range<std::size_t> r, winner_t running_min) {
+                                auto &workspace = replica.workspaces.local();
+                                for (std::size_t i = r.begin(); i < r.end(); i++) {
+                                    auto se_id = *(support.begin() + i);
+                                    auto se = replica.forest_index(se_id);
+                                    auto se_v = boost::source(se, replica.g);
+                                    auto se_u = boost::target(se, replica.g);
+                                    auto se_weight = boost::get(replica.weight_map, se);
+                                    // signed edges at position i or later are hidden from the i-th search
+                                    std::size_t scanned = workspace.scanned_edges();
+                                    auto res = bidirectional_signed_dijkstra<smaller_queue_first>(replica.g,
+                                            replica.weight_map, replica.edge_id_map, replica.signed_edges, i, se_v,
+                                            true, se_u, true, false, WeightType(), bound, se_weight, workspace);
+                                    if (std::get<2>(res) && std::get<0>(res).insert(se).second) {
+                                        std::get<1>(res) += se_weight;
+                                        bound.improve(std::get<1>(res));
+                                        running_min = winner_min(std::move(running_min),
+                                                winner_t { std::move(res), i, workspace.scanned_edges() - scanned });
                                     }
                                 }
-                            }
-                            return running_min;
-                        },
-                        cycle_min);
+                                return running_min;
+                            }, [&](const winner_t &w1, const winner_t &w2) {
+                                return winner_min(w1, w2);
+                            });
+                });
+            }
+
+            /*
+             * With fewer signed edges than threads the searches alone cannot use all cores, so they
+             * run one after the other and each one is parallelized by delta-stepping. The two
+             * ways may find different cycles of equal weight, thus the choice compares with the
+             * hardware threads and not with the threads of the arena, so that the basis does not
+             * depend on how many threads a run is given.
+             */
+            winner_t find_signed_edges_delta_stepping(const SpVecGF2<std::size_t> &support) {
+                if (!delta_stepping) {
+                    delta_stepping.reset(new SignedDeltaSteppingWorkspace<Graph, WeightMap>(g, weight_map));
+                }
+                const Replica &replica = *replicas[0];
+                winner_t min = no_winner();
+                for (std::size_t i = 0; i < support.size(); i++) {
+                    auto se = forest_index(*(support.begin() + i));
+                    auto se_v = boost::source(se, g);
+                    auto se_u = boost::target(se, g);
+                    auto se_weight = boost::get(weight_map, se);
+                    delta_stepping->reset_statistics();
+                    auto res = parallel_signed_dijkstra(g, weight_map, replica.edge_id_map, replica.signed_edges, i,
+                            se_v, true, se_u, true, min.position != npos, std::get<1>(min.cycle), bound, se_weight,
+                            *delta_stepping);
+                    if (std::get<2>(res) && std::get<0>(res).insert(se).second) {
+                        std::get<1>(res) += se_weight;
+                        bound.improve(std::get<1>(res));
+                        min = winner_min(std::move(min), winner_t { std::move(res), i,
+                                delta_stepping->scanned_edges.load(std::memory_order_relaxed) });
+                    }
+                }
+                return min;
+            }
+
+            static winner_t no_winner() {
+                return winner_t { not_found(), npos, 0 };
+            }
+
+            /*
+             * The lighter of two winners, the lower position among equal weights.
+             */
+            winner_t winner_min(winner_t w1, winner_t w2) const {
+                if (w1.position == npos || w2.position == npos) {
+                    return w1.position == npos ? w2 : w1;
+                }
+                const WeightType &weight1 = std::get<1>(w1.cycle);
+                const WeightType &weight2 = std::get<1>(w2.cycle);
+                if (compare(weight1, weight2) || (!compare(weight2, weight1) && w1.position < w2.position)) {
+                    return w1;
+                }
+                return w2;
+            }
+
+            static cycle_t not_found() {
+                return std::make_tuple(std::set<Edge>(), (std::numeric_limits<WeightType>::max)(), false);
+            }
+
+            void assign_signed_edges(const SpVecGF2<std::size_t> &support) {
+                for (auto &replica : replicas) {
+                    replica->signed_edges.assign(support.begin(), support.end());
+                }
+            }
+
+            /*
+             * Run reduce(replica, first, last) over [0, size), split among the NUMA nodes if any.
+             */
+            template<class Reduce>
+            winner_t reduce(std::size_t size, Reduce reduce) {
+                if (domains == nullptr) {
+                    return reduce(*replicas[0], 0, size);
+                }
+                std::vector<winner_t> results(replicas.size(), no_winner());
+                domains->for_each([&](std::size_t i) {
+                    auto range = domains->part(0, size, i);
+                    results[i] = reduce(*replicas[i], range.first, range.second);
+                });
+                winner_t min = no_winner();
+                for (const auto &res : results) {
+                    min = winner_min(min, res);
+                }
+                return min;
             }
 
             const Graph &g;
@@ -174,13 +326,30 @@ namespace parmcb {
             const ForestIndex<Graph> &forest_index;
             const std::vector<Vertex> &vertices;
             const std::less<WeightType> compare;
+            const Landmarks<Graph, WeightMap> landmarks;
+            NumaDomains *domains;
+            std::vector<std::unique_ptr<GraphReplica<Graph, WeightMap>>> copies;
+            std::vector<std::unique_ptr<Replica>> replicas;
+            /*
+             * Weight of the lightest cycle found so far by any worker. Searches stop only at labels
+             * strictly heavier than it, thus neither the winning position nor its cycle depend on
+             * the scheduling.
+             */
+            SharedCycleWeightBound<WeightType> bound;
+            SearchStrategySelector<Graph> selector;
+            std::unique_ptr<SignedDeltaSteppingWorkspace<Graph, WeightMap>> delta_stepping;
         };
 
+        template<class Graph, class WeightMap>
+        constexpr std::size_t OddCycleFinder<Graph, WeightMap>::npos;
+
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
-    typename boost::property_traits<WeightMap>::value_type mcb_sva_signed_tbb(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out, const std::size_t hardware_concurrency_hint = 0) {
+    typename boost::property_traits<WeightMap>::value_type _mcb_sva_signed_tbb(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, support_update strategy = support_update::eager,
+            search_strategy_statistics *strategy_statistics = nullptr, std::size_t landmarks = 0,
+            parmcb::detail::NumaDomains *domains = nullptr) {
 
         typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
         typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
@@ -190,7 +359,7 @@ namespace parmcb {
         /*
          * Index the graph
          */
-        ForestIndex<Graph> forest_index(g);
+        ForestIndex<Graph> forest_index(g, true);
         auto csd = forest_index.cycle_space_dimension();
 #ifdef PARMCB_LOGGING
         std::cout << "Cycle dimension " << csd << std::endl;
@@ -206,12 +375,10 @@ namespace parmcb {
         /*
          * Initialize support vectors
          */
-        tbb::concurrent_vector<SpVecGF2<std::size_t>> support;
-        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, csd), [&](const tbb::blocked_range<std::size_t> &r) {
-            for (std::size_t i = r.begin(); i != r.end(); ++i) {
-                support.push_back(SpVecGF2<std::size_t> { i });
-            }
-        });
+        parmcb::detail::SupportVectors<true> support(csd, strategy);
+        if (domains != nullptr) {
+            support.distribute(*domains);
+        }
 
         boost::timer::cpu_timer cycle_timer;
         cycle_timer.stop();
@@ -222,7 +389,8 @@ namespace parmcb {
          * Main loop
          */
         WeightType mcb_weight = WeightType();
-        parmcb::detail::OddCycleFinder<Graph, WeightMap> odd_cycle_finder(g, weight_map, forest_index, vertices);
+        parmcb::detail::OddCycleFinder<Graph, WeightMap> odd_cycle_finder(g, weight_map, forest_index, vertices,
+                landmarks, domains);
         for (std::size_t k = 0; k < csd; k++) {
 #ifdef PARMCB_LOGGING
             if (k % 250 == 0) {
@@ -233,8 +401,9 @@ namespace parmcb {
             /*
              * Choose the sparsest support heuristic
              */
+            support.gather_candidates(k);
             auto min_support = k;
-            for (auto r = k + 1; r < csd; ++r) {
+            for (auto r = k + 1; r < support.fresh_end(k); ++r) {
                 if (support[r].size() < support[min_support].size())
                     min_support = r;
             }
@@ -255,15 +424,7 @@ namespace parmcb {
             support_timer.resume();
             std::set<std::size_t> cyclek;
             convert_edges(std::get<0>(cycle), std::inserter(cyclek, cyclek.end()), forest_index);
-            tbb::parallel_for(tbb::blocked_range<std::size_t>(k + 1, csd),
-                    [&](const tbb::blocked_range<std::size_t> &r) {
-                        auto e = r.end();
-                        for (std::size_t i = r.begin(); i != e; ++i) {
-                            if (support[i] * cyclek == 1) {
-                                support[i] += support[k];
-                            }
-                        }
-                    });
+            support.update(k, cyclek);
             support_timer.stop();
 
             /*
@@ -278,11 +439,43 @@ namespace parmcb {
 #ifdef PARMCB_LOGGING
         std::cout << "cycle   timer" << cycle_timer.format();
         std::cout << "support timer" << support_timer.format();
+        std::cout << "search modes: all vertices "
+                << odd_cycle_finder.strategy_statistics().count(signed_search_mode::all_vertices)
+                << ", signed edges " << odd_cycle_finder.strategy_statistics().count(signed_search_mode::signed_edges)
+                << std::endl;
 #endif
+        if (strategy_statistics != nullptr) {
+            *strategy_statistics = odd_cycle_finder.strategy_statistics();
+        }
 
         return mcb_weight;
     }
 
+    /*
+     * Runs on an immutable CSR snapshot of the graph, cycles are reported using the edges of g.
+     * When given, strategy_statistics receives the search mode of each iteration. A positive
+     * number of landmarks enables the landmark lower bounds of the searches, see mcb_sva_signed().
+     * The threads are given by the execution context, with NUMA replication each node searches
+     * on its own copy of the snapshot and owns a part of the support vectors.
+     */
+    template<class Graph, class WeightMap, class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type mcb_sva_signed_tbb(const Graph &g, WeightMap weight_map,
+            CycleOutputIterator out, const execution_context &context = execution_context(), support_update strategy =
+                    support_update::eager, search_strategy_statistics *strategy_statistics = nullptr,
+            std::size_t landmarks = 0) {
+        return parmcb::detail::execute(context, [&] {
+            parmcb::detail::CSRSnapshot<Graph, WeightMap> snapshot(g, weight_map);
+            auto csr_out = snapshot.cycle_output(out);
+            if (context.numa_replication) {
+                parmcb::detail::NumaDomains domains(context);
+                return _mcb_sva_signed_tbb(snapshot.graph(), snapshot.weight_map(), csr_out, strategy,
+                        strategy_statistics, landmarks, &domains);
+            }
+            return _mcb_sva_signed_tbb(snapshot.graph(), snapshot.weight_map(), csr_out, strategy, strategy_statistics,
+                    landmarks);
+        });
+    }
+
 } // namespace parmcb
 
 #endif
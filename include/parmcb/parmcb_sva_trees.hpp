@@ -20,24 +20,29 @@
 #include <vector>
 
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
+#include <parmcb/execution_context.hpp>
 #include <parmcb/forestindex.hpp>
 #include <parmcb/spvecgf2.hpp>
 #include <parmcb/util.hpp>
 #include <parmcb/sptrees.hpp>
 #include <parmcb/detail/cycles.hpp>
+#include <parmcb/detail/numa.hpp>
+#include <parmcb/detail/support_vectors.hpp>
 
 namespace parmcb {
 
     template<class Graph, class WeightMap, class CycleOutputIterator, class CyclesBuilder, bool ParallelUsingTBB>
     typename boost::property_traits<WeightMap>::value_type _mcb_sva_trees(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out) {
+            CycleOutputIterator out, support_update strategy = support_update::eager,
+            parmcb::detail::NumaDomains *domains = nullptr) {
         typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
         typedef typename boost::property_traits<WeightMap>::value_type WeightType;
 
         /*
          * Index the graph
          */
-        ForestIndex<Graph> forest_index(g);
+        ForestIndex<Graph> forest_index(g, ParallelUsingTBB);
         auto csd = forest_index.cycle_space_dimension();
 #ifdef PARMCB_LOGGING
         std::cout << "Cycle space dimension: " << csd << std::endl;
@@ -46,10 +51,14 @@ namespace parmcb {
         /*
          * Initialize support vectors
          */
-        std::vector<SpVecGF2<std::size_t>> support;
-        for (std::size_t k = 0; k < csd; k++) {
-            support.emplace_back(k);
+        parmcb::detail::SupportVectors<ParallelUsingTBB> support(csd, strategy);
+#ifdef PARMCB_HAVE_TBB
+        if (domains != nullptr) {
+            support.distribute(*domains);
         }
+#else
+        (void) domains;
+#endif
 
         boost::timer::cpu_timer cycle_timer;
         cycle_timer.stop();
@@ -78,6 +87,8 @@ namespace parmcb {
         }
         ShortestOddCycleLookup<Graph, WeightMap, ParallelUsingTBB> cycle_lookup(g, weight_map, trees, cycles,
                 sorted_cycles);
+        // the lookup keeps its own copy of the candidates
+        std::vector<parmcb::CandidateCycle<Graph, WeightMap>>().swap(cycles);
         trees_timer.stop();
 
         /*
@@ -106,11 +117,7 @@ namespace parmcb {
             support_timer.resume();
             std::set<std::size_t> cyclek;
             convert_edges(std::get<0>(best), std::inserter(cyclek, cyclek.end()), forest_index);
-            for (std::size_t l = k + 1; l < csd; l++) {
-                if (support[l] * cyclek == 1) {
-                    support[l] += support[k];
-                }
-            }
+            support.update(k, cyclek);
             support_timer.stop();
 
             /*
@@ -131,32 +138,66 @@ namespace parmcb {
         return mcb_weight;
     }
 
+    /*
+     * Runs on an immutable CSR snapshot of the graph, cycles are reported using the edges of g.
+     * Given NUMA domains the support vectors are distributed among the nodes.
+     */
+    template<template<class, class, bool > class CyclesBuilder, bool ParallelUsingTBB, class Graph, class WeightMap,
+            class CycleOutputIterator>
+    typename boost::property_traits<WeightMap>::value_type _mcb_sva_trees_snapshot(const Graph &g,
+            WeightMap weight_map, CycleOutputIterator out, support_update strategy,
+            parmcb::detail::NumaDomains *domains = nullptr) {
+        typedef parmcb::detail::CSRSnapshot<Graph, WeightMap> Snapshot;
+        typedef typename Snapshot::CSRWeightMap CSRWeightMap;
+        Snapshot snapshot(g, weight_map);
+        auto csr_out = snapshot.cycle_output(out);
+        return _mcb_sva_trees<parmcb::detail::CSRGraph, CSRWeightMap, decltype(csr_out),
+                CyclesBuilder<parmcb::detail::CSRGraph, CSRWeightMap, ParallelUsingTBB>, ParallelUsingTBB>(snapshot.graph(),
+                snapshot.weight_map(), csr_out, strategy, domains);
+    }
+
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_fvs_trees(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out) {
-        return _mcb_sva_trees<Graph, WeightMap, CycleOutputIterator, parmcb::detail::FVSCyclesBuilder<Graph, WeightMap>,
-                false>(g, weight_map, out);
+            CycleOutputIterator out, support_update strategy = support_update::eager) {
+        return _mcb_sva_trees_snapshot<parmcb::detail::FVSCyclesBuilder, false>(g, weight_map, out, strategy);
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_fvs_trees_tbb(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out) {
-        return _mcb_sva_trees<Graph, WeightMap, CycleOutputIterator, parmcb::detail::FVSCyclesBuilder<Graph, WeightMap>,
-                true>(g, weight_map, out);
+            CycleOutputIterator out, const execution_context &context = execution_context(), support_update strategy =
+                    support_update::eager) {
+        return parmcb::detail::execute(context, [&] {
+#ifdef PARMCB_HAVE_TBB
+            if (context.numa_replication) {
+                parmcb::detail::NumaDomains domains(context);
+                return _mcb_sva_trees_snapshot<parmcb::detail::FVSCyclesBuilder, true>(g, weight_map, out, strategy,
+                        &domains);
+            }
+#endif
+            return _mcb_sva_trees_snapshot<parmcb::detail::FVSCyclesBuilder, true>(g, weight_map, out, strategy);
+        });
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_iso_trees(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out) {
-        return _mcb_sva_trees<Graph, WeightMap, CycleOutputIterator, parmcb::detail::ISOCyclesBuilder<Graph, WeightMap>,
-                false>(g, weight_map, out);
+            CycleOutputIterator out, support_update strategy = support_update::eager) {
+        return _mcb_sva_trees_snapshot<parmcb::detail::ISOCyclesBuilder, false>(g, weight_map, out, strategy);
     }
 
     template<class Graph, class WeightMap, class CycleOutputIterator>
     typename boost::property_traits<WeightMap>::value_type mcb_sva_iso_trees_tbb(const Graph &g, WeightMap weight_map,
-            CycleOutputIterator out) {
-        return _mcb_sva_trees<Graph, WeightMap, CycleOutputIterator, parmcb::detail::ISOCyclesBuilder<Graph, WeightMap>,
-                true>(g, weight_map, out);
+            CycleOutputIterator out, const execution_context &context = execution_context(), support_update strategy =
+                    support_update::eager) {
+        return parmcb::detail::execute(context, [&] {
+#ifdef PARMCB_HAVE_TBB
+            if (context.numa_replication) {
+                parmcb::detail::NumaDomains domains(context);
+                return _mcb_sva_trees_snapshot<parmcb::detail::ISOCyclesBuilder, true>(g, weight_map, out, strategy,
+                        &domains);
+            }
+#endif
+            return _mcb_sva_trees_snapshot<parmcb::detail::ISOCyclesBuilder, true>(g, weight_map, out, strategy);
+        });
     }
 
 } // namespace parmcb
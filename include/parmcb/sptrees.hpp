@@ -18,190 +18,194 @@
 #include <boost/serialization/vector.hpp>
 
 #include <parmcb/config.hpp>
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/detail/lex_dijkstra.hpp>
 #include <parmcb/detail/util.hpp>
 
 #include <parmcb/forestindex.hpp>
 #include <parmcb/spvecgf2.hpp>
 
-#include <memory>
-#include <stack>
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 #ifdef PARMCB_HAVE_TBB
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_reduce.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 #endif
 
 namespace parmcb {
 
-    template<class Graph, class WeightMap> class SPNode;
     template<class Graph, class WeightMap> class SPTree;
-    template<class Graph, class WeightMap, class T> struct SPSubtree;
     template<class Graph, class WeightMap, bool ParallelUsingTBB> class SPTrees;
     template<class Graph, class WeightMap> class CandidateCycle;
     template<class Graph> struct SerializableCandidateCycle;
     template<class Graph, class WeightMap> struct SerializableMinOddCycle;
     template<class Graph, class WeightMap> struct SerializableMinOddCycleMinOp;
 
+    /*
+     * Shortest path tree stored as arrays indexed by vertex index: the predecessor edge and
+     * parent vertex, the distance, the parity and the first vertex after the source on the
+     * tree path. The reachable vertices are also kept in DFS preorder together with their
+     * subtree sizes, so that the subtree of a vertex v is the range
+     * [position(v), position(v) + subtree_size(v)) of the preorder.
+     */
     template<class Graph, class WeightMap>
-    class SPNode {
+    class SPTree {
     public:
         typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+        typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
+        typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
         typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
         typedef typename boost::property_traits<WeightMap>::value_type WeightType;
 
-        SPNode() :
-                _vertex(), _parity(false), _weight(WeightType()), _pred(), _has_pred(false) {
-        }
+        static constexpr std::size_t npos = (std::numeric_limits<std::size_t>::max)();
 
-        SPNode(Vertex vertex, WeightType weight) :
-                _vertex(vertex), _parity(false), _weight(WeightType()), _pred(), _has_pred(false) {
+        SPTree(std::size_t id, const Graph &g, const VertexIndexMapType& index_map, const WeightMap &weight_map, const Vertex &source) :
+                _id(id), _g(g), _weight_map(weight_map), _index_map(index_map), _source(source) {
+            initialize();
         }
 
-        SPNode(Vertex vertex, WeightType weight, const Edge &pred) :
-                _vertex(vertex), _parity(false), _weight(weight), _pred(pred), _has_pred(true) {
+        /*
+         * Recompute the parities of all vertices, the parity of a vertex is the number of
+         * signed edges on its tree path modulo two.
+         */
+        void update_parities(const std::set<Edge> &edges) {
+            _parity[0] = 0;
+            for (std::size_t i = 1; i < _preorder.size(); i++) {
+                auto vindex = _preorder[i];
+                char is_signed = edges.find(_pred[vindex]) != edges.end();
+                _parity[i] = _parity[_position[_index_map[_parent[vindex]]]] ^ is_signed;
+            }
         }
 
-        void add_child(std::shared_ptr<SPNode<Graph, WeightMap>> c) {
-            _children.push_back(c);
+        /*
+         * Update the parities after the signed edges changed from a previous set to edges,
+         * where changed is the symmetric difference of the two sets. Each changed tree edge
+         * flips the parity of the subtree below it, which is a range of the preorder. When
+         * the subtrees cover more vertices than the tree, all parities are recomputed.
+         */
+        void update_parities(const std::set<Edge> &edges, const std::vector<Edge> &changed) {
+            std::vector<std::size_t> &roots = _changed_subtrees;
+            roots.clear();
+            std::size_t cost = 0;
+            for (const auto &e : changed) {
+                auto u = boost::source(e, _g);
+                auto v = boost::target(e, _g);
+                if (has_pred(v) && _pred[_index_map[v]] == e) {
+                    roots.push_back(_position[_index_map[v]]);
+                } else if (has_pred(u) && _pred[_index_map[u]] == e) {
+                    roots.push_back(_position[_index_map[u]]);
+                } else {
+                    continue;
+                }
+                cost += _subtree_size[_preorder[roots.back()]];
+                if (cost > _preorder.size()) {
+                    update_parities(edges);
+                    return;
+                }
+            }
+            for (auto first : roots) {
+                std::size_t last = first + _subtree_size[_preorder[first]];
+                for (std::size_t i = first; i < last; i++) {
+                    _parity[i] ^= 1;
+                }
+            }
         }
 
-        std::vector<std::shared_ptr<SPNode<Graph, WeightMap>>>& children() {
-            return _children;
+        bool is_reachable(const Vertex &v) const {
+            return _position[_index_map[v]] != npos;
         }
 
-        Vertex& vertex() {
-            return _vertex;
+        bool has_pred(const Vertex &v) const {
+            return v != _source && is_reachable(v);
         }
 
-        bool& parity() {
-            return _parity;
+        const Edge& pred(const Vertex &v) const {
+            return _pred[_index_map[v]];
         }
 
-        WeightType& weight() {
-            return _weight;
+        const Vertex& parent(const Vertex &v) const {
+            return _parent[_index_map[v]];
         }
 
-        const Edge& pred() {
-            return _pred;
+        const WeightType& distance(const Vertex &v) const {
+            return _dist[_index_map[v]];
         }
 
-        bool has_pred() {
-            return _has_pred;
+        bool parity(const Vertex &v) const {
+            auto pos = _position[_index_map[v]];
+            return pos != npos && _parity[pos];
         }
 
-    private:
-        Vertex _vertex;
-        bool _parity;
-        WeightType _weight;
-        Edge _pred;
-        bool _has_pred;
-        std::vector<std::shared_ptr<SPNode<Graph, WeightMap>>> _children;
-    };
-
-    template<class Graph, class WeightMap, class T>
-    struct SPSubtree {
-        T info;
-        std::shared_ptr<SPNode<Graph, WeightMap>> root;
-
-        SPSubtree(T info, std::shared_ptr<SPNode<Graph, WeightMap>> root) :
-                info(info), root(root) {
+        const Vertex& source() const {
+            return _source;
         }
-    };
-
-    template<class Graph, class WeightMap>
-    class SPTree {
-    public:
-        typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
-        typedef typename boost::graph_traits<Graph>::vertex_iterator VertexIt;
-        typedef typename boost::property_map<Graph, boost::vertex_index_t>::type VertexIndexMapType;
-        typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
-        typedef typename boost::property_traits<WeightMap>::value_type WeightType;
 
-        SPTree(std::size_t id, const Graph &g, const VertexIndexMapType& index_map, const WeightMap &weight_map, const Vertex &source) :
-                _id(id), _g(g), _weight_map(weight_map), _index_map(index_map), _source(
-                        source), _tree_node_map(boost::num_vertices(g)), _first_in_path(boost::num_vertices(g)) {
-            initialize();
+        const Graph& graph() const {
+            return _g;
         }
 
-        void update_parities(const std::set<Edge> &edges) {
-            std::stack<SPSubtree<Graph, WeightMap, bool>> stack;
-            stack.emplace(false, _root);
-
-            while (!stack.empty()) {
-                SPSubtree<Graph, WeightMap, bool> r = stack.top();
-                stack.pop();
+        const std::size_t id() const {
+            return _id;
+        }
 
-                r.root->parity() = r.info;
-                for (auto c : r.root->children()) {
-                    bool is_signed = edges.find(c->pred()) != edges.end();
-                    stack.emplace(SPSubtree<Graph, WeightMap, bool> { static_cast<bool>(r.info ^ is_signed), c });
-                }
-            }
+        const Vertex& first(const Vertex &v) const {
+            return _first_in_path[_index_map[v]];
         }
 
-        std::shared_ptr<SPNode<Graph, WeightMap>> node(const Vertex &v) const {
-            return _tree_node_map[_index_map[v]];
+        /*
+         * Vertex indices of the reachable vertices in DFS preorder.
+         */
+        const std::vector<std::size_t>& preorder() const {
+            return _preorder;
         }
 
-        const Vertex& source() const {
-            return _source;
+        std::size_t position(const Vertex &v) const {
+            return _position[_index_map[v]];
         }
 
-        const Graph& graph() const {
-            return _g;
+        std::size_t subtree_size(const Vertex &v) const {
+            return _subtree_size[_index_map[v]];
         }
 
-        const std::size_t id() const {
-            return _id;
+        /*
+         * Parities of the reachable vertices in preorder.
+         */
+        const char* parity_data() const {
+            return _parity.data();
         }
 
-        const Vertex first(const Vertex &v) {
-            auto vindex = _index_map[v];
-            return _first_in_path[vindex];
+        bool is_tree_edge(const Edge &e) const {
+            auto u = boost::source(e, _g);
+            auto v = boost::target(e, _g);
+            return (has_pred(u) && _pred[_index_map[u]] == e) || (has_pred(v) && _pred[_index_map[v]] == e);
         }
 
         template<class EdgeIterator>
         std::vector<CandidateCycle<Graph, WeightMap>> create_candidate_cycles(EdgeIterator begin,
                 EdgeIterator end) const {
-            // collect tree edges
-            std::set<Edge> tree_edges;
-            VertexIt vi, viend;
-            for (boost::tie(vi, viend) = boost::vertices(_g); vi != viend; ++vi) {
-                auto v = *vi;
-                auto vindex = _index_map[v];
-                std::shared_ptr<SPNode<Graph, WeightMap>> n = _tree_node_map[vindex];
-                if (n != nullptr && n->has_pred()) {
-                    tree_edges.insert(n->pred());
-                }
-            }
-
             // loop over (non-tree) provided edges and create candidate cycles
             std::vector<CandidateCycle<Graph, WeightMap>> cycles;
             for (EdgeIterator it = begin; it != end; it++) {
                 Edge e = *it;
-                if (tree_edges.find(e) != tree_edges.end()) {
-                    continue;
-                }
-
-                // non-tree edge
-                std::shared_ptr<SPNode<Graph, WeightMap>> v = node(boost::source(e, _g));
-                if (v == nullptr) {
-                    continue;
+                if (is_candidate(e)) {
+                    WeightType cycle_weight = boost::get(_weight_map, e) + distance(boost::source(e, _g))
+                            + distance(boost::target(e, _g));
+                    cycles.emplace_back(_id, e, cycle_weight);
                 }
-                std::shared_ptr<SPNode<Graph, WeightMap>> u = node(boost::target(e, _g));
-                if (u == nullptr) {
-                    continue;
-                }
-
-                if (_first_in_path[_index_map[v->vertex()]] == _first_in_path[_index_map[u->vertex()]]) {
-                    // shortest paths start with the same vertex, discard
-                    continue;
-                }
-
-                WeightType cycle_weight = boost::get(_weight_map, e) + v->weight() + u->weight();
-                cycles.emplace_back(_id, e, cycle_weight);
             }
             return cycles;
         }
@@ -213,43 +217,13 @@ namespace parmcb {
 
         std::vector<SerializableCandidateCycle<Graph>> create_serializable_candidate_cycles(
                 const ForestIndex<Graph> &forest_index) {
-            // collect tree edges
-            std::set<Edge> tree_edges;
-            VertexIt vi, viend;
-            for (boost::tie(vi, viend) = boost::vertices(_g); vi != viend; ++vi) {
-                auto v = *vi;
-                auto vindex = _index_map[v];
-                std::shared_ptr<SPNode<Graph, WeightMap>> n = _tree_node_map[vindex];
-                if (n != nullptr && n->has_pred()) {
-                    tree_edges.insert(n->pred());
-                }
-            }
-
             // loop over all non-tree edges and create candidate cycles
             std::vector<SerializableCandidateCycle<Graph>> cycles;
             for (const auto &e : boost::make_iterator_range(boost::edges(_g))) {
-                if (tree_edges.find(e) != tree_edges.end()) {
-                    continue;
-                }
-
-                // non-tree edge
-                std::shared_ptr<SPNode<Graph, WeightMap>> v = node(boost::source(e, _g));
-                if (v == nullptr) {
-                    continue;
-                }
-                std::shared_ptr<SPNode<Graph, WeightMap>> u = node(boost::target(e, _g));
-                if (u == nullptr) {
-                    continue;
+                if (is_candidate(e)) {
+                    cycles.emplace_back(_source, forest_index(e));
                 }
-
-                if (_first_in_path[_index_map[v->vertex()]] == _first_in_path[_index_map[u->vertex()]]) {
-                    // shortest paths start with the same vertex, discard
-                    continue;
-                }
-
-                cycles.emplace_back(_source, forest_index(e));
             }
-
             return cycles;
         }
 
@@ -257,95 +231,119 @@ namespace parmcb {
         const std::size_t _id;
         const Graph &_g;
         const WeightMap &_weight_map;
-        const VertexIndexMapType &_index_map;
+        VertexIndexMapType _index_map;
         const Vertex _source;
 
+        std::vector<Edge> _pred;
+        std::vector<Vertex> _parent;
+        std::vector<WeightType> _dist;
         /*
-         * Shortest path tree root
-         */
-        std::shared_ptr<SPNode<Graph, WeightMap>> _root;
-        /*
-         * Map from vertex to shortest path tree node
+         * Parities in preorder, so that a subtree is a contiguous range.
          */
-        std::vector<std::shared_ptr<SPNode<Graph, WeightMap>>> _tree_node_map;
+        std::vector<char> _parity;
         /*
          * First vertex in shortest path from root to a vertex.
          */
         std::vector<Vertex> _first_in_path;
+        std::vector<std::size_t> _preorder;
+        std::vector<std::size_t> _position;
+        std::vector<std::size_t> _subtree_size;
+        std::vector<std::size_t> _changed_subtrees;
+
+        /*
+         * Non-tree edge with both endpoints reachable whose tree paths start differently.
+         */
+        bool is_candidate(const Edge &e) const {
+            auto v = boost::source(e, _g);
+            auto u = boost::target(e, _g);
+            if (!is_reachable(v) || !is_reachable(u) || is_tree_edge(e)) {
+                return false;
+            }
+            // shortest paths start with the same vertex, discard
+            return first(v) != first(u);
+        }
 
         void initialize() {
+            std::size_t n = boost::num_vertices(_g);
+
             // run shortest path
-            std::vector<WeightType> dist(boost::num_vertices(_g), (std::numeric_limits<WeightType>::max)());
+            _dist.assign(n, (std::numeric_limits<WeightType>::max)());
             boost::function_property_map<parmcb::detail::VertexIndexFunctor<Graph, WeightType>, Vertex, WeightType&> dist_map(
-                    parmcb::detail::VertexIndexFunctor<Graph, WeightType>(dist, _index_map));
-            std::vector<std::tuple<bool, Edge>> pred(boost::num_vertices(_g), std::make_tuple(false, Edge()));
+                    parmcb::detail::VertexIndexFunctor<Graph, WeightType>(_dist, _index_map));
+            std::vector<std::tuple<bool, Edge>> pred(n, std::make_tuple(false, Edge()));
             boost::function_property_map<parmcb::detail::VertexIndexFunctor<Graph, std::tuple<bool, Edge>>, Vertex,
                     std::tuple<bool, Edge>&> pred_map(
                     parmcb::detail::VertexIndexFunctor<Graph, std::tuple<bool, Edge> >(pred, _index_map));
             lex_dijkstra(_g, _weight_map, _source, dist_map, pred_map);
 
-            // create tree nodes and mapping
+            // parents and children in counting sort order
+            _pred.resize(n);
+            _parent.resize(n);
+            _first_in_path.resize(n);
+            _position.assign(n, npos);
+            _subtree_size.assign(n, 0);
+            std::vector<std::size_t> child_offsets(n + 1, 0);
             VertexIt vi, viend;
             for (boost::tie(vi, viend) = boost::vertices(_g); vi != viend; ++vi) {
                 auto v = *vi;
                 auto vindex = _index_map[v];
-                auto p = boost::get(pred_map, v);
-                if (v == _source) {
-                    _tree_node_map[vindex] = std::shared_ptr<SPNode<Graph, WeightMap>>(
-                            new SPNode<Graph, WeightMap>(v, dist[vindex]));
-                    _root = _tree_node_map[vindex];
-                } else if (std::get<0>(p)) {
-                    Edge e = std::get<1>(p);
-                    _tree_node_map[vindex] = std::shared_ptr<SPNode<Graph, WeightMap>>(
-                            new SPNode<Graph, WeightMap>(v, dist[vindex], e));
+                if (v != _source && std::get<0>(pred[vindex])) {
+                    Edge e = std::get<1>(pred[vindex]);
+                    _pred[vindex] = e;
+                    _parent[vindex] = boost::opposite(e, v, _g);
+                    child_offsets[_index_map[_parent[vindex]] + 1]++;
                 }
             }
-
-            // link tree nodes
+            _dist[_index_map[_source]] = WeightType();
+            for (std::size_t i = 0; i < n; i++) {
+                child_offsets[i + 1] += child_offsets[i];
+            }
+            std::vector<Vertex> children(child_offsets[n]);
+            std::vector<std::size_t> next(child_offsets.begin(), child_offsets.end() - 1);
             for (boost::tie(vi, viend) = boost::vertices(_g); vi != viend; ++vi) {
                 auto v = *vi;
-                auto p = boost::get(pred_map, v);
-                if (std::get<0>(p)) {
-                    auto e = std::get<1>(p);
-                    auto u = boost::opposite(e, v, _g);
-                    auto vindex = _index_map[v];
-                    auto uindex = _index_map[u];
-                    _tree_node_map[uindex]->add_child(_tree_node_map[vindex]);
+                auto vindex = _index_map[v];
+                if (v != _source && std::get<0>(pred[vindex])) {
+                    children[next[_index_map[_parent[vindex]]]++] = v;
                 }
             }
 
-            // compute first in path
-            compute_first_in_path();
-        }
-
-        void compute_first_in_path() {
-            std::stack<SPSubtree<Graph, WeightMap, Vertex>> stack;
-            stack.emplace(_source, _root);
-
+            // preorder, subtree sizes and first in path
+            _preorder.reserve(child_offsets[n] + 1);
+            _parity.assign(child_offsets[n] + 1, 0);
+            std::vector<Vertex> stack;
+            stack.push_back(_source);
             while (!stack.empty()) {
-                SPSubtree<Graph, WeightMap, Vertex> r = stack.top();
-                stack.pop();
-
-                if (r.root == _root) {
-                    auto v = r.root->vertex();
-                    auto vindex = _index_map[v];
+                auto v = stack.back();
+                stack.pop_back();
+                auto vindex = _index_map[v];
+                _position[vindex] = _preorder.size();
+                _preorder.push_back(vindex);
+                if (v == _source) {
+                    _first_in_path[vindex] = v;
+                } else if (_parent[vindex] == _source) {
                     _first_in_path[vindex] = v;
-                    for (auto c : r.root->children()) {
-                        stack.emplace(SPSubtree<Graph, WeightMap, Vertex> { static_cast<Vertex>(c->vertex()), c });
-                    }
                 } else {
-                    auto v = r.root->vertex();
-                    auto vindex = _index_map[v];
-                    _first_in_path[vindex] = r.info;
-                    for (auto c : r.root->children()) {
-                        stack.emplace(SPSubtree<Graph, WeightMap, Vertex> { static_cast<Vertex>(r.info), c });
-                    }
+                    _first_in_path[vindex] = _first_in_path[_index_map[_parent[vindex]]];
+                }
+                for (std::size_t c = child_offsets[vindex + 1]; c > child_offsets[vindex]; c--) {
+                    stack.push_back(children[c - 1]);
+                }
+            }
+            for (std::size_t i = _preorder.size(); i > 0; i--) {
+                auto vindex = _preorder[i - 1];
+                _subtree_size[vindex] += 1;
+                if (i > 1) {
+                    _subtree_size[_index_map[_parent[vindex]]] += _subtree_size[vindex];
                 }
             }
         }
 
     };
 
+    template<class Graph, class WeightMap>
+    constexpr std::size_t SPTree<Graph, WeightMap>::npos;
+
     template<class Graph, class WeightMap>
     class CandidateCycle {
     public:
@@ -388,6 +386,104 @@ namespace parmcb {
         WeightType _weight;
     };
 
+    /*
+     * Builds shortest path trees and their candidate cycles, in parallel when using TBB. Tree
+     * ids follow the order of the sources and candidate cycles are collected per tree and
+     * concatenated in tree order, so that the result does not depend on the scheduling.
+     */
+    template<class Graph, class WeightMap, bool ParallelUsingTBB>
+    class SPTrees {
+    public:
+        typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
+        typedef SPTree<Graph, WeightMap> Tree;
+        typedef CandidateCycle<Graph, WeightMap> Cycle;
+
+        SPTrees(const Graph &g, const WeightMap &weight_map) :
+                g(g), weight_map(weight_map) {
+        }
+
+        /*
+         * Append one tree per source, tree ids continue from the current size of trees.
+         */
+        void build_trees(const std::vector<Vertex> &sources, std::vector<Tree> &trees) const {
+            build(sources, trees);
+        }
+
+        void build_candidate_cycles(const std::vector<Tree> &trees, std::vector<Cycle> &cycles) const {
+            build_candidate_cycles(trees, cycles, [](const Tree &tree) {
+                return tree.create_candidate_cycles();
+            });
+        }
+
+        /*
+         * Append the candidate cycles returned by tree_cycles for each tree.
+         */
+        template<class TreeCycles>
+        void build_candidate_cycles(const std::vector<Tree> &trees, std::vector<Cycle> &cycles,
+                TreeCycles tree_cycles) const {
+            std::vector<std::vector<Cycle>> per_tree(trees.size());
+            for_each_index(trees.size(), [&](std::size_t i) {
+                per_tree[i] = tree_cycles(trees[i]);
+            });
+            std::size_t total = cycles.size();
+            for (const auto &c : per_tree) {
+                total += c.size();
+            }
+            cycles.reserve(total);
+            for (auto &c : per_tree) {
+                cycles.insert(cycles.end(), c.begin(), c.end());
+                std::vector<Cycle>().swap(c);
+            }
+        }
+
+    private:
+        template<bool is_tbb_enabled = ParallelUsingTBB>
+        void build(const std::vector<Vertex> &sources, std::vector<Tree> &trees,
+                typename std::enable_if<!is_tbb_enabled>::type* = 0) const {
+            trees.reserve(trees.size() + sources.size());
+            for (const auto &v : sources) {
+                trees.emplace_back(trees.size(), g, boost::get(boost::vertex_index, g), weight_map, v);
+            }
+        }
+
+        template<class F, bool is_tbb_enabled = ParallelUsingTBB>
+        void for_each_index(std::size_t n, F f, typename std::enable_if<!is_tbb_enabled>::type* = 0) const {
+            for (std::size_t i = 0; i < n; i++) {
+                f(i);
+            }
+        }
+
+#ifdef PARMCB_HAVE_TBB
+        template<bool is_tbb_enabled = ParallelUsingTBB>
+        void build(const std::vector<Vertex> &sources, std::vector<Tree> &trees,
+                typename std::enable_if<is_tbb_enabled>::type* = 0) const {
+            std::size_t first_id = trees.size();
+            std::vector<std::unique_ptr<Tree>> built(sources.size());
+            for_each_index(sources.size(), [&](std::size_t i) {
+                built[i].reset(new Tree(first_id + i, g, boost::get(boost::vertex_index, g), weight_map, sources[i]));
+            });
+            trees.reserve(first_id + sources.size());
+            for (auto &tree : built) {
+                trees.push_back(std::move(*tree));
+                tree.reset();
+            }
+        }
+
+        template<class F, bool is_tbb_enabled = ParallelUsingTBB>
+        void for_each_index(std::size_t n, F f, typename std::enable_if<is_tbb_enabled>::type* = 0) const {
+            // one shortest path computation per index, keep the grain small
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n, 1), [&](const tbb::blocked_range<std::size_t> &r) {
+                for (std::size_t i = r.begin(); i != r.end(); ++i) {
+                    f(i);
+                }
+            });
+        }
+#endif
+
+        const Graph &g;
+        const WeightMap &weight_map;
+    };
+
     template<class Graph>
     struct SerializableCandidateCycle {
         typedef typename boost::graph_traits<Graph>::vertex_descriptor Vertex;
@@ -502,48 +598,34 @@ namespace parmcb {
                 const CandidateCycle<Graph, WeightMap> &c, const std::set<Edge> &signed_edges, bool use_weight_limit,
                 WeightType weight_limit) const {
 
-            std::shared_ptr<SPNode<Graph, WeightMap>> v = trees[c.tree()].node(boost::source(c.edge(), g));
-            std::shared_ptr<SPNode<Graph, WeightMap>> u = trees[c.tree()].node(boost::target(c.edge(), g));
+            const SPTree<Graph, WeightMap> &tree = trees[c.tree()];
 
             Edge e = c.edge();
-            if (v->parity() ^ u->parity() ^ (signed_edges.find(e) != signed_edges.end())) {
-                // odd cycle, validate
-                bool valid = true;
-                WeightType cycle_weight = boost::get(weight_map, e);
-                std::set<Edge> result;
-                result.insert(e);
-
-                if (use_weight_limit && cycle_weight > weight_limit) {
-                    return std::make_tuple(std::set<Edge> { }, 0.0, false);
-                }
-
-                // first part
-                Vertex w = boost::source(c.edge(), g);
-                std::shared_ptr<SPNode<Graph, WeightMap>> ws = trees[c.tree()].node(w);
-                while (ws->has_pred()) {
-                    Edge a = ws->pred();
-                    if (result.insert(a).second == false) {
-                        valid = false;
-                        break;
-                    }
-                    cycle_weight += boost::get(weight_map, a);
-                    if (use_weight_limit && cycle_weight > weight_limit) {
-                        valid = false;
-                        break;
-                    }
-                    w = boost::opposite(a, w, g);
-                    ws = trees[c.tree()].node(w);
-                }
+            if (tree.parity(boost::source(e, g)) ^ tree.parity(boost::target(e, g))
+                    ^ (signed_edges.find(e) != signed_edges.end())) {
+                return validate(tree, e, use_weight_limit, weight_limit);
+            }
+            return std::make_tuple(std::set<Edge> { }, 0.0, false);
+        }
 
-                if (!valid) {
-                    return std::make_tuple(std::set<Edge> { }, 0.0, false);
-                }
+        /*
+         * Build the cycle closed by edge e in the tree, which is known to be odd. The cycle is
+         * invalid if the two tree paths share an edge or it is heavier than the limit.
+         */
+        std::tuple<std::set<Edge>, WeightType, bool> validate(const SPTree<Graph, WeightMap> &tree, const Edge &e,
+                bool use_weight_limit, WeightType weight_limit) const {
+            bool valid = true;
+            WeightType cycle_weight = boost::get(weight_map, e);
+            std::set<Edge> result;
+            result.insert(e);
+
+            if (use_weight_limit && cycle_weight > weight_limit) {
+                return std::make_tuple(std::set<Edge> { }, 0.0, false);
+            }
 
-                // second part
-                w = boost::target(c.edge(), g);
-                ws = trees[c.tree()].node(w);
-                while (ws->has_pred()) {
-                    Edge a = ws->pred();
+            for (Vertex w : { boost::source(e, g), boost::target(e, g) }) {
+                while (valid && tree.has_pred(w)) {
+                    const Edge &a = tree.pred(w);
                     if (result.insert(a).second == false) {
                         valid = false;
                         break;
@@ -553,17 +635,15 @@ namespace parmcb {
                         valid = false;
                         break;
                     }
-                    w = boost::opposite(a, w, g);
-                    ws = trees[c.tree()].node(w);
-                }
-
-                if (!valid) {
-                    return std::make_tuple(std::set<Edge> { }, 0.0, false);
+                    w = tree.parent(w);
                 }
+            }
 
-                return std::make_tuple(result, cycle_weight, true);
+            if (!valid) {
+                return std::make_tuple(std::set<Edge> { }, 0.0, false);
             }
-            return std::make_tuple(std::set<Edge> { }, 0.0, false);
+
+            return std::make_tuple(result, cycle_weight, true);
         }
 
     private:
@@ -571,6 +651,99 @@ namespace parmcb {
         const WeightMap &weight_map;
     };
 
+    /*
+     * Candidate cycles stored as a structure of arrays: the tree, the preorder positions of
+     * the edge endpoints in the tree, the edge id, the weight and the edge. The parity of a
+     * candidate only needs the arrays, so that the odd candidates of a range are found with a
+     * branchless gather pass before any cycle is built. The trees must not be moved while the
+     * store is in use.
+     */
+    template<class Graph, class WeightMap>
+    class CandidateCycleStore {
+    public:
+        typedef typename boost::graph_traits<Graph>::edge_descriptor Edge;
+        typedef typename boost::property_traits<WeightMap>::value_type WeightType;
+        typedef typename parmcb::detail::ForestIndexDefaultEdgeIndex<Graph>::type EdgeIndexMap;
+
+        CandidateCycleStore(const Graph &g, const std::vector<parmcb::SPTree<Graph, WeightMap>> &trees,
+                const std::vector<CandidateCycle<Graph, WeightMap>> &cycles) :
+                _edge_index(parmcb::detail::ForestIndexDefaultEdgeIndex<Graph>::make(g)) {
+            for (const auto &tree : trees) {
+                _parities.push_back(tree.parity_data());
+            }
+            std::size_t n = cycles.size();
+            _tree.reserve(n);
+            _source_position.reserve(n);
+            _target_position.reserve(n);
+            _edge_id.reserve(n);
+            _weight.reserve(n);
+            _edge.reserve(n);
+            for (const auto &c : cycles) {
+                const auto &tree = trees[c.tree()];
+                _tree.push_back(c.tree());
+                _source_position.push_back(tree.position(boost::source(c.edge(), g)));
+                _target_position.push_back(tree.position(boost::target(c.edge(), g)));
+                _edge_id.push_back(boost::get(_edge_index, c.edge()));
+                _weight.push_back(c.weight());
+                _edge.push_back(c.edge());
+            }
+        }
+
+        std::size_t size() const {
+            return _tree.size();
+        }
+
+        std::size_t tree(std::size_t i) const {
+            return _tree[i];
+        }
+
+        const Edge& edge(std::size_t i) const {
+            return _edge[i];
+        }
+
+        const WeightType& weight(std::size_t i) const {
+            return _weight[i];
+        }
+
+        const EdgeIndexMap& edge_index() const {
+            return _edge_index;
+        }
+
+        /*
+         * Write the indices of the odd candidates in [first, last) to odd, which must have
+         * room for last - first values, and return their number. Signed edges are given as
+         * flags indexed by edge id.
+         */
+        std::size_t filter_odd(std::size_t first, std::size_t last, const std::vector<char> &signed_flags,
+                std::size_t *odd) const {
+            const char *const *parities = _parities.data();
+            const std::size_t *tree = _tree.data();
+            const std::size_t *source_position = _source_position.data();
+            const std::size_t *target_position = _target_position.data();
+            const std::size_t *edge_id = _edge_id.data();
+            const char *flags = signed_flags.data();
+
+            std::size_t count = 0;
+            for (std::size_t i = first; i < last; i++) {
+                const char *parity = parities[tree[i]];
+                char is_odd = parity[source_position[i]] ^ parity[target_position[i]] ^ flags[edge_id[i]];
+                odd[count] = i;
+                count += is_odd;
+            }
+            return count;
+        }
+
+    private:
+        EdgeIndexMap _edge_index;
+        std::vector<const char*> _parities;
+        std::vector<std::size_t> _tree;
+        std::vector<std::size_t> _source_position;
+        std::vector<std::size_t> _target_position;
+        std::vector<std::size_t> _edge_id;
+        std::vector<WeightType> _weight;
+        std::vector<Edge> _edge;
+    };
+
     template<class Graph, class WeightMap, bool ParallelUsingTBB>
     class ShortestOddCycleLookup {
     public:
@@ -580,9 +753,11 @@ namespace parmcb {
 
         ShortestOddCycleLookup(const Graph &g, const WeightMap &weight_map,
                 std::vector<parmcb::SPTree<Graph, WeightMap>> &trees,
-                std::vector<parmcb::CandidateCycle<Graph, WeightMap>> &cycles, bool sorted_cycles) :
-                g(g), weight_map(weight_map), candidate_cycle_builder(g, weight_map), trees(trees), cycles(cycles), sorted_cycles(
-                        sorted_cycles) {
+                const std::vector<parmcb::CandidateCycle<Graph, WeightMap>> &cycles, bool sorted_cycles,
+                bool incremental_parities = true) :
+                g(g), weight_map(weight_map), candidate_cycle_builder(g, weight_map), trees(trees), cycles(g, trees,
+                        cycles), sorted_cycles(sorted_cycles), incremental_parities(incremental_parities), has_previous_edges(
+                        false), signed_flags(boost::num_edges(g), 0) {
         }
 
         std::tuple<std::set<Edge>, WeightType, bool> operator()(const std::set<Edge> &edges) {
@@ -590,48 +765,134 @@ namespace parmcb {
         }
 
     private:
+        /*
+         * Candidates filtered for parity at once when scanning sequentially.
+         */
+        static constexpr std::size_t chunk_size = 4096;
 
-        template<bool is_tbb_enabled = ParallelUsingTBB>
-        std::tuple<std::set<Edge>, WeightType, bool> compute_shortest_odd_cycle(const std::set<Edge> &edges,
-                typename std::enable_if<!is_tbb_enabled>::type* = 0) {
+        /*
+         * Candidates per task in the ordered parallel scan.
+         */
+        static constexpr std::size_t parallel_chunk_size = 1024;
 
-            for (std::size_t i = 0; i < trees.size(); i++) {
-                trees[i].update_parities(edges);
+        /*
+         * Compute the symmetric difference with the signed edges of the previous call and
+         * decide whether the trees can be updated incrementally. Large differences fall back
+         * to a full recompute of the parities.
+         */
+        bool prepare_parity_update(const std::set<Edge> &edges) {
+            bool incremental = incremental_parities && has_previous_edges;
+            changed_edges.clear();
+            if (incremental) {
+                std::set_symmetric_difference(previous_edges.begin(), previous_edges.end(), edges.begin(),
+                        edges.end(), std::back_inserter(changed_edges));
+                incremental = 2 * changed_edges.size() <= boost::num_vertices(g);
+            }
+            if (incremental_parities) {
+                previous_edges = edges;
+                has_previous_edges = true;
             }
+            return incremental;
+        }
 
-            std::tuple<std::set<Edge>, WeightType, bool> min;
+        void update_parities(std::size_t i, const std::set<Edge> &edges, bool incremental) {
+            if (incremental) {
+                trees[i].update_parities(edges, changed_edges);
+            } else {
+                trees[i].update_parities(edges);
+            }
+        }
 
-            for (CandidateCycle<Graph, WeightMap> c : cycles) {
-                std::tuple<std::set<Edge>, WeightType, bool> cc = candidate_cycle_builder(trees, c, edges,
-                        std::get<2>(min), std::get<1>(min));
+        void update_signed_flags(const std::set<Edge> &edges) {
+            for (auto id : signed_ids) {
+                signed_flags[id] = 0;
+            }
+            signed_ids.clear();
+            for (const auto &e : edges) {
+                auto id = boost::get(cycles.edge_index(), e);
+                signed_flags[id] = 1;
+                signed_ids.push_back(id);
+            }
+        }
 
-                if (std::get<2>(cc)) {
+        /*
+         * Validate the odd candidates of [first, last), in order, and keep the lightest valid
+         * cycle in min. Stops at the first valid cycle when the candidates are sorted, or when
+         * stop() returns true.
+         */
+        template<class Stop>
+        void scan(std::size_t first, std::size_t last, std::vector<std::size_t> &odd,
+                std::tuple<std::set<Edge>, WeightType, bool> &min, Stop stop) const {
+            odd.resize(last - first);
+            std::size_t count = cycles.filter_odd(first, last, signed_flags, odd.data());
+            for (std::size_t k = 0; k < count; k++) {
+                std::size_t i = odd[k];
+                if (std::get<2>(min) && !(cycles.weight(i) < std::get<1>(min))) {
                     if (sorted_cycles) {
-                        return cc;
+                        return;
                     }
-
-                    if (!std::get<2>(min)) {
+                    continue;
+                }
+                if (stop()) {
+                    return;
+                }
+                auto cc = candidate_cycle_builder.validate(trees[cycles.tree(i)], cycles.edge(i), std::get<2>(min),
+                        std::get<1>(min));
+                if (std::get<2>(cc)) {
+                    if (!std::get<2>(min) || std::get<1>(cc) < std::get<1>(min)) {
                         min = cc;
-                    } else {
-                        if (std::get<1>(cc) < std::get<1>(min)) {
-                            min = cc;
-                        }
+                    }
+                    if (sorted_cycles) {
+                        return;
                     }
                 }
             }
+        }
+
+        void scan(std::size_t first, std::size_t last, std::vector<std::size_t> &odd,
+                std::tuple<std::set<Edge>, WeightType, bool> &min) const {
+            scan(first, last, odd, min, []() {
+                return false;
+            });
+        }
+
+        template<bool is_tbb_enabled = ParallelUsingTBB>
+        std::tuple<std::set<Edge>, WeightType, bool> compute_shortest_odd_cycle(const std::set<Edge> &edges,
+                typename std::enable_if<!is_tbb_enabled>::type* = 0) {
+
+            bool incremental = prepare_parity_update(edges);
+            for (std::size_t i = 0; i < trees.size(); i++) {
+                update_parities(i, edges, incremental);
+            }
+            update_signed_flags(edges);
+
+            std::tuple<std::set<Edge>, WeightType, bool> min;
+            for (std::size_t first = 0; first < cycles.size(); first += chunk_size) {
+                scan(first, (std::min)(first + chunk_size, cycles.size()), odd_buffer, min);
+                if (sorted_cycles && std::get<2>(min)) {
+                    break;
+                }
+            }
             return min;
         }
 
+#ifdef PARMCB_HAVE_TBB
         template<bool is_tbb_enabled = ParallelUsingTBB>
         std::tuple<std::set<Edge>, WeightType, bool> compute_shortest_odd_cycle(const std::set<Edge> &edges,
                 typename std::enable_if<is_tbb_enabled>::type* = 0) {
 
+            bool incremental = prepare_parity_update(edges);
             tbb::parallel_for(tbb::blocked_range<std::size_t>(0, trees.size()),
                     [&](const tbb::blocked_range<std::size_t> &r) {
                         for (std::size_t i = r.begin(); i != r.end(); ++i) {
-                            trees[i].update_parities(edges);
+                            update_parities(i, edges, incremental);
                         }
                     });
+            update_signed_flags(edges);
+
+            if (sorted_cycles) {
+                return ordered_scan();
+            }
 
             std::less<WeightType> compare = std::less<WeightType>();
             typedef std::tuple<std::set<Edge>, WeightType, bool> cycle_t;
@@ -653,29 +914,101 @@ namespace parmcb {
             return tbb::parallel_reduce(tbb::blocked_range<std::size_t>(0, cycles.size()),
                     std::make_tuple(std::set<Edge>(), (std::numeric_limits<WeightType>::max)(), false),
                     [&](tbb::blocked_range<std::size_t> r, auto running_min) {
-                        for (std::size_t i = r.begin(); i < r.end(); i++) {
-                            auto c = cycles[i];
-                            auto cc = candidate_cycle_builder(trees, c, edges, std::get<2>(running_min),
-                                    std::get<1>(running_min));
-                            if (std::get<2>(cc)) {
-                                if (!std::get<2>(running_min) || compare(std::get<1>(cc), std::get<1>(running_min))) {
-                                    running_min = cc;
-                                }
-                            }
-                        }
+                        std::vector<std::size_t> odd;
+                        scan(r.begin(), r.end(), odd, running_min);
                         return running_min;
                     },
                     cycle_min);
         }
 
+        /*
+         * Search the weight sorted candidates in chunks. Waves of consecutive chunks are
+         * processed in parallel in increasing order. Since the candidates are sorted, the
+         * answer is the first valid cycle of the first chunk which has one, exactly as in the
+         * sequential scan. Chunks after it stop early, and once all chunks before it are done
+         * the remaining tasks of the wave are cancelled and no further wave is started.
+         */
+        std::tuple<std::set<Edge>, WeightType, bool> ordered_scan() {
+            typedef std::tuple<std::set<Edge>, WeightType, bool> cycle_t;
+
+            std::size_t n = cycles.size();
+            std::size_t num_chunks = (n + parallel_chunk_size - 1) / parallel_chunk_size;
+            std::size_t wave = 2 * static_cast<std::size_t>(tbb::this_task_arena::max_concurrency());
+
+            cycle_t best;
+            std::atomic<std::size_t> best_chunk(num_chunks);
+            std::mutex best_mutex;
+            std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[wave]());
+
+            for (std::size_t first_chunk = 0; first_chunk < num_chunks && best_chunk.load() == num_chunks;
+                    first_chunk += wave) {
+                std::size_t last_chunk = (std::min)(first_chunk + wave, num_chunks);
+                for (std::size_t c = 0; c < wave; c++) {
+                    done[c].store(false, std::memory_order_relaxed);
+                }
+
+                tbb::task_group_context context;
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(first_chunk, last_chunk, 1),
+                        [&](const tbb::blocked_range<std::size_t> &r) {
+                            std::vector<std::size_t> odd;
+                            for (std::size_t c = r.begin(); c != r.end(); ++c) {
+                                auto stop = [&]() {
+                                    return c > best_chunk.load(std::memory_order_relaxed)
+                                            || context.is_group_execution_cancelled();
+                                };
+                                if (!stop()) {
+                                    cycle_t local;
+                                    std::size_t first = c * parallel_chunk_size;
+                                    scan(first, (std::min)(first + parallel_chunk_size, n), odd, local, stop);
+                                    if (std::get<2>(local)) {
+                                        std::lock_guard<std::mutex> lock(best_mutex);
+                                        if (c < best_chunk.load(std::memory_order_relaxed)) {
+                                            best = std::move(local);
+                                            best_chunk.store(c);
+                                        }
+                                    }
+                                }
+                                done[c - first_chunk].store(true, std::memory_order_release);
+
+                                std::size_t b = best_chunk.load();
+                                if (b < last_chunk) {
+                                    bool prefix_done = true;
+                                    for (std::size_t p = first_chunk; p < b && prefix_done; p++) {
+                                        prefix_done = done[p - first_chunk].load(std::memory_order_acquire);
+                                    }
+                                    if (prefix_done) {
+                                        context.cancel_group_execution();
+                                    }
+                                }
+                            }
+                        }, tbb::simple_partitioner(), context);
+            }
+            return best;
+        }
+#endif
+
         const Graph &g;
         const WeightMap &weight_map;
         const CandidateCycleBuilder<Graph, WeightMap> candidate_cycle_builder;
         std::vector<parmcb::SPTree<Graph, WeightMap>> &trees;
-        std::vector<parmcb::CandidateCycle<Graph, WeightMap>> &cycles;
+        const CandidateCycleStore<Graph, WeightMap> cycles;
         bool sorted_cycles;
+        bool incremental_parities;
+        bool has_previous_edges;
+        std::set<Edge> previous_edges;
+        std::vector<Edge> changed_edges;
+        std::vector<char> signed_flags;
+        std::vector<std::size_t> signed_ids;
+        std::vector<std::size_t> odd_buffer;
     };
 
+    template<class Graph, class WeightMap, bool ParallelUsingTBB>
+    constexpr std::size_t ShortestOddCycleLookup<Graph, WeightMap, ParallelUsingTBB>::chunk_size;
+
+    template<class Graph, class WeightMap, bool ParallelUsingTBB>
+    constexpr std::size_t ShortestOddCycleLookup<Graph, WeightMap, ParallelUsingTBB>::parallel_chunk_size;
+
+
 } // parmcb
 
 #endif
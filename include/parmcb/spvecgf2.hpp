@@ -9,12 +9,137 @@
 #include <vector>
 #include <set>
 #include <iostream>
+#include <iterator>
 #include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
 
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/split_member.hpp>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
 namespace parmcb {
 
+    namespace detail {
+
+        /*
+         * Word kernels for bit-packed GF(2) vectors.
+         */
+
+        inline std::size_t popcount64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(x);
+#else
+            std::size_t c = 0;
+            for (; x; x &= x - 1) {
+                c++;
+            }
+            return c;
+#endif
+        }
+
+        inline std::size_t ctz64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(x);
+#else
+            std::size_t bit = 0;
+            while (!((x >> bit) & 1)) {
+                bit++;
+            }
+            return bit;
+#endif
+        }
+
+        /*
+         * dst[i] ^= src[i] for i in [0, n), returns the number of positions set in both before
+         * the update, from which the new number of ones follows as |dst| + |src| - 2 * common.
+         */
+        inline std::size_t xor_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+            std::size_t common = 0;
+            std::size_t i = 0;
+#if defined(__AVX512F__)
+            alignas(64) std::uint64_t lanes[8];
+            for (; i + 8 <= n; i += 8) {
+                __m512i a = _mm512_loadu_si512(reinterpret_cast<const void*>(dst + i));
+                __m512i b = _mm512_loadu_si512(reinterpret_cast<const void*>(src + i));
+                _mm512_store_si512(reinterpret_cast<void*>(lanes), _mm512_and_si512(a, b));
+                _mm512_storeu_si512(reinterpret_cast<void*>(dst + i), _mm512_xor_si512(a, b));
+                for (int l = 0; l < 8; l++) {
+                    common += popcount64(lanes[l]);
+                }
+            }
+#elif defined(__AVX2__)
+            alignas(32) std::uint64_t lanes[4];
+            for (; i + 4 <= n; i += 4) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_and_si256(a, b));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, b));
+                for (int l = 0; l < 4; l++) {
+                    common += popcount64(lanes[l]);
+                }
+            }
+#endif
+            for (; i < n; i++) {
+                common += popcount64(dst[i] & src[i]);
+                dst[i] ^= src[i];
+            }
+            return common;
+        }
+
+        /*
+         * Parity of the number of common ones of a and b. The parity of a sum of popcounts
+         * equals the parity of the popcount of the xor, so a single popcount suffices.
+         */
+        inline int and_parity_words(const std::uint64_t *a, const std::uint64_t *b, std::size_t n) {
+            std::size_t i = 0;
+            std::uint64_t acc = 0;
+#if defined(__AVX512F__)
+            __m512i vacc = _mm512_setzero_si512();
+            for (; i + 8 <= n; i += 8) {
+                __m512i x = _mm512_loadu_si512(reinterpret_cast<const void*>(a + i));
+                __m512i y = _mm512_loadu_si512(reinterpret_cast<const void*>(b + i));
+                vacc = _mm512_xor_si512(vacc, _mm512_and_si512(x, y));
+            }
+            alignas(64) std::uint64_t lanes[8];
+            _mm512_store_si512(reinterpret_cast<void*>(lanes), vacc);
+            for (int l = 0; l < 8; l++) {
+                acc ^= lanes[l];
+            }
+#elif defined(__AVX2__)
+            __m256i vacc = _mm256_setzero_si256();
+            for (; i + 4 <= n; i += 4) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                vacc = _mm256_xor_si256(vacc, _mm256_and_si256(x, y));
+            }
+            alignas(32) std::uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), vacc);
+            for (int l = 0; l < 4; l++) {
+                acc ^= lanes[l];
+            }
+#endif
+            for (; i < n; i++) {
+                acc ^= a[i] & b[i];
+            }
+            return static_cast<int>(popcount64(acc) & 1);
+        }
+
+    } // detail
+
+    /*
+     * Vector over GF(2). Sparse vectors keep the sorted positions of their ones, dense vectors
+     * a bitset of 64-bit words. The representation switches automatically after additions,
+     * going dense when at least 1/DENSE_RATIO of the positions up to the largest one are set
+     * and back to sparse below 1/SPARSE_RATIO.
+     *
+     * Iterating a dense vector materializes the sorted positions on first use and caches them
+     * until the next modification. That first iteration must not race with another one.
+     */
     template<typename U>
     class SpVecGF2 {
 
@@ -23,45 +148,60 @@ namespace parmcb {
         typedef typename std::vector<U>::size_type size_type;
         typedef typename std::vector<U>::const_iterator const_iterator;
 
-        SpVecGF2() {
+        static constexpr size_type DENSE_RATIO = 32;
+        static constexpr size_type SPARSE_RATIO = 128;
+
+        SpVecGF2() :
+                dense(false), count(0), cached(false) {
         }
 
-        SpVecGF2(const U &i) {
+        SpVecGF2(const U &i) :
+                dense(false), count(1), cached(false) {
             ones.push_back(i);
         }
 
-        SpVecGF2(const SpVecGF2<U> &v) {
-            ones = v.ones;
-        }
+        SpVecGF2(const SpVecGF2<U> &v) = default;
 
-        SpVecGF2(const SpVecGF2<U> &&v) {
-            ones = std::move(v.ones);
+        SpVecGF2(SpVecGF2<U> &&v) noexcept :
+                dense(v.dense), ones(std::move(v.ones)), words(std::move(v.words)), count(v.count), cached(
+                        v.cached) {
+            v.clear();
         }
 
-        SpVecGF2(const std::set<U> &v) {
+        SpVecGF2(const std::set<U> &v) :
+                dense(false), count(v.size()), cached(false) {
             std::copy(v.begin(), v.end(), std::back_inserter(ones));
+            update_representation();
         }
 
         ~SpVecGF2(void) {
         }
 
-        SpVecGF2<U>& operator=(const SpVecGF2<U> &v) {
-            if (this == &v) {
-                return *this;
-            }
-            ones = v.ones;
-            return *this;
-        }
+        SpVecGF2<U>& operator=(const SpVecGF2<U> &v) = default;
 
-        SpVecGF2<U>& operator=(const SpVecGF2<U> &&v) {
+        SpVecGF2<U>& operator=(SpVecGF2<U> &&v) noexcept {
             if (this == &v) {
                 return *this;
             }
+            dense = v.dense;
             ones = std::move(v.ones);
+            words = std::move(v.words);
+            count = v.count;
+            cached = v.cached;
+            v.clear();
             return *this;
         }
 
         int operator*(const SpVecGF2<U> &v) const {
+            if (dense && v.dense) {
+                return detail::and_parity_words(words.data(), v.words.data(),
+                        (std::min)(words.size(), v.words.size()));
+            } else if (dense) {
+                return v.sparse_dot_dense(*this);
+            } else if (v.dense) {
+                return sparse_dot_dense(v);
+            }
+
             int res = 0;
 
             auto it = ones.begin(), it_e = ones.end();
@@ -86,6 +226,13 @@ namespace parmcb {
         int operator*(const std::set<U> &v) const {
             int res = 0;
 
+            if (dense) {
+                for (const auto &index : v) {
+                    res ^= test(index);
+                }
+                return res;
+            }
+
             auto it = ones.begin(), it_e = ones.end();
             auto v_it = v.begin(), v_it_e = v.end();
 
@@ -106,82 +253,284 @@ namespace parmcb {
         }
 
         SpVecGF2<U> operator+(const SpVecGF2<U> &v) const {
-            SpVecGF2<U> res;
-            auto it = ones.begin(), it_e = ones.end();
-            auto v_it = v.ones.begin(), v_it_e = v.ones.end();
-
-            // now add them
-            while (it != it_e && v_it != v_it_e) {
-                U index = *it;
-                U v_index = *v_it;
-
-                if (index > v_index) {
-                    res.ones.push_back(v_index);
-                    v_it++;
-                } else if (index < v_index) {
-                    res.ones.push_back(index);
-                    it++;
-                } else {
-                    // 1 + 1 = 0, don't add anything
-                    it++;
-                    v_it++;
-                }
-            }
-
-            // append remaining stuff
-            while (it != it_e) {
-                res.ones.push_back(*it);
-                it++;
-            }
-            while (v_it != v_it_e) {
-                res.ones.push_back(*v_it);
-                v_it++;
-            }
-
+            SpVecGF2<U> res(*this);
+            res += v;
             return res;
         }
 
         SpVecGF2<U>& operator+=(const SpVecGF2<U> &v) {
-            *this = *this + v;
+            if (dense && v.dense) {
+                if (words.size() < v.words.size()) {
+                    words.resize(v.words.size(), 0);
+                }
+                std::size_t common = detail::xor_words(words.data(), v.words.data(), v.words.size());
+                count = count + v.count - 2 * common;
+                cached = false;
+            } else if (dense) {
+                for (const auto &index : v.ones) {
+                    flip(index);
+                }
+                cached = false;
+            } else if (v.dense) {
+                std::vector<U> own_ones = std::move(ones);
+                ones.clear();
+                words = v.words;
+                count = v.count;
+                dense = true;
+                cached = false;
+                for (const auto &index : own_ones) {
+                    flip(index);
+                }
+            } else {
+                ones = sparse_sum(ones, v.ones);
+                count = ones.size();
+            }
+            update_representation();
             return *this;
         }
 
         void add(U pos) {
-            assert(ones.empty() || pos >= *(ones.end()));
+            if (dense) {
+                assert(!test(pos));
+                flip(pos);
+                cached = false;
+                return;
+            }
+            assert(ones.empty() || pos > ones.back());
 
             ones.push_back(pos);
+            count++;
         }
 
         size_type size() const {
-            return ones.size();
+            return count;
+        }
+
+        bool is_dense() const {
+            return dense;
         }
 
         const_iterator begin() const
         {
+            materialize();
             return ones.begin();
         }
 
         const_iterator end() const
         {
+            materialize();
             return ones.end();
         }
 
+        /*
+         * Call f on each position of a one, in increasing order, without materializing
+         * the positions of a dense vector.
+         */
+        template<class F>
+        void for_each(F f) const {
+            if (!dense) {
+                for (const auto &index : ones) {
+                    f(index);
+                }
+                return;
+            }
+            for (std::size_t w = 0; w < words.size(); w++) {
+                std::uint64_t word = words[w];
+                while (word) {
+                    f(static_cast<U>(w * 64 + detail::ctz64(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        /*
+         * Add this vector to the bit-packed vector given by n words. Positions beyond
+         * the n words are ignored.
+         */
+        void xor_into(std::uint64_t *out, std::size_t n) const {
+            if (dense) {
+                std::size_t common = (std::min)(n, words.size());
+                for (std::size_t w = 0; w < common; w++) {
+                    out[w] ^= words[w];
+                }
+                return;
+            }
+            for (const auto &index : ones) {
+                if (static_cast<std::size_t>(index >> 6) < n) {
+                    out[index >> 6] ^= std::uint64_t(1) << (index & 63);
+                }
+            }
+        }
+
+        /*
+         * Add a vector given as n bit-packed words.
+         */
+        void add_words(const std::uint64_t *in, std::size_t n) {
+            if (!dense) {
+                std::vector<U> own_ones = std::move(ones);
+                ones.clear();
+                std::size_t own_words = own_ones.empty() ? 0 : (static_cast<std::size_t>(own_ones.back()) >> 6) + 1;
+                words.assign((std::max)(n, own_words), 0);
+                for (const auto &index : own_ones) {
+                    words[index >> 6] |= std::uint64_t(1) << (index & 63);
+                }
+                dense = true;
+            } else if (words.size() < n) {
+                words.resize(n, 0);
+            }
+            std::size_t in_count = 0;
+            for (std::size_t w = 0; w < n; w++) {
+                in_count += detail::popcount64(in[w]);
+            }
+            std::size_t common = detail::xor_words(words.data(), in, n);
+            count = count + in_count - 2 * common;
+            cached = false;
+            update_representation();
+        }
+
         void clear() {
+            dense = false;
             ones.clear();
+            words.clear();
+            count = 0;
+            cached = false;
         }
 
     private:
         friend class boost::serialization::access;
 
         template<class Archive>
-        void serialize(Archive & ar, const unsigned int version)
+        void save(Archive & ar, const unsigned int version) const
+        {
+          materialize();
+          ar & ones;
+        }
+
+        template<class Archive>
+        void load(Archive & ar, const unsigned int version)
         {
+          clear();
           ar & ones;
+          count = ones.size();
+          update_representation();
         }
 
-        std::vector<U> ones;
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+        static std::vector<U> sparse_sum(const std::vector<U> &a, const std::vector<U> &b) {
+            std::vector<U> res;
+            res.reserve(a.size() + b.size());
+            auto it = a.begin(), it_e = a.end();
+            auto v_it = b.begin(), v_it_e = b.end();
+
+            // now add them
+            while (it != it_e && v_it != v_it_e) {
+                U index = *it;
+                U v_index = *v_it;
+
+                if (index > v_index) {
+                    res.push_back(v_index);
+                    v_it++;
+                } else if (index < v_index) {
+                    res.push_back(index);
+                    it++;
+                } else {
+                    // 1 + 1 = 0, don't add anything
+                    it++;
+                    v_it++;
+                }
+            }
+
+            // append remaining stuff
+            res.insert(res.end(), it, it_e);
+            res.insert(res.end(), v_it, v_it_e);
+
+            return res;
+        }
+
+        int sparse_dot_dense(const SpVecGF2<U> &v) const {
+            int res = 0;
+            for (const auto &index : ones) {
+                res ^= v.test(index);
+            }
+            return res;
+        }
+
+        int test(const U &index) const {
+            std::size_t w = index >> 6;
+            return w < words.size() ? static_cast<int>((words[w] >> (index & 63)) & 1) : 0;
+        }
+
+        void flip(const U &index) {
+            std::size_t w = index >> 6;
+            if (w >= words.size()) {
+                words.resize(w + 1, 0);
+            }
+            std::uint64_t mask = std::uint64_t(1) << (index & 63);
+            words[w] ^= mask;
+            if (words[w] & mask) {
+                count++;
+            } else {
+                count--;
+            }
+        }
+
+        /*
+         * Switch representation if the density crossed one of the thresholds.
+         */
+        void update_representation() {
+            if (dense) {
+                while (!words.empty() && words.back() == 0) {
+                    words.pop_back();
+                }
+                if (count * SPARSE_RATIO < words.size() * 64) {
+                    materialize();
+                    words.clear();
+                    words.shrink_to_fit();
+                    dense = false;
+                    cached = false;
+                }
+            } else if (!ones.empty() && count * DENSE_RATIO >= static_cast<size_type>(ones.back()) + 1) {
+                words.assign((static_cast<size_type>(ones.back()) >> 6) + 1, 0);
+                for (const auto &index : ones) {
+                    words[index >> 6] |= std::uint64_t(1) << (index & 63);
+                }
+                ones.clear();
+                dense = true;
+                cached = false;
+            }
+        }
+
+        void materialize() const {
+            if (!dense || cached) {
+                return;
+            }
+            ones.clear();
+            ones.reserve(count);
+            for (std::size_t w = 0; w < words.size(); w++) {
+                std::uint64_t word = words[w];
+                while (word) {
+                    ones.push_back(static_cast<U>(w * 64 + detail::ctz64(word)));
+                    word &= word - 1;
+                }
+            }
+            cached = true;
+        }
+
+        bool dense;
+        // sorted positions of the ones, in dense mode a cache filled by materialize()
+        mutable std::vector<U> ones;
+        std::vector<std::uint64_t> words;
+        size_type count;
+        mutable bool cached;
     };
 
+    template<typename U>
+    constexpr typename SpVecGF2<U>::size_type SpVecGF2<U>::DENSE_RATIO;
+
+    template<typename U>
+    constexpr typename SpVecGF2<U>::size_type SpVecGF2<U>::SPARSE_RATIO;
+
     template<typename U>
     std::ostream& operator<<(std::ostream &o, const SpVecGF2<U> &v) {
         if (v.size() > 0)
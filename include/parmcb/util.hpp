@@ -16,6 +16,7 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/property_map/property_map.hpp>
 
+#include <parmcb/detail/csr_graph.hpp>
 #include <parmcb/forestindex.hpp>
 
 #define BUFFER_SIZE 1024
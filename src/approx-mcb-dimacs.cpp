@@ -41,6 +41,8 @@ int main(int argc, char *argv[]) {
                 ("parallel,p", po::value<bool>()->default_value(true), "Use parallelization")
                 ("printcycles", po::value<bool>()->default_value(false)->implicit_value(true), "Print cycles")
                 ("cores", po::value<int>()->default_value(0), "Number of cores")
+                ("numa-node", po::value<int>()->default_value(-1), "Run on the cores of this NUMA node")
+                ("pin-threads", po::value<bool>()->default_value(false)->implicit_value(true), "Bind each thread to a single core")
                 ("input-file,I",po::value<std::string>(), "Input filename");
         // @formatter:on
         po::positional_options_description pos_desc;
@@ -110,6 +112,7 @@ int main(int argc, char *argv[]) {
     if (vm.count("cores")) {
         cores = vm["cores"].as<int>();
     }
+    parmcb::execution_context context(cores, vm["numa-node"].as<int>(), vm["pin-threads"].as<bool>());
     if (cores == 0) {
         cores = boost::thread::hardware_concurrency();
     }
@@ -126,7 +129,7 @@ int main(int argc, char *argv[]) {
 #ifdef PARMCB_HAVE_TBB
             std::cout << "Using APPROX_MCB_SVA_SIGNED_TBB" << std::endl;
             mcb_weight = parmcb::approx_mcb_sva_signed_tbb(graph, get(boost::edge_weight, graph), k, std::back_inserter(cycles),
-                    cores);
+                    context);
 #else
             std::cerr << "TBB not supported, bailing out." << std::endl;
 #endif
@@ -139,7 +142,7 @@ int main(int argc, char *argv[]) {
 #ifdef PARMCB_HAVE_TBB
             std::cout << "Using APPROX_MCB_SVA_FSV_TREES_TBB" << std::endl;
             mcb_weight = parmcb::approx_mcb_sva_fvs_trees_tbb(graph, get(boost::edge_weight, graph), k, std::back_inserter(cycles),
-                    cores);
+                    context);
 #else
             std::cerr << "TBB not supported, bailing out." << std::endl;
 #endif
@@ -151,7 +154,7 @@ int main(int argc, char *argv[]) {
         if (vm["parallel"].as<bool>()) {
 #ifdef PARMCB_HAVE_TBB
             std::cout << "Using APPROX_MCB_SVA_ISO_TREES_TBB" << std::endl;
-                    mcb_weight = parmcb::approx_mcb_sva_iso_trees_tbb(graph, get(boost::edge_weight, graph), k, std::back_inserter(cycles), cores);
+                    mcb_weight = parmcb::approx_mcb_sva_iso_trees_tbb(graph, get(boost::edge_weight, graph), k, std::back_inserter(cycles), context);
 #else
             std::cerr << "TBB not supported, bailing out." << std::endl;
 #endif
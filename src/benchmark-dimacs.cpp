@@ -0,0 +1,459 @@
+//    Copyright (C) Dimitrios Michail 2019 - 2023.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/program_options.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <parmcb/config.hpp>
+#include <parmcb/forestindex.hpp>
+#include <parmcb/detail/edge_bitmap.hpp>
+#include <parmcb/detail/landmarks.hpp>
+#include <parmcb/detail/signed_dijkstra.hpp>
+#include <parmcb/detail/support_vectors.hpp>
+#include <parmcb/util.hpp>
+
+using namespace boost;
+namespace po = boost::program_options;
+
+#define USAGE "Micro-benchmarks of the building blocks of the minimum cycle basis algorithms on a graph given in DIMACS format."
+
+typedef adjacency_list<vecS, vecS, undirectedS, no_property, property<edge_weight_t, double> > graph_t;
+typedef graph_traits<graph_t>::edge_descriptor edge_descriptor;
+typedef property_map<graph_t, edge_weight_t>::const_type weight_map_t;
+typedef parmcb::ForestIndexEdgeIdMap<graph_t> edge_id_map_t;
+
+/*
+ * Relaxation throughput of the signed graph searches, using set and bitmap membership
+ * of the signed and hidden edges. The searches are the ones performed when the number of
+ * signed edges is small compared to the number of vertices.
+ */
+void benchmark_relaxation(const graph_t &graph, std::size_t signed_count, std::size_t rounds, std::mt19937 &rng) {
+    weight_map_t weight = get(boost::edge_weight, graph);
+    parmcb::ForestIndex<graph_t> forest_index(graph);
+    auto csd = forest_index.cycle_space_dimension();
+    if (csd == 0) {
+        std::cout << "Graph is a forest, nothing to measure" << std::endl;
+        return;
+    }
+
+    // random subset of the non-forest edges, as in a support vector
+    std::vector<std::size_t> ids(csd);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(std::min(std::max(signed_count, std::size_t(1)), csd));
+    std::sort(ids.begin(), ids.end());
+    std::cout << "Signed edges: " << ids.size() << std::endl;
+
+    parmcb::SignedDijkstraWorkspace<graph_t, weight_map_t> workspace(graph);
+
+    // set membership
+    std::set<edge_descriptor> signed_edges;
+    parmcb::convert_edges(ids, std::inserter(signed_edges, signed_edges.end()), forest_index);
+    double set_total = 0.0;
+    workspace.reset_statistics();
+    boost::timer::cpu_timer set_timer;
+    for (std::size_t round = 0; round < rounds; round++) {
+        std::set<edge_descriptor> hidden_edges = signed_edges;
+        for (auto id : ids) {
+            auto se = forest_index(id);
+            auto res = parmcb::bidirectional_signed_dijkstra(graph, weight, signed_edges, hidden_edges, true,
+                    boost::source(se, graph), true, boost::target(se, graph), true, false, 0.0, workspace);
+            hidden_edges.erase(se);
+            set_total += std::get<1>(res);
+        }
+    }
+    set_timer.stop();
+    std::size_t set_scanned = workspace.scanned_edges();
+
+    // bitmap membership
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+    parmcb::detail::EdgeBitmap signed_bitmap(num_edges(graph));
+    parmcb::detail::EdgeBitmap hidden_bitmap(num_edges(graph));
+    signed_bitmap.assign(ids.begin(), ids.end());
+    double bitmap_total = 0.0;
+    workspace.reset_statistics();
+    boost::timer::cpu_timer bitmap_timer;
+    for (std::size_t round = 0; round < rounds; round++) {
+        hidden_bitmap.assign(ids.begin(), ids.end());
+        for (auto id : ids) {
+            auto se = forest_index(id);
+            auto res = parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_bitmap,
+                    hidden_bitmap, true, boost::source(se, graph), true, boost::target(se, graph), true, false, 0.0,
+                    workspace);
+            hidden_bitmap.reset(id);
+            bitmap_total += std::get<1>(res);
+        }
+    }
+    bitmap_timer.stop();
+    std::size_t bitmap_scanned = workspace.scanned_edges();
+
+    if (set_total != bitmap_total || set_scanned != bitmap_scanned) {
+        std::cerr << "Set and bitmap searches disagree" << std::endl;
+    }
+
+    auto report = [](const std::string &name, const boost::timer::cpu_timer &timer, std::size_t scanned) {
+        double secs = timer.elapsed().wall / 1e9;
+        std::cout << name << ": " << scanned << " relaxations in " << secs << " sec, "
+                << (secs > 0 ? scanned / secs / 1e6 : 0.0) << " M relaxations/sec" << std::endl;
+    };
+    report("set   ", set_timer, set_scanned);
+    report("bitmap", bitmap_timer, bitmap_scanned);
+}
+
+/*
+ * Signed graph searches from (v,+) to (v,-) for the given sources, with the weights of the edges
+ * indexed by their forest index id.
+ */
+template<class WeightType>
+void benchmark_queue_searches(const std::string &name, const graph_t &graph, const edge_id_map_t &edge_id_map,
+        const std::vector<WeightType> &weights, const parmcb::detail::EdgeBitmap &signed_bitmap,
+        const std::vector<graph_traits<graph_t>::vertex_descriptor> &sources, bool breadth_first) {
+    typedef iterator_property_map<typename std::vector<WeightType>::const_iterator, edge_id_map_t> edge_weight_map_t;
+    typedef parmcb::SignedDijkstraWorkspace<graph_t, edge_weight_map_t> workspace_t;
+
+    edge_weight_map_t weight(weights.cbegin(), edge_id_map);
+    std::unique_ptr<workspace_t> workspace(breadth_first ? new workspace_t(graph, weight) : new workspace_t(graph));
+    parmcb::detail::EdgeBitmap hidden_bitmap(num_edges(graph));
+
+    boost::timer::cpu_timer timer;
+    for (auto v : sources) {
+        parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_bitmap, hidden_bitmap, false, v,
+                true, v, false, false, WeightType(), *workspace);
+    }
+    timer.stop();
+
+    double secs = timer.elapsed().wall / 1e9;
+    std::size_t scanned = workspace->scanned_edges();
+    std::cout << "  " << name << ": " << secs << " sec, " << (secs > 0 ? scanned / secs / 1e6 : 0.0)
+            << " M relaxations/sec" << std::endl;
+}
+
+/*
+ * Priority queues of the signed graph searches across weight distributions. The same random
+ * weights are searched as doubles, which use the 4-ary heap, and as integers, which use the
+ * radix heap. Unit weights are additionally searched breadth first. The queues break ties
+ * differently, thus the searches may settle different paths of the same weight.
+ */
+void benchmark_queue(const graph_t &graph, std::size_t signed_count, std::size_t source_count, std::mt19937 &rng) {
+    parmcb::ForestIndex<graph_t> forest_index(graph);
+    auto csd = forest_index.cycle_space_dimension();
+    if (csd == 0) {
+        std::cout << "Graph is a forest, nothing to measure" << std::endl;
+        return;
+    }
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+    auto m = num_edges(graph);
+
+    std::vector<std::size_t> ids(csd);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(std::min(std::max(signed_count, std::size_t(1)), csd));
+    parmcb::detail::EdgeBitmap signed_bitmap(m);
+    signed_bitmap.assign(ids.begin(), ids.end());
+
+    std::vector<graph_traits<graph_t>::vertex_descriptor> sources;
+    for (const auto &v : make_iterator_range(vertices(graph))) {
+        sources.push_back(v);
+    }
+    std::shuffle(sources.begin(), sources.end(), rng);
+    sources.resize(std::min(std::max(source_count, std::size_t(1)), sources.size()));
+    std::cout << "Signed edges: " << ids.size() << ", sources: " << sources.size() << std::endl;
+
+    const std::pair<const char*, long> distributions[] = { { "unit", 1 }, { "small integers [1,16]", 16 }, {
+            "wide integers [1,2^20]", 1L << 20 } };
+    for (const auto &distribution : distributions) {
+        std::uniform_int_distribution<long> value(1, distribution.second);
+        std::vector<long> int_weights(m);
+        for (auto &w : int_weights) {
+            w = value(rng);
+        }
+        std::vector<double> double_weights(int_weights.begin(), int_weights.end());
+
+        std::cout << distribution.first << " weights" << std::endl;
+        benchmark_queue_searches("4-ary heap", graph, edge_id_map, double_weights, signed_bitmap, sources, false);
+        benchmark_queue_searches("radix heap", graph, edge_id_map, int_weights, signed_bitmap, sources, false);
+        if (distribution.second == 1) {
+            benchmark_queue_searches("bfs       ", graph, edge_id_map, int_weights, signed_bitmap, sources, true);
+        }
+    }
+}
+
+/*
+ * Landmark lower bounds in the searches from (v,+) to (v,-) of one support vector, where as in the
+ * sequential algorithm the lightest cycle found so far limits the next searches. The searches run
+ * without landmarks and then with the given number of landmarks.
+ */
+void benchmark_landmarks(const graph_t &graph, std::size_t signed_count, std::size_t landmark_count,
+        std::mt19937 &rng) {
+    typedef parmcb::SignedDijkstraWorkspace<graph_t, weight_map_t> workspace_t;
+
+    weight_map_t weight = get(boost::edge_weight, graph);
+    parmcb::ForestIndex<graph_t> forest_index(graph);
+    auto csd = forest_index.cycle_space_dimension();
+    if (csd == 0) {
+        std::cout << "Graph is a forest, nothing to measure" << std::endl;
+        return;
+    }
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+
+    std::vector<std::size_t> ids(csd);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(std::min(std::max(signed_count, std::size_t(1)), csd));
+    parmcb::detail::EdgeBitmap signed_bitmap(num_edges(graph));
+    parmcb::detail::EdgeBitmap hidden_bitmap(num_edges(graph));
+    signed_bitmap.assign(ids.begin(), ids.end());
+    std::cout << "Signed edges: " << ids.size() << std::endl;
+
+    for (std::size_t k : { std::size_t(0), landmark_count }) {
+        boost::timer::cpu_timer timer;
+        parmcb::detail::Landmarks<graph_t, weight_map_t> landmarks(graph, weight, k);
+        timer.stop();
+        double setup_secs = timer.elapsed().wall / 1e9;
+        workspace_t workspace(graph, weight, &landmarks);
+
+        double best = (std::numeric_limits<double>::max)();
+        bool found = false;
+        timer.start();
+        for (const auto &v : make_iterator_range(vertices(graph))) {
+            auto res = parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_bitmap,
+                    hidden_bitmap, false, v, true, v, false, found, best, workspace);
+            if (std::get<2>(res)) {
+                best = std::get<1>(res);
+                found = true;
+            }
+        }
+        timer.stop();
+
+        double secs = timer.elapsed().wall / 1e9;
+        std::cout << k << " landmarks: " << setup_secs << " sec setup, " << secs << " sec searches, "
+                << double(workspace.settled_vertices()) / num_vertices(graph) << " settled vertices per search, cycle "
+                << (found ? best : 0.0) << std::endl;
+    }
+}
+
+/*
+ * The searches of one support vector in both modes, as in the sequential algorithm where the
+ * lightest cycle found so far limits the next searches.
+ */
+template<class AlternationPolicy>
+void benchmark_alternation_policy(const std::string &name, const graph_t &graph,
+        const parmcb::ForestIndex<graph_t> &forest_index, const std::vector<std::size_t> &ids) {
+    weight_map_t weight = get(boost::edge_weight, graph);
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+    parmcb::detail::EdgeBitmap signed_bitmap(num_edges(graph));
+    parmcb::detail::EdgeBitmap hidden_bitmap(num_edges(graph));
+    signed_bitmap.assign(ids.begin(), ids.end());
+    parmcb::SignedDijkstraWorkspace<graph_t, weight_map_t> workspace(graph, weight);
+
+    // one search from (v,+) to (v,-) for each vertex v
+    double best = (std::numeric_limits<double>::max)();
+    bool found = false;
+    boost::timer::cpu_timer vertices_timer;
+    for (const auto &v : make_iterator_range(vertices(graph))) {
+        auto res = parmcb::bidirectional_signed_dijkstra<AlternationPolicy>(graph, weight, edge_id_map,
+                signed_bitmap, hidden_bitmap, false, v, true, v, false, found, best, workspace);
+        if (std::get<2>(res)) {
+            best = std::get<1>(res);
+            found = true;
+        }
+    }
+    vertices_timer.stop();
+    std::size_t vertices_settled = workspace.settled_vertices();
+
+    // one search for each signed edge, hiding the signed edges already considered
+    workspace.reset_statistics();
+    double edges_best = (std::numeric_limits<double>::max)();
+    bool edges_found = false;
+    hidden_bitmap.assign(ids.begin(), ids.end());
+    boost::timer::cpu_timer edges_timer;
+    for (auto id : ids) {
+        auto se = forest_index(id);
+        auto res = parmcb::bidirectional_signed_dijkstra<AlternationPolicy>(graph, weight, edge_id_map,
+                signed_bitmap, hidden_bitmap, true, boost::source(se, graph), true, boost::target(se, graph), true,
+                edges_found, edges_best, workspace);
+        hidden_bitmap.reset(id);
+        if (std::get<2>(res) && std::get<0>(res).find(se) == std::get<0>(res).end()) {
+            edges_best = std::get<1>(res) + weight[se];
+            edges_found = true;
+        }
+    }
+    edges_timer.stop();
+    std::size_t edges_settled = workspace.settled_vertices();
+
+    std::cout << name << ": all vertices " << vertices_timer.elapsed().wall / 1e9 << " sec, "
+            << double(vertices_settled) / num_vertices(graph) << " settled per search, cycle "
+            << (found ? best : 0.0) << "; signed edges " << edges_timer.elapsed().wall / 1e9 << " sec, "
+            << double(edges_settled) / ids.size() << " settled per search, cycle "
+            << (edges_found ? edges_best : 0.0) << std::endl;
+}
+
+/*
+ * Alternation policies of the bidirectional signed graph searches.
+ */
+void benchmark_alternation(const graph_t &graph, std::size_t signed_count, std::mt19937 &rng) {
+    parmcb::ForestIndex<graph_t> forest_index(graph);
+    auto csd = forest_index.cycle_space_dimension();
+    if (csd == 0) {
+        std::cout << "Graph is a forest, nothing to measure" << std::endl;
+        return;
+    }
+
+    std::vector<std::size_t> ids(csd);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(std::min(std::max(signed_count, std::size_t(1)), csd));
+    std::sort(ids.begin(), ids.end());
+    std::cout << "Signed edges: " << ids.size() << std::endl;
+
+    benchmark_alternation_policy<parmcb::strict_alternation>("strict        ", graph, forest_index, ids);
+    benchmark_alternation_policy<parmcb::smaller_queue_first>("smaller queue ", graph, forest_index, ids);
+    benchmark_alternation_policy<parmcb::smaller_radius_first>("smaller radius", graph, forest_index, ids);
+}
+
+/*
+ * Support vector maintenance with eager and blocked updates. The cycles are random edge sets of
+ * the given length, made odd with respect to the current support vector, so that both strategies
+ * see exactly the same sequence of vectors and cycles.
+ */
+template<bool ParallelUsingTBB>
+void benchmark_support(const graph_t &graph, std::size_t cycle_length, unsigned seed) {
+    parmcb::ForestIndex<graph_t> forest_index(graph);
+    auto csd = forest_index.cycle_space_dimension();
+    auto m = num_edges(graph);
+    std::cout << "Cycle space dimension: " << csd << std::endl;
+    if (csd == 0) {
+        return;
+    }
+
+    std::vector<std::size_t> checksums;
+    for (auto strategy : { parmcb::support_update::eager, parmcb::support_update::blocked }) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<std::size_t> edge_id(0, m - 1);
+        std::size_t checksum = 0;
+        std::size_t total_size = 0;
+
+        boost::timer::cpu_timer timer;
+        parmcb::detail::SupportVectors<ParallelUsingTBB> support(csd, strategy);
+        for (std::size_t k = 0; k < csd; k++) {
+            std::set<std::size_t> cyclek;
+            for (std::size_t i = 0; i < cycle_length; i++) {
+                cyclek.insert(edge_id(rng));
+            }
+            if (support[k] * cyclek == 0) {
+                auto first = *support[k].begin();
+                if (!cyclek.erase(first)) {
+                    cyclek.insert(first);
+                }
+            }
+            total_size += support[k].size();
+            checksum = checksum * 31 + support[k].size();
+            support.update(k, cyclek);
+        }
+        timer.stop();
+        checksums.push_back(checksum);
+
+        double secs = timer.elapsed().wall / 1e9;
+        std::cout << (strategy == parmcb::support_update::eager ? "eager  " : "blocked") << ": " << secs
+                << " sec, average support size " << double(total_size) / csd << std::endl;
+    }
+
+    if (checksums[0] != checksums[1]) {
+        std::cerr << "Eager and blocked support vectors disagree" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    po::variables_map vm;
+    try {
+        po::options_description desc(USAGE);
+        // @formatter:off
+        desc.add_options()
+                ("help,h", "Help")
+                ("bench", po::value<std::string>()->default_value("relaxation"), "Benchmark to run (relaxation, support, queue, landmarks, alternation)")
+                ("signed-edges", po::value<std::size_t>()->default_value(64), "Number of signed edges")
+                ("sources", po::value<std::size_t>()->default_value(100), "Number of search sources")
+                ("landmarks", po::value<std::size_t>()->default_value(8), "Number of landmarks")
+                ("cycle-length", po::value<std::size_t>()->default_value(16), "Length of the random cycles")
+                ("parallel,p", po::value<bool>()->default_value(false), "Use parallelization")
+                ("rounds", po::value<std::size_t>()->default_value(1), "Number of repetitions")
+                ("seed", po::value<unsigned>()->default_value(17), "Random seed")
+                ("input-file,I",po::value<std::string>(), "Input filename");
+        // @formatter:on
+        po::positional_options_description pos_desc;
+        pos_desc.add("input-file", 1);
+        po::command_line_parser parser { argc, argv };
+        parser.options(desc).positional(pos_desc).allow_unregistered();
+        po::parsed_options parsed_options = parser.run();
+        po::store(parsed_options, vm);
+
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+        po::notify(vm);
+
+        if (!vm.count("input-file")) {
+            std::cerr << "Input file missing. See usage by calling with -h ." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+    } catch (const po::error &ex) {
+        std::cerr << "Invalid arguments:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // create graph
+    graph_t graph;
+    FILE *fp = fopen(vm["input-file"].as<std::string>().c_str(), "r");
+    if (fp == NULL) {
+        std::cerr << "Failed to open input file." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    parmcb::read_dimacs_from_file(fp, graph);
+    fclose(fp);
+
+    std::cout << "Graph has " << num_vertices(graph) << " vertices" << std::endl;
+    std::cout << "Graph has " << num_edges(graph) << " edges" << std::endl;
+
+    std::mt19937 rng(vm["seed"].as<unsigned>());
+    std::string bench = vm["bench"].as<std::string>();
+    if (bench == "relaxation") {
+        benchmark_relaxation(graph, vm["signed-edges"].as<std::size_t>(), vm["rounds"].as<std::size_t>(), rng);
+    } else if (bench == "queue") {
+        benchmark_queue(graph, vm["signed-edges"].as<std::size_t>(), vm["sources"].as<std::size_t>(), rng);
+    } else if (bench == "landmarks") {
+        benchmark_landmarks(graph, vm["signed-edges"].as<std::size_t>(), vm["landmarks"].as<std::size_t>(), rng);
+    } else if (bench == "alternation") {
+        benchmark_alternation(graph, vm["signed-edges"].as<std::size_t>(), rng);
+    } else if (bench == "support") {
+        if (vm["parallel"].as<bool>()) {
+            benchmark_support<true>(graph, vm["cycle-length"].as<std::size_t>(), vm["seed"].as<unsigned>());
+        } else {
+            benchmark_support<false>(graph, vm["cycle-length"].as<std::size_t>(), vm["seed"].as<unsigned>());
+        }
+    } else {
+        std::cerr << "Unknown benchmark " << bench << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -19,6 +19,7 @@
 #include <parmcb/parmcb.hpp>
 #include <parmcb/util.hpp>
 #include <parmcb/detail/cycles.hpp>
+#include <parmcb/detail/reduction.hpp>
 #include <parmcb/sptrees.hpp>
 
 using namespace boost;
@@ -41,8 +42,7 @@ public:
     std::tuple<std::set<Edge>, WeightType> operator()(const std::vector<parmcb::SPTree<Graph, WeightMap>> &trees,
             const parmcb::CandidateCycle<Graph, WeightMap> &c) const {
 
-        std::shared_ptr<parmcb::SPNode<Graph, WeightMap>> v = trees[c.tree()].node(boost::source(c.edge(), g));
-        std::shared_ptr<parmcb::SPNode<Graph, WeightMap>> u = trees[c.tree()].node(boost::target(c.edge(), g));
+        const parmcb::SPTree<Graph, WeightMap> &tree = trees[c.tree()];
 
         Edge e = c.edge();
         bool valid = true;
@@ -50,40 +50,19 @@ public:
         std::set<Edge> result;
         result.insert(e);
 
-        // first part
-        Vertex w = boost::source(c.edge(), g);
-        std::shared_ptr<parmcb::SPNode<Graph, WeightMap>> ws = trees[c.tree()].node(w);
-        while (ws->has_pred()) {
-            Edge a = ws->pred();
-            if (result.insert(a).second == false) {
-                valid = false;
-                break;
+        for (Vertex w : { boost::source(e, g), boost::target(e, g) }) {
+            while (tree.has_pred(w)) {
+                const Edge &a = tree.pred(w);
+                if (result.insert(a).second == false) {
+                    valid = false;
+                    break;
+                }
+                cycle_weight += boost::get(weight_map, a);
+                w = tree.parent(w);
             }
-            cycle_weight += boost::get(weight_map, a);
-            w = boost::opposite(a, w, g);
-            ws = trees[c.tree()].node(w);
-        }
-
-        if (!valid) {
-            return std::make_tuple(std::set<Edge> { }, 0.0);
-        }
-
-        // second part
-        w = boost::target(c.edge(), g);
-        ws = trees[c.tree()].node(w);
-        while (ws->has_pred()) {
-            Edge a = ws->pred();
-            if (result.insert(a).second == false) {
-                valid = false;
-                break;
+            if (!valid) {
+                return std::make_tuple(std::set<Edge> { }, 0.0);
             }
-            cycle_weight += boost::get(weight_map, a);
-            w = boost::opposite(a, w, g);
-            ws = trees[c.tree()].node(w);
-        }
-
-        if (!valid) {
-            return std::make_tuple(std::set<Edge> { }, 0.0);
         }
 
         return std::make_tuple(result, cycle_weight);
@@ -191,6 +170,12 @@ int main(int argc, char *argv[]) {
     std::cout << "graph n: " << num_vertices(graph) << std::endl;
     std::cout << "graph m: " << num_edges(graph) << std::endl;
     std::cout << "graph n*m: " << num_vertices(graph)*num_edges(graph) << std::endl;
+
+    parmcb::detail::ChainReduction<graph_t, property_map<graph_t, edge_weight_t>::type> reduction(graph,
+            get(boost::edge_weight, graph));
+    std::cout << "reduced graph n: " << num_vertices(reduction.graph()) << std::endl;
+    std::cout << "reduced graph m: " << num_edges(reduction.graph()) << std::endl;
+    std::cout << "reduction ratio: " << reduction.reduction_ratio() << std::endl;
     std::cout << std::flush;
 
     print_all_tree_stats(graph, get(boost::edge_weight, graph));
@@ -40,6 +40,8 @@ int main(int argc, char *argv[]) {
                 ("signed", po::value<bool>()->default_value(true), "Use the signed graph algorithm")
                 ("fvstrees", po::value<bool>()->default_value(false), "Use cycles collection from feedback vertex set trees")
                 ("isotrees", po::value<bool>()->default_value(false), "Use isometric cycles collection")
+                ("bcc", po::value<bool>()->default_value(false)->implicit_value(true), "Distribute the biconnected components over the ranks")
+                ("distributed-support", po::value<bool>()->default_value(false)->implicit_value(true), "Partition the support vectors among the ranks")
                 ("printcycles", po::value<bool>()->default_value(false)->implicit_value(true), "Print cycles")
                 ("input-file,I",po::value<std::string>(), "Input filename");
         // @formatter:on
@@ -111,27 +113,49 @@ int main(int argc, char *argv[]) {
         std::cout << std::flush;
     }
 
+    parmcb::support_placement placement =
+            vm["distributed-support"].as<bool>() ? parmcb::support_placement::distributed : parmcb::support_placement::root;
+
     boost::timer::cpu_timer timer;
     std::list<std::list<edge_descriptor>> cycles;
     double mcb_weight;
 
-    if (vm["signed"].as<bool>()) {
+    if (vm["bcc"].as<bool>() && vm["signed"].as<bool>()) {
+        if (world.rank() == 0) {
+            std::cout << "Using PAR_BCC_MCB_SVA_SIGNED" << std::endl;
+        }
+        mcb_weight = parmcb::bcc_mcb_sva_signed_mpi(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                world);
+    } else if (vm["bcc"].as<bool>() && vm["fvstrees"].as<bool>()) {
+        if (world.rank() == 0) {
+            std::cout << "Using PAR_BCC_MCB_SVA_FVS_TREES" << std::endl;
+        }
+        mcb_weight = parmcb::bcc_mcb_sva_fvs_trees_mpi(graph, get(boost::edge_weight, graph),
+                std::back_inserter(cycles), world);
+    } else if (vm["bcc"].as<bool>()) {
+        if (world.rank() == 0) {
+            std::cout << "Using PAR_BCC_MCB_SVA_ISO_TREES" << std::endl;
+        }
+        mcb_weight = parmcb::bcc_mcb_sva_iso_trees_mpi(graph, get(boost::edge_weight, graph),
+                std::back_inserter(cycles), world);
+    } else if (vm["signed"].as<bool>()) {
         if (world.rank() == 0) {
             std::cout << "Using PAR_MCB_SVA_SIGNED" << std::endl;
         }
-        mcb_weight = parmcb::mcb_sva_signed_mpi(graph, get(boost::edge_weight, graph), std::back_inserter(cycles), world);
+        mcb_weight = parmcb::mcb_sva_signed_mpi(graph, get(boost::edge_weight, graph), std::back_inserter(cycles), world,
+                parmcb::execution_context(), placement);
     } else if (vm["fvstrees"].as<bool>()) {
         if (world.rank() == 0) {
             std::cout << "Using PAR_MCB_SVA_FVS_TREES" << std::endl;
         }
         mcb_weight = parmcb::mcb_sva_fvs_trees_tbb_mpi(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
-                world);
+                world, parmcb::execution_context(), placement);
     } else {
         if (world.rank() == 0) {
             std::cout << "Using PAR_MCB_SVA_ISO_TREES" << std::endl;
         }
         mcb_weight = parmcb::mcb_sva_iso_trees_tbb_mpi(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
-                world);
+                world, parmcb::execution_context(), placement);
     }
     timer.stop();
 
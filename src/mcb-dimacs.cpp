@@ -37,9 +37,18 @@ int main(int argc, char *argv[]) {
                 ("signed", po::value<bool>()->default_value(true), "Use the signed graph algorithm")
                 ("fvstrees", po::value<bool>()->default_value(false), "Use cycles collection from feedback vertex set trees")
                 ("isotrees", po::value<bool>()->default_value(false), "Use isometric cycles collection")
+                ("hybrid", po::value<bool>()->default_value(false)->implicit_value(true), "Use candidate cycle lookups with signed graph searches as fallback")
+                ("hybrid-memory", po::value<std::size_t>()->default_value(parmcb::DEFAULT_HYBRID_MEMORY_BUDGET >> 20), "Memory budget in MB for the candidate cycles of the hybrid algorithm")
+                ("landmarks", po::value<std::size_t>()->default_value(0), "Number of landmarks whose distance lower bounds prune the signed graph searches")
                 ("parallel,p", po::value<bool>()->default_value(true), "Use parallelization")
+                ("bcc", po::value<bool>()->default_value(false)->implicit_value(true), "Solve each biconnected component separately")
+                ("reduce", po::value<bool>()->default_value(false)->implicit_value(true), "Prune trees and contract degree two paths first")
+                ("blocked-support", po::value<bool>()->default_value(false)->implicit_value(true), "Update support vectors in blocks")
                 ("printcycles", po::value<bool>()->default_value(false)->implicit_value(true), "Print cycles")
                 ("cores", po::value<int>()->default_value(0), "Number of cores")
+                ("numa-node", po::value<int>()->default_value(-1), "Run on the cores of this NUMA node")
+                ("pin-threads", po::value<bool>()->default_value(false)->implicit_value(true), "Bind each thread to a single core")
+                ("numa-replication", po::value<bool>()->default_value(false)->implicit_value(true), "Replicate the graph on each NUMA node")
                 ("input-file,I",po::value<std::string>(), "Input filename");
         // @formatter:on
         po::positional_options_description pos_desc;
@@ -99,6 +108,8 @@ int main(int argc, char *argv[]) {
     if (vm.count("cores")) {
         cores = vm["cores"].as<int>();
     }
+    parmcb::execution_context context(cores, vm["numa-node"].as<int>(), vm["pin-threads"].as<bool>(),
+            vm["numa-replication"].as<bool>());
     if (cores == 0) {
         cores = boost::thread::hardware_concurrency();
     }
@@ -106,46 +117,147 @@ int main(int argc, char *argv[]) {
         std::cout << "Using cores: " << cores << std::endl;
     }
 
+    parmcb::support_update support_strategy =
+            vm["blocked-support"].as<bool>() ? parmcb::support_update::blocked : parmcb::support_update::eager;
+
     boost::timer::cpu_timer timer;
 
     std::list<std::list<edge_descriptor>> cycles;
     double mcb_weight;
-    if (vm["signed"].as<bool>()) {
+    if (vm["hybrid"].as<bool>()) {
+        std::size_t memory_budget = vm["hybrid-memory"].as<std::size_t>() << 20;
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using MCB_SVA_HYBRID_TBB" << std::endl;
+            mcb_weight = parmcb::mcb_sva_hybrid_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context, support_strategy, memory_budget);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using MCB_SVA_HYBRID" << std::endl;
+            mcb_weight = parmcb::mcb_sva_hybrid(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    support_strategy, memory_budget);
+        }
+    } else if (vm["bcc"].as<bool>() && vm["signed"].as<bool>()) {
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using BCC_MCB_SVA_SIGNED_TBB" << std::endl;
+            mcb_weight = parmcb::bcc_mcb_sva_signed_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using BCC_MCB_SVA_SIGNED" << std::endl;
+            mcb_weight = parmcb::bcc_mcb_sva_signed(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+        }
+    } else if (vm["bcc"].as<bool>() && vm["fvstrees"].as<bool>()) {
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using BCC_MCB_SVA_FVS_TREES_TBB" << std::endl;
+            mcb_weight = parmcb::bcc_mcb_sva_fvs_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using BCC_MCB_SVA_FVS_TREES" << std::endl;
+            mcb_weight = parmcb::bcc_mcb_sva_fvs_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+        }
+    } else if (vm["bcc"].as<bool>()) {
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using BCC_MCB_SVA_ISO_TREES_TBB" << std::endl;
+            mcb_weight = parmcb::bcc_mcb_sva_iso_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using BCC_MCB_SVA_ISO_TREES" << std::endl;
+            mcb_weight = parmcb::bcc_mcb_sva_iso_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+        }
+    } else if (vm["reduce"].as<bool>() && vm["signed"].as<bool>()) {
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using REDUCED_MCB_SVA_SIGNED_TBB" << std::endl;
+            mcb_weight = parmcb::reduced_mcb_sva_signed_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using REDUCED_MCB_SVA_SIGNED" << std::endl;
+            mcb_weight = parmcb::reduced_mcb_sva_signed(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+        }
+    } else if (vm["reduce"].as<bool>() && vm["fvstrees"].as<bool>()) {
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using REDUCED_MCB_SVA_FVS_TREES_TBB" << std::endl;
+            mcb_weight = parmcb::reduced_mcb_sva_fvs_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using REDUCED_MCB_SVA_FVS_TREES" << std::endl;
+            mcb_weight = parmcb::reduced_mcb_sva_fvs_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+        }
+    } else if (vm["reduce"].as<bool>()) {
+        if (vm["parallel"].as<bool>()) {
+#ifdef PARMCB_HAVE_TBB
+            std::cout << "Using REDUCED_MCB_SVA_ISO_TREES_TBB" << std::endl;
+            mcb_weight = parmcb::reduced_mcb_sva_iso_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context);
+#else
+            std::cerr << "TBB not supported, bailing out." << std::endl;
+#endif
+        } else {
+            std::cout << "Using REDUCED_MCB_SVA_ISO_TREES" << std::endl;
+            mcb_weight = parmcb::reduced_mcb_sva_iso_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+        }
+    } else if (vm["signed"].as<bool>()) {
         if (vm["parallel"].as<bool>()) {
 #ifdef PARMCB_HAVE_TBB
             std::cout << "Using MCB_SVA_SIGNED_TBB" << std::endl;
             mcb_weight = parmcb::mcb_sva_signed_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
-                    cores);
+                    context, support_strategy, nullptr, vm["landmarks"].as<std::size_t>());
 #else
             std::cerr << "TBB not supported, bailing out." << std::endl;
 #endif
         } else {
             std::cout << "Using MCB_SVA_SIGNED" << std::endl;
-            mcb_weight = parmcb::mcb_sva_signed(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+            mcb_weight = parmcb::mcb_sva_signed(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    support_strategy, nullptr, nullptr, vm["landmarks"].as<std::size_t>());
         }
     } else if (vm["fvstrees"].as<bool>()) {
         if (vm["parallel"].as<bool>()) {
 #ifdef PARMCB_HAVE_TBB
             std::cout << "Using MCB_SVA_FVS_TREES_TBB" << std::endl;
-            mcb_weight = parmcb::mcb_sva_fvs_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+            mcb_weight = parmcb::mcb_sva_fvs_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context, support_strategy);
 #else
             std::cerr << "TBB not supported, bailing out." << std::endl;
 #endif
         } else {
             std::cout << "Using MCB_SVA_FVS_TREES" << std::endl;
-            mcb_weight = parmcb::mcb_sva_fvs_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+            mcb_weight = parmcb::mcb_sva_fvs_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    support_strategy);
         }
     } else {
         if (vm["parallel"].as<bool>()) {
 #ifdef PARMCB_HAVE_TBB
             std::cout << "Using MCB_SVA_ISO_TREES_TBB" << std::endl;
-            mcb_weight = parmcb::mcb_sva_iso_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+            mcb_weight = parmcb::mcb_sva_iso_trees_tbb(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    context, support_strategy);
 #else
             std::cerr << "TBB not supported, bailing out." << std::endl;
 #endif
         } else {
             std::cout << "Using MCB_SVA_ISO_TREES" << std::endl;
-            mcb_weight = parmcb::mcb_sva_iso_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles));
+            mcb_weight = parmcb::mcb_sva_iso_trees(graph, get(boost::edge_weight, graph), std::back_inserter(cycles),
+                    support_strategy);
         }
     }
 
@@ -7,12 +7,19 @@
 #include "doctest.h"
 
 #include <iostream>
+#include <iterator>
+#include <random>
 #include <set>
+#include <vector>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/property_map/property_map.hpp>
 
 #include <parmcb/forestindex.hpp>
 
+#ifdef PARMCB_HAVE_TBB
+#include <tbb/task_arena.h>
+#endif
+
 TEST_CASE("forest index")
 {
 
@@ -71,6 +78,8 @@ TEST_CASE("forest index")
     CHECK(fi.cycle_space_dimension() == 3);
 
 
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(fi);
+
     int not_on_forest_count = 0;
     int on_forest_count = 0;
     std::set<std::size_t> used;
@@ -80,6 +89,7 @@ TEST_CASE("forest index")
         used.insert(index);
         CHECK(fi(index) == e);
         CHECK(fi(e) == index);
+        CHECK(boost::get(edge_id_map, e) == index);
         if (fi.is_on_forest(e)) {
             on_forest_count++;
         } else {
@@ -91,3 +101,97 @@ TEST_CASE("forest index")
     CHECK(not_on_forest_count == 3);
     CHECK(on_forest_count == 11);
 }
+
+TEST_CASE("forest index with edge index map")
+{
+    typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS, boost::no_property,
+            boost::property<boost::edge_index_t, std::size_t> > Graph;
+    typedef boost::property_map<Graph, boost::edge_index_t>::type EdgeIndexMap;
+
+    // 4x4 grid and a separate triangle
+    Graph graph(19);
+    auto edge_index = boost::get(boost::edge_index, graph);
+    std::size_t id = 0;
+    for (std::size_t r = 0; r < 4; r++) {
+        for (std::size_t c = 0; c < 4; c++) {
+            if (c + 1 < 4) {
+                edge_index[boost::add_edge(4 * r + c, 4 * r + c + 1, graph).first] = id++;
+            }
+            if (r + 1 < 4) {
+                edge_index[boost::add_edge(4 * r + c, 4 * (r + 1) + c, graph).first] = id++;
+            }
+        }
+    }
+    edge_index[boost::add_edge(16, 17, graph).first] = id++;
+    edge_index[boost::add_edge(17, 18, graph).first] = id++;
+    edge_index[boost::add_edge(16, 18, graph).first] = id++;
+
+    for (bool parallel : { false, true }) {
+        parmcb::ForestIndex<Graph, EdgeIndexMap> fi(graph, boost::get(boost::edge_index, graph), parallel);
+
+        CHECK(fi.weak_connected_components() == 2);
+        CHECK(fi.cycle_space_dimension() == 10);
+
+        std::set<std::size_t> used;
+        std::size_t not_on_forest_count = 0;
+        for (const auto &e : boost::make_iterator_range(boost::edges(graph))) {
+            auto index = fi(e);
+            CHECK(used.insert(index).second);
+            CHECK(fi(index) == e);
+            if (!fi.is_on_forest(e)) {
+                not_on_forest_count++;
+            }
+        }
+        CHECK(used.size() == 27);
+        CHECK(not_on_forest_count == 10);
+    }
+}
+
+#ifdef PARMCB_HAVE_TBB
+TEST_CASE("parallel spanning forest")
+{
+    typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> Graph;
+    typedef boost::graph_traits<Graph>::edge_descriptor Edge;
+
+    // sparse random multigraph with self-loops and several components
+    Graph graph(3000);
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<std::size_t> vertex(0, 2999);
+    for (std::size_t i = 0; i < 4500; i++) {
+        boost::add_edge(vertex(gen), vertex(gen), graph);
+    }
+
+    // union-find in edge order
+    std::vector<std::size_t> parent(3000);
+    for (std::size_t v = 0; v < 3000; v++) {
+        parent[v] = v;
+    }
+    auto find = [&](std::size_t x) {
+        while (parent[x] != x) {
+            x = parent[x] = parent[parent[x]];
+        }
+        return x;
+    };
+    std::vector<Edge> expected;
+    std::size_t components = 3000;
+    for (const auto &e : boost::make_iterator_range(boost::edges(graph))) {
+        std::size_t u = find(boost::source(e, graph));
+        std::size_t v = find(boost::target(e, graph));
+        if (u != v) {
+            parent[u] = v;
+            expected.push_back(e);
+            components--;
+        }
+    }
+
+    for (int threads : { 1, 2, 8 }) {
+        tbb::task_arena arena(threads);
+        arena.execute([&] {
+            std::vector<Edge> forest;
+            std::size_t k = parmcb::detail::spanning_forest_tbb(graph, std::back_inserter(forest));
+            CHECK(k == components);
+            CHECK(forest == expected);
+        });
+    }
+}
+#endif
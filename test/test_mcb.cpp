@@ -7,6 +7,7 @@
 #include "doctest.h"
 
 #include <iostream>
+#include <random>
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/property_map/property_map.hpp>
@@ -76,6 +77,32 @@ void create_graph(Graph& graph) {
     weight[e12_15] = 1.0;
 }
 
+/*
+ * Grid of side x side vertices, weight_fn(r, c, horizontal) gives the weight of the edge from
+ * vertex (r, c) to its right or lower neighbor.
+ */
+template<class WeightFn>
+void create_grid(Graph& graph, std::size_t side, WeightFn weight_fn) {
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+    for (std::size_t i = 0; i < side * side; i++) {
+        add_vertex(graph);
+    }
+    for (std::size_t r = 0; r < side; r++) {
+        for (std::size_t c = 0; c < side; c++) {
+            if (c + 1 < side) {
+                weight[add_edge(r * side + c, r * side + c + 1, graph).first] = weight_fn(r, c, true);
+            }
+            if (r + 1 < side) {
+                weight[add_edge(r * side + c, (r + 1) * side + c, graph).first] = weight_fn(r, c, false);
+            }
+        }
+    }
+}
+
+double unit_weight(std::size_t, std::size_t, bool) {
+    return 1.0;
+}
+
 TEST_CASE("sequential sva signed"){
     Graph graph;
     create_graph(graph);
@@ -273,3 +300,842 @@ TEST_CASE("parallel sva iso trees"){
 }
 #endif
 
+
+TEST_CASE("blocked support updates"){
+    // 12x12 grid, cycle space dimension 121 spans more than one block
+    const std::size_t side = 12;
+    Graph graph;
+    create_grid(graph, side, unit_weight);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    std::list<std::list<Edge>> cycles;
+    double mcb_weight = parmcb::mcb_sva_signed(graph, weight, std::back_inserter(cycles),
+            parmcb::support_update::blocked);
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 121);
+    CHECK(mcb_weight == 484.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_fvs_trees(graph, weight, std::back_inserter(cycles), parmcb::support_update::blocked);
+    CHECK(cycles.size() == 121);
+    CHECK(mcb_weight == 484.0);
+
+#ifdef PARMCB_HAVE_TBB
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles),
+            parmcb::execution_context(), parmcb::support_update::blocked);
+    CHECK(cycles.size() == 121);
+    CHECK(mcb_weight == 484.0);
+#endif
+
+    // 40x40 grid, the blocks are sparse enough to be added without the packed tables
+    Graph large;
+    create_grid(large, 40, unit_weight);
+    property_map<Graph, edge_weight_t>::type large_weight = get(edge_weight, large);
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_signed(large, large_weight, std::back_inserter(cycles),
+            parmcb::support_update::blocked);
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(large, *it));
+    }
+    CHECK(cycles.size() == 1521);
+    CHECK(mcb_weight == 6084.0);
+}
+
+TEST_CASE("incremental parities"){
+    typedef property_map<Graph, edge_weight_t>::type WeightMap;
+    typedef parmcb::SPTree<Graph, WeightMap> Tree;
+    const std::size_t side = 6;
+    Graph graph;
+    create_grid(graph, side, [](std::size_t r, std::size_t c, bool horizontal) {
+        return horizontal ? 1.0 + (r + 2 * c) % 3 : 1.0 + (2 * r + c) % 5;
+    });
+    WeightMap weight = get(edge_weight, graph);
+    std::vector<Edge> all_edges(edges(graph).first, edges(graph).second);
+    std::vector<graph_traits<Graph>::vertex_descriptor> roots(vertices(graph).first, vertices(graph).second);
+
+    auto same_parities = [&](const Tree &a, const Tree &b) {
+        for (const auto &v : make_iterator_range(vertices(graph))) {
+            if (a.parity(v) != b.parity(v)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // subtree flips against a full recompute, the second change flips subtrees covering more
+    // vertices than the tree and recomputes all parities
+    std::set<Edge> before(all_edges.begin(), all_edges.begin() + 3);
+    std::vector<std::set<Edge>> afters;
+    afters.emplace_back(all_edges.begin() + 1, all_edges.begin() + 4);
+    afters.emplace_back(all_edges.begin() + 3, all_edges.end());
+    for (const auto &after : afters) {
+        std::vector<Edge> changed;
+        std::set_symmetric_difference(before.begin(), before.end(), after.begin(), after.end(),
+                std::back_inserter(changed));
+        Tree incremental(0, graph, get(vertex_index, graph), weight, roots.front());
+        Tree full(0, graph, get(vertex_index, graph), weight, roots.front());
+        incremental.update_parities(before);
+        incremental.update_parities(after, changed);
+        full.update_parities(after);
+        CHECK(same_parities(incremental, full));
+    }
+
+    // the lookup with and without incremental updates, the fourth and the last support vectors
+    // change more edges than half the vertices and recompute all parities
+    std::vector<std::set<Edge>> supports;
+    supports.push_back(std::set<Edge> { all_edges[0] });
+    supports.push_back(std::set<Edge> { all_edges[0], all_edges[5] });
+    supports.push_back(std::set<Edge> { all_edges[5], all_edges[1], all_edges[2], all_edges[3] });
+    supports.emplace_back();
+    for (std::size_t i = 0; i < all_edges.size(); i += 2) {
+        supports.back().insert(all_edges[i]);
+    }
+    supports.push_back(supports.back());
+    supports.back().erase(all_edges[0]);
+    supports.push_back(std::set<Edge> { all_edges[7] });
+
+    parmcb::SPTrees<Graph, WeightMap, false> builder(graph, weight);
+    std::vector<Tree> incremental_trees, full_trees;
+    std::vector<parmcb::CandidateCycle<Graph, WeightMap>> cycles;
+    builder.build_trees(roots, incremental_trees);
+    builder.build_trees(roots, full_trees);
+    builder.build_candidate_cycles(incremental_trees, cycles);
+    std::sort(cycles.begin(), cycles.end(), [](const auto &a, const auto &b) {
+        return a.weight() < b.weight();
+    });
+    parmcb::ShortestOddCycleLookup<Graph, WeightMap, false> incremental(graph, weight, incremental_trees, cycles,
+            true, true);
+    parmcb::ShortestOddCycleLookup<Graph, WeightMap, false> full(graph, weight, full_trees, cycles, true, false);
+    for (const auto &support : supports) {
+        auto a = incremental(support);
+        auto b = full(support);
+        CHECK(std::get<2>(a));
+        CHECK(std::get<2>(a) == std::get<2>(b));
+        CHECK(std::get<1>(a) == std::get<1>(b));
+        CHECK(std::get<0>(a) == std::get<0>(b));
+        for (std::size_t i = 0; i < roots.size(); i++) {
+            CHECK(same_parities(incremental_trees[i], full_trees[i]));
+        }
+    }
+}
+
+#ifdef PARMCB_HAVE_TBB
+TEST_CASE("ordered parallel scan"){
+    typedef property_map<Graph, edge_weight_t>::type WeightMap;
+    typedef parmcb::SPTree<Graph, WeightMap> Tree;
+    // 20x20 grid with one heavy edge, the odd cycles through it sort after all other candidates
+    const std::size_t side = 20;
+    Graph graph;
+    create_grid(graph, side, [](std::size_t r, std::size_t c, bool horizontal) {
+        return horizontal && r == 5 && c == 5 ? 100.0 : 1.0;
+    });
+    WeightMap weight = get(edge_weight, graph);
+    Edge heavy = edge(5 * side + 5, 5 * side + 6, graph).first;
+    Edge light = edge(0, 1, graph).first;
+    Edge other = edge(7 * side + 2, 8 * side + 2, graph).first;
+
+    std::vector<graph_traits<Graph>::vertex_descriptor> roots(vertices(graph).first, vertices(graph).second);
+    parmcb::SPTrees<Graph, WeightMap, true> builder(graph, weight);
+    std::vector<Tree> sequential_trees, parallel_trees;
+    std::vector<parmcb::CandidateCycle<Graph, WeightMap>> cycles;
+    builder.build_trees(roots, sequential_trees);
+    builder.build_trees(roots, parallel_trees);
+    builder.build_candidate_cycles(sequential_trees, cycles);
+    std::sort(cycles.begin(), cycles.end(), [](const auto &a, const auto &b) {
+        return a.weight() < b.weight();
+    });
+    // more than one wave of eight chunks in an arena of four threads
+    CHECK(cycles.size() > 8 * 1024);
+
+    parmcb::ShortestOddCycleLookup<Graph, WeightMap, false> sequential(graph, weight, sequential_trees, cycles, true);
+    parmcb::ShortestOddCycleLookup<Graph, WeightMap, true> parallel(graph, weight, parallel_trees, cycles, true);
+    std::vector<std::set<Edge>> supports { { heavy }, { light }, { heavy, other }, { other }, { heavy, light } };
+    tbb::task_arena arena(4);
+    arena.execute([&] {
+        for (const auto &support : supports) {
+            auto a = sequential(support);
+            auto b = parallel(support);
+            CHECK(std::get<2>(a));
+            CHECK(std::get<2>(a) == std::get<2>(b));
+            CHECK(std::get<1>(a) == std::get<1>(b));
+            CHECK(std::get<0>(a) == std::get<0>(b));
+        }
+    });
+}
+#endif
+
+#ifdef PARMCB_HAVE_TBB
+TEST_CASE("reproducible parallel sva signed"){
+    // complete graph with unit weights, many cycles and paths of equal weight
+    const std::size_t n = 12;
+    Graph graph(n);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+    for (std::size_t u = 0; u < n; u++) {
+        for (std::size_t v = u + 1; v < n; v++) {
+            weight[add_edge(u, v, graph).first] = 1.0;
+        }
+    }
+
+    std::list<std::list<Edge>> expected;
+    parmcb::search_strategy_statistics stats;
+    tbb::task_arena single(1);
+    double expected_weight = single.execute([&] {
+        return parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(expected), parmcb::execution_context(),
+                parmcb::support_update::eager, &stats);
+    });
+    CHECK(expected.size() == 55);
+    CHECK(expected_weight == 165.0);
+
+    for (int threads : { 2, 4, 8 }) {
+        std::list<std::list<Edge>> cycles;
+        tbb::task_arena arena(threads);
+        double mcb_weight = arena.execute([&] {
+            return parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles));
+        });
+        CHECK(mcb_weight == expected_weight);
+        CHECK(cycles == expected);
+    }
+
+    // the searches from all vertices, chosen for a support vector with more edges than vertices
+    typedef property_map<Graph, edge_weight_t>::type WeightMap;
+    parmcb::ForestIndex<Graph> forest_index(graph);
+    std::vector<graph_traits<Graph>::vertex_descriptor> all_vertices(vertices(graph).first, vertices(graph).second);
+    std::set<std::size_t> ids;
+    for (std::size_t id = 0; id < forest_index.cycle_space_dimension(); id++) {
+        ids.insert(id);
+    }
+    parmcb::SpVecGF2<std::size_t> support(ids);
+    auto find = [&](int threads) {
+        tbb::task_arena arena(threads);
+        return arena.execute([&] {
+            parmcb::detail::OddCycleFinder<Graph, WeightMap> finder(graph, weight, forest_index, all_vertices);
+            auto cycle = finder.find(support);
+            CHECK(finder.strategy_statistics().count(parmcb::signed_search_mode::all_vertices) == 1);
+            return cycle;
+        });
+    };
+    auto expected_cycle = find(1);
+    CHECK(std::get<2>(expected_cycle));
+    CHECK(std::get<1>(expected_cycle) == 3.0);
+    for (int threads : { 2, 4, 8 }) {
+        CHECK(find(threads) == expected_cycle);
+    }
+
+    // a shared bound which the cycle of a search does not exceed leaves the cycle unchanged
+    Graph grid;
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> unit(1, 3);
+    create_grid(grid, 12, [&](std::size_t, std::size_t, bool) {
+        return static_cast<double>(unit(gen));
+    });
+    WeightMap grid_weight = get(edge_weight, grid);
+    parmcb::ForestIndex<Graph> grid_index(grid);
+    parmcb::detail::EdgeRanks signed_edges(num_edges(grid));
+    std::vector<std::size_t> signed_ids;
+    for (std::size_t id = 0; id < grid_index.cycle_space_dimension(); id += 2) {
+        signed_ids.push_back(id);
+    }
+    signed_edges.assign(signed_ids.begin(), signed_ids.end());
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(grid_index);
+    parmcb::SignedDijkstraWorkspace<Graph, WeightMap> workspace(grid, grid_weight);
+    std::size_t compared = 0;
+    for (const auto &v : make_iterator_range(vertices(grid))) {
+        auto search = [&](const parmcb::SharedCycleWeightBound<double> &bound) {
+            return parmcb::bidirectional_signed_dijkstra<parmcb::smaller_queue_first>(grid, grid_weight,
+                    edge_id_map, signed_edges, parmcb::detail::EdgeRanks::none, v, true, v, false, false, 0.0,
+                    bound, 0.0, workspace);
+        };
+        parmcb::SharedCycleWeightBound<double> unbounded;
+        auto free = search(unbounded);
+        if (!std::get<2>(free)) {
+            continue;
+        }
+        for (double slack : { 0.0, 1.0, 2.0 }) {
+            parmcb::SharedCycleWeightBound<double> bound;
+            bound.improve(std::get<1>(free) + slack);
+            CHECK(search(bound) == free);
+        }
+        parmcb::SharedCycleWeightBound<double> below;
+        below.improve(std::get<1>(free) - 1.0);
+        CHECK(!std::get<2>(search(below)));
+        compared++;
+    }
+    CHECK(compared > 0);
+}
+#endif
+
+TEST_CASE("cycle cache statistics"){
+    // a ring with random chords and weights, fixed seed
+    const std::size_t n = 40;
+    Graph graph(n);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+    std::mt19937 rng(17);
+    for (std::size_t v = 0; v < n; v++) {
+        weight[add_edge(v, (v + 1) % n, graph).first] = 1.0 + rng() % 20;
+    }
+    for (std::size_t i = 0; i < 60; i++) {
+        std::size_t u = rng() % n;
+        std::size_t v = rng() % n;
+        if (u != v && !edge(u, v, graph).second) {
+            weight[add_edge(u, v, graph).first] = 1.0 + rng() % 20;
+        }
+    }
+    std::size_t csd = num_edges(graph) - n + 1;
+
+    std::list<std::list<Edge>> cycles;
+    parmcb::cycle_cache_statistics stats;
+    double mcb_weight = parmcb::mcb_sva_signed(graph, weight, std::back_inserter(cycles),
+            parmcb::support_update::eager, &stats);
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == csd);
+    CHECK(stats.lookups == csd);
+    CHECK(stats.hits > 0);
+    CHECK(stats.answers > 0);
+    CHECK(stats.hits <= stats.lookups);
+    CHECK(stats.answers <= stats.hits);
+    CHECK(stats.insertions >= 1);
+
+    // the same basis weight without the pool
+    std::list<std::list<Edge>> uncached;
+    parmcb::cycle_cache_statistics no_stats;
+    double uncached_weight = parmcb::mcb_sva_signed(graph, weight, std::back_inserter(uncached),
+            parmcb::support_update::eager, &no_stats, nullptr, 0, 0);
+    CHECK(uncached.size() == csd);
+    CHECK(uncached_weight == mcb_weight);
+    CHECK(no_stats.hits == 0);
+    CHECK(no_stats.insertions == 0);
+
+    // pool operations, ids are sorted on insertion
+    parmcb::detail::CycleCache<double> cache(2);
+    cache.insert(std::vector<std::size_t> { 3, 1, 2 }, 5.0);
+    cache.insert(std::vector<std::size_t> { 1, 2, 3 }, 5.0);
+    CHECK(cache.size() == 1);
+    CHECK(cache.cycle(0) == std::vector<std::size_t>({ 1, 2, 3 }));
+    cache.insert(std::vector<std::size_t> { 4, 5, 6 }, 8.0);
+    CHECK(cache.size() == 2);
+    // full, a heavier cycle is dropped and a lighter one replaces the heaviest
+    cache.insert(std::vector<std::size_t> { 7, 8, 9 }, 9.0);
+    CHECK(cache.size() == 2);
+    CHECK(cache.statistics().insertions == 2);
+    cache.insert(std::vector<std::size_t> { 9, 8, 7 }, 4.0);
+    CHECK(cache.size() == 2);
+    CHECK(cache.statistics().insertions == 3);
+
+    parmcb::detail::EdgeBitmap signed_edges(10);
+    std::vector<std::size_t> signed_ids { 1, 4, 7 };
+    signed_edges.assign(signed_ids.begin(), signed_ids.end());
+    std::size_t lightest = cache.lightest_odd(signed_edges);
+    CHECK(lightest != parmcb::detail::CycleCache<double>::npos);
+    CHECK(cache.weight(lightest) == 4.0);
+    CHECK(cache.cycle(lightest) == std::vector<std::size_t>({ 7, 8, 9 }));
+
+    // an even number of signed edges on each cycle
+    signed_ids = { 1, 2, 7, 8 };
+    signed_edges.assign(signed_ids.begin(), signed_ids.end());
+    CHECK(cache.lightest_odd(signed_edges) == parmcb::detail::CycleCache<double>::npos);
+
+    signed_ids = { 2, 8 };
+    signed_edges.assign(signed_ids.begin(), signed_ids.end());
+    cache.erase(std::vector<std::size_t> { 7, 8, 9 });
+    CHECK(cache.size() == 1);
+    lightest = cache.lightest_odd(signed_edges);
+    CHECK(lightest != parmcb::detail::CycleCache<double>::npos);
+    CHECK(cache.weight(lightest) == 5.0);
+    CHECK(cache.statistics().lookups == 3);
+    CHECK(cache.statistics().hits == 2);
+}
+
+TEST_CASE("search strategy statistics"){
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    // few signed edges compared to the 17 vertices, one search per signed edge is cheaper
+    std::list<std::list<Edge>> cycles;
+    parmcb::search_strategy_statistics stats;
+    double mcb_weight = parmcb::mcb_sva_signed(graph, weight, std::back_inserter(cycles),
+            parmcb::support_update::eager, nullptr, &stats);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+    CHECK(stats.modes.size() == 3);
+    CHECK(stats.count(parmcb::signed_search_mode::signed_edges) == 3);
+
+#ifdef PARMCB_HAVE_TBB
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles),
+            parmcb::execution_context(), parmcb::support_update::eager, &stats);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+    CHECK(stats.modes.size() == 3);
+    CHECK(stats.count(parmcb::signed_search_mode::signed_edges) == 3);
+#endif
+
+    // a clique of 8 vertices with a path of 30 vertices, the signed edges of the clique have
+    // high degrees and 20 of them cost more than the searches from all 38 vertices
+    Graph clique(38);
+    property_map<Graph, edge_weight_t>::type clique_weight = get(edge_weight, clique);
+    for (std::size_t u = 0; u < 8; u++) {
+        for (std::size_t v = u + 1; v < 8; v++) {
+            clique_weight[add_edge(u, v, clique).first] = 1.0;
+        }
+    }
+    for (std::size_t v = 8; v < 38; v++) {
+        clique_weight[add_edge(v - 1, v, clique).first] = 1.0;
+    }
+    parmcb::ForestIndex<Graph> forest_index(clique);
+    std::set<std::size_t> ids;
+    for (const auto &e : make_iterator_range(edges(clique))) {
+        if (source(e, clique) < 8 && target(e, clique) < 8 && ids.size() < 20) {
+            ids.insert(forest_index(e));
+        }
+    }
+    parmcb::SpVecGF2<std::size_t> few(*ids.begin());
+    parmcb::SpVecGF2<std::size_t> many(ids);
+    parmcb::detail::SearchStrategySelector<Graph> selector(clique, forest_index);
+    CHECK(selector.searches(few) == 1);
+    CHECK(selector.choose(few) == parmcb::signed_search_mode::signed_edges);
+    CHECK(selector.searches(many) == 38);
+    CHECK(selector.choose(many) == parmcb::signed_search_mode::all_vertices);
+
+    parmcb::detail::SignedOddCycleSearch<Graph, property_map<Graph, edge_weight_t>::type> search(clique,
+            clique_weight, forest_index);
+    CHECK(search.searches(few) == 1);
+    CHECK(search.searches(many) == 38);
+}
+
+TEST_CASE("integral weights"){
+    typedef adjacency_list<vecS, vecS, undirectedS, no_property, property<edge_weight_t, long> > IntGraph;
+    typedef graph_traits<IntGraph>::edge_descriptor IntEdge;
+
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    // the searches use a radix heap for integral weights
+    IntGraph int_graph(num_vertices(graph));
+    property_map<IntGraph, edge_weight_t>::type int_weight = get(edge_weight, int_graph);
+    for (const auto &e : make_iterator_range(edges(graph))) {
+        int_weight[add_edge(source(e, graph), target(e, graph), int_graph).first] = static_cast<long>(weight[e]);
+    }
+
+    std::list<std::list<IntEdge>> cycles;
+    long mcb_weight = parmcb::mcb_sva_signed(int_graph, int_weight, std::back_inserter(cycles));
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(int_graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124);
+
+#ifdef PARMCB_HAVE_TBB
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_signed_tbb(int_graph, int_weight, std::back_inserter(cycles));
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124);
+#endif
+
+    // with unit weights the searches are breadth first
+    for (const auto &e : make_iterator_range(edges(int_graph))) {
+        int_weight[e] = 1;
+    }
+    parmcb::SignedDijkstraWorkspace<IntGraph, property_map<IntGraph, edge_weight_t>::type> workspace(int_graph,
+            int_weight);
+    CHECK(workspace.uniform_weights());
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_signed(int_graph, int_weight, std::back_inserter(cycles));
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 16);
+}
+
+TEST_CASE("landmarks"){
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    std::list<std::list<Edge>> cycles;
+    double mcb_weight = parmcb::mcb_sva_signed(graph, weight, std::back_inserter(cycles),
+            parmcb::support_update::eager, nullptr, nullptr, 3);
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+#ifdef PARMCB_HAVE_TBB
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles),
+            parmcb::execution_context(), parmcb::support_update::eager, nullptr, 3);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+#endif
+
+    // the lower bounds never settle more vertices than the plain search
+    typedef property_map<Graph, edge_weight_t>::type WeightMap;
+    parmcb::ForestIndex<Graph> forest_index(graph);
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+    parmcb::detail::EdgeBitmap signed_edges(num_edges(graph));
+    parmcb::detail::EdgeBitmap hidden_edges(num_edges(graph));
+    std::vector<std::size_t> ids { 0 };
+    signed_edges.assign(ids.begin(), ids.end());
+    parmcb::detail::Landmarks<Graph, WeightMap> landmarks(graph, weight, 4);
+    parmcb::SignedDijkstraWorkspace<Graph, WeightMap> plain(graph, weight);
+    parmcb::SignedDijkstraWorkspace<Graph, WeightMap> bounded(graph, weight, &landmarks);
+    CHECK(landmarks.size() == 4);
+    for (const auto &v : make_iterator_range(vertices(graph))) {
+        auto a = parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_edges, hidden_edges, false,
+                v, true, v, false, false, 0.0, plain);
+        auto b = parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_edges, hidden_edges, false,
+                v, true, v, false, false, 0.0, bounded);
+        CHECK(std::get<2>(a) == std::get<2>(b));
+        CHECK(std::get<1>(a) == std::get<1>(b));
+    }
+    CHECK(bounded.settled_vertices() <= plain.settled_vertices());
+}
+
+TEST_CASE("alternation policies"){
+    typedef property_map<Graph, edge_weight_t>::type WeightMap;
+    Graph graph;
+    create_graph(graph);
+    WeightMap weight = get(edge_weight, graph);
+
+    parmcb::ForestIndex<Graph> forest_index(graph);
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+    parmcb::detail::EdgeBitmap signed_edges(num_edges(graph));
+    parmcb::detail::EdgeBitmap hidden_edges(num_edges(graph));
+    std::vector<std::size_t> ids { 0, 2 };
+    signed_edges.assign(ids.begin(), ids.end());
+    parmcb::SignedDijkstraWorkspace<Graph, WeightMap> workspace(graph, weight);
+    for (const auto &v : make_iterator_range(vertices(graph))) {
+        auto a = parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_edges, hidden_edges, false,
+                v, true, v, false, false, 0.0, workspace);
+        auto b = parmcb::bidirectional_signed_dijkstra<parmcb::smaller_queue_first>(graph, weight, edge_id_map,
+                signed_edges, hidden_edges, false, v, true, v, false, false, 0.0, workspace);
+        auto c = parmcb::bidirectional_signed_dijkstra<parmcb::smaller_radius_first>(graph, weight, edge_id_map,
+                signed_edges, hidden_edges, false, v, true, v, false, false, 0.0, workspace);
+        CHECK(std::get<2>(a) == std::get<2>(b));
+        CHECK(std::get<2>(a) == std::get<2>(c));
+        CHECK(std::get<1>(a) == std::get<1>(b));
+        CHECK(std::get<1>(a) == std::get<1>(c));
+    }
+}
+
+#ifdef PARMCB_HAVE_TBB
+TEST_CASE("delta stepping"){
+    typedef property_map<Graph, edge_weight_t>::type WeightMap;
+    Graph graph;
+    create_graph(graph);
+    WeightMap weight = get(edge_weight, graph);
+
+    parmcb::ForestIndex<Graph> forest_index(graph);
+    auto edge_id_map = parmcb::make_forest_index_edge_id_map(forest_index);
+    parmcb::detail::EdgeRanks signed_edges(num_edges(graph));
+    std::vector<std::size_t> ids { 0, 2 };
+    signed_edges.assign(ids.begin(), ids.end());
+    parmcb::SharedCycleWeightBound<double> bound;
+    parmcb::SignedDijkstraWorkspace<Graph, WeightMap> workspace(graph, weight);
+    parmcb::detail::SignedDeltaSteppingWorkspace<Graph, WeightMap> delta_stepping(graph, weight);
+    for (std::size_t i = 0; i <= ids.size(); i++) {
+        for (const auto &v : make_iterator_range(vertices(graph))) {
+            auto a = parmcb::bidirectional_signed_dijkstra(graph, weight, edge_id_map, signed_edges, i, v, true, v,
+                    false, false, 0.0, bound, 0.0, workspace);
+            auto b = parmcb::parallel_signed_dijkstra(graph, weight, edge_id_map, signed_edges, i, v, true, v, false,
+                    false, 0.0, bound, 0.0, delta_stepping);
+            CHECK(std::get<2>(a) == std::get<2>(b));
+            CHECK(std::get<1>(a) == std::get<1>(b));
+        }
+    }
+
+    // many shortest paths of equal weight, the path and the scanned edges do not depend on the threads
+    Graph grid;
+    create_grid(grid, 16, unit_weight);
+    WeightMap grid_weight = get(edge_weight, grid);
+    parmcb::ForestIndex<Graph> grid_index(grid);
+    auto grid_edge_id_map = parmcb::make_forest_index_edge_id_map(grid_index);
+    parmcb::detail::EdgeRanks grid_signed_edges(num_edges(grid));
+    std::vector<std::size_t> grid_ids { 0, grid_index.cycle_space_dimension() / 2 };
+    grid_signed_edges.assign(grid_ids.begin(), grid_ids.end());
+    parmcb::detail::SignedDeltaSteppingWorkspace<Graph, WeightMap> grid_delta_stepping(grid, grid_weight);
+    auto delta_search = [&](int threads, std::size_t &scanned) {
+        tbb::task_arena arena(threads);
+        return arena.execute([&] {
+            grid_delta_stepping.reset_statistics();
+            auto res = parmcb::parallel_signed_dijkstra(grid, grid_weight, grid_edge_id_map, grid_signed_edges,
+                    parmcb::detail::EdgeRanks::none, vertex(0, grid), true, vertex(0, grid), false, false, 0.0,
+                    bound, 0.0, grid_delta_stepping);
+            scanned = grid_delta_stepping.scanned_edges.load();
+            return res;
+        });
+    };
+    std::size_t expected_scanned;
+    auto expected = delta_search(1, expected_scanned);
+    CHECK(std::get<2>(expected));
+    for (int threads : { 2, 4, 8, 8, 8 }) {
+        std::size_t scanned;
+        CHECK(delta_search(threads, scanned) == expected);
+        CHECK(scanned == expected_scanned);
+    }
+
+    // with fewer signed edges than hardware threads the searches run one at a time
+    tbb::task_arena arena(8);
+    arena.execute([&] {
+        std::list<std::list<Edge>> cycles;
+        double mcb_weight = parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles));
+        for (auto it = cycles.begin(); it != cycles.end(); it++) {
+            CHECK(parmcb::is_cycle(graph, *it));
+        }
+        CHECK(cycles.size() == 3);
+        CHECK(mcb_weight == 124.0);
+    });
+}
+#endif
+
+#ifdef PARMCB_HAVE_TBB
+TEST_CASE("execution context"){
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    std::list<std::list<Edge>> cycles;
+    parmcb::execution_context two_threads(2);
+    double mcb_weight = parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles), two_threads);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    parmcb::execution_context pinned(2, -1, true);
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_fvs_trees_tbb(graph, weight, std::back_inserter(cycles), pinned,
+            parmcb::support_update::eager);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::bcc_mcb_sva_iso_trees_tbb(graph, weight, std::back_inserter(cycles), two_threads);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::approx_mcb_sva_signed_tbb(graph, weight, 2, std::back_inserter(cycles), pinned);
+    CHECK(cycles.size() == 3);
+
+#ifdef __linux__
+    // the calling thread gets its affinity back
+    cpu_set_t before, after;
+    CHECK(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &before) == 0);
+    cycles.clear();
+    parmcb::mcb_sva_hybrid_tbb(graph, weight, std::back_inserter(cycles), pinned);
+    CHECK(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &after) == 0);
+    CHECK(CPU_EQUAL(&before, &after));
+#endif
+}
+#endif
+
+#ifdef PARMCB_HAVE_TBB
+TEST_CASE("numa replication"){
+    CHECK(parmcb::detail::parse_cpu_list("0-3,8,10-11\n") == std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }));
+    CHECK(!parmcb::detail::numa_topology().empty());
+
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    std::list<std::list<Edge>> cycles;
+    parmcb::execution_context replicated(0, -1, false, true);
+    double mcb_weight = parmcb::mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles), replicated);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::mcb_sva_iso_trees_tbb(graph, weight, std::back_inserter(cycles), replicated);
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    // two nodes on the same cpus, with a 12x12 grid the support vectors span both nodes
+    const std::size_t side = 12;
+    Graph grid;
+    create_grid(grid, side, [](std::size_t r, std::size_t c, bool horizontal) {
+        return horizontal ? 1.0 + (r + 2 * c) % 3 : 1.0 + (2 * r + c) % 5;
+    });
+    property_map<Graph, edge_weight_t>::type grid_weight = get(edge_weight, grid);
+    std::vector<int> cpus = parmcb::detail::numa_topology().front();
+    parmcb::detail::NumaDomains domains(std::vector<std::vector<int>>({ cpus, cpus }));
+    CHECK(domains.size() == 2);
+
+    std::list<std::list<Edge>> grid_cycles;
+    double expected = parmcb::mcb_sva_signed(grid, grid_weight, std::back_inserter(grid_cycles));
+    CHECK(grid_cycles.size() == 121);
+
+    typedef parmcb::detail::CSRSnapshot<Graph, property_map<Graph, edge_weight_t>::type> Snapshot;
+    Snapshot snapshot(grid, grid_weight);
+    for (auto strategy : { parmcb::support_update::eager, parmcb::support_update::blocked }) {
+        grid_cycles.clear();
+        auto out = std::back_inserter(grid_cycles);
+        auto csr_out = snapshot.cycle_output(out);
+        mcb_weight = parmcb::_mcb_sva_signed_tbb(snapshot.graph(), snapshot.weight_map(), csr_out, strategy, nullptr,
+                0, &domains);
+        for (auto it = grid_cycles.begin(); it != grid_cycles.end(); it++) {
+            CHECK(parmcb::is_cycle(grid, *it));
+        }
+        CHECK(grid_cycles.size() == 121);
+        CHECK(mcb_weight == expected);
+
+        grid_cycles.clear();
+        mcb_weight = parmcb::_mcb_sva_trees_snapshot<parmcb::detail::FVSCyclesBuilder, true>(grid, grid_weight,
+                std::back_inserter(grid_cycles), strategy, &domains);
+        CHECK(grid_cycles.size() == 121);
+        CHECK(mcb_weight == expected);
+    }
+}
+#endif
+
+TEST_CASE("sva hybrid"){
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    std::list<std::list<Edge>> cycles;
+    parmcb::hybrid_statistics stats;
+    double mcb_weight = parmcb::mcb_sva_hybrid(graph, weight, std::back_inserter(cycles),
+            parmcb::support_update::eager, parmcb::DEFAULT_HYBRID_MEMORY_BUDGET, &stats);
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+    CHECK(stats.lookup_answers + stats.bounded_searches + stats.searches == 3);
+
+    // 6x6 grid with a budget for a single tree, lookups only bound the searches
+    const std::size_t side = 6;
+    Graph grid;
+    create_grid(grid, side, unit_weight);
+    property_map<Graph, edge_weight_t>::type grid_weight = get(edge_weight, grid);
+    const std::size_t single_tree = (num_vertices(grid) + num_edges(grid)) * parmcb::detail::HYBRID_BYTES_PER_ENTRY;
+
+    std::list<std::list<Edge>> grid_cycles;
+    mcb_weight = parmcb::mcb_sva_hybrid(grid, grid_weight, std::back_inserter(grid_cycles),
+            parmcb::support_update::eager, single_tree, &stats);
+    for (auto it = grid_cycles.begin(); it != grid_cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(grid, *it));
+    }
+    CHECK(grid_cycles.size() == 25);
+    CHECK(mcb_weight == 100.0);
+    CHECK(stats.lookups >= 1);
+    CHECK(stats.lookup_answers == 0);
+    CHECK(stats.bounded_searches + stats.searches == 25);
+
+#ifdef PARMCB_HAVE_TBB
+    grid_cycles.clear();
+    mcb_weight = parmcb::mcb_sva_hybrid_tbb(grid, grid_weight, std::back_inserter(grid_cycles),
+            parmcb::execution_context(), parmcb::support_update::eager, single_tree);
+    CHECK(grid_cycles.size() == 25);
+    CHECK(mcb_weight == 100.0);
+
+    grid_cycles.clear();
+    mcb_weight = parmcb::mcb_sva_hybrid_tbb(grid, grid_weight, std::back_inserter(grid_cycles));
+    CHECK(grid_cycles.size() == 25);
+    CHECK(mcb_weight == 100.0);
+#endif
+}
+
+TEST_CASE("biconnected components"){
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    // two blocks with cycles, the remaining edges are bridges
+    parmcb::detail::BiconnectedBlocks<Graph, property_map<Graph, edge_weight_t>::type> blocks(graph, weight);
+    CHECK(blocks.size() == 2);
+    CHECK(blocks.dropped_edges() == 2);
+    CHECK(blocks[0].cycle_space_dimension() == 2);
+    CHECK(blocks[1].cycle_space_dimension() == 1);
+
+    std::list<std::list<Edge>> cycles;
+    double mcb_weight = parmcb::bcc_mcb_sva_signed(graph, weight, std::back_inserter(cycles));
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::bcc_mcb_sva_fvs_trees(graph, weight, std::back_inserter(cycles));
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+#ifdef PARMCB_HAVE_TBB
+    cycles.clear();
+    mcb_weight = parmcb::bcc_mcb_sva_signed_tbb(graph, weight, std::back_inserter(cycles));
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::bcc_mcb_sva_iso_trees_tbb(graph, weight, std::back_inserter(cycles));
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+#endif
+}
+
+TEST_CASE("chain reduction"){
+    Graph graph;
+    create_graph(graph);
+    property_map<Graph, edge_weight_t>::type weight = get(edge_weight, graph);
+
+    // branch vertices 2 and 3, one inner vertex kept on each long 2-3 path
+    // and two on the cycle 12-13-14-15
+    parmcb::detail::ChainReduction<Graph, property_map<Graph, edge_weight_t>::type> reduction(graph, weight);
+    CHECK(num_vertices(reduction.graph()) == 7);
+    CHECK(num_edges(reduction.graph()) == 8);
+    CHECK(reduction.original_vertices() == 17);
+    CHECK(reduction.reduction_ratio() == doctest::Approx(10.0 / 17));
+
+    std::list<std::list<Edge>> cycles;
+    double mcb_weight = parmcb::reduced_mcb_sva_signed(graph, weight, std::back_inserter(cycles));
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+    cycles.clear();
+    mcb_weight = parmcb::reduced_mcb_sva_iso_trees(graph, weight, std::back_inserter(cycles));
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+
+#ifdef PARMCB_HAVE_TBB
+    cycles.clear();
+    mcb_weight = parmcb::reduced_mcb_sva_fvs_trees_tbb(graph, weight, std::back_inserter(cycles));
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(graph, *it));
+    }
+    CHECK(cycles.size() == 3);
+    CHECK(mcb_weight == 124.0);
+#endif
+
+    // triangle 0-1-2 and a digon 0-3 hanging from it
+    Graph digon;
+    add_edge(0, 1, 1.0, digon);
+    add_edge(1, 2, 1.0, digon);
+    add_edge(2, 0, 1.0, digon);
+    add_edge(0, 3, 2.0, digon);
+    add_edge(0, 3, 3.0, digon);
+    property_map<Graph, edge_weight_t>::type digon_weight = get(edge_weight, digon);
+
+    parmcb::detail::ChainReduction<Graph, property_map<Graph, edge_weight_t>::type> digon_reduction(digon,
+            digon_weight);
+    CHECK(num_vertices(digon_reduction.graph()) == 4);
+    CHECK(num_edges(digon_reduction.graph()) == 5);
+
+    cycles.clear();
+    mcb_weight = parmcb::reduced_mcb_sva_signed(digon, digon_weight, std::back_inserter(cycles));
+    for (auto it = cycles.begin(); it != cycles.end(); it++) {
+        CHECK(parmcb::is_cycle(digon, *it));
+    }
+    CHECK(cycles.size() == 2);
+    CHECK(mcb_weight == 8.0);
+}
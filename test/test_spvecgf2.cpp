@@ -0,0 +1,107 @@
+//    Copyright (C) Dimitrios Michail 2019 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include <parmcb/spvecgf2.hpp>
+
+typedef parmcb::SpVecGF2<std::size_t> vector_type;
+
+static std::set<std::size_t> symmetric_difference(const std::set<std::size_t> &a, const std::set<std::size_t> &b) {
+    std::set<std::size_t> res;
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(res, res.end()));
+    return res;
+}
+
+static int parity_of_intersection(const std::set<std::size_t> &a, const std::set<std::size_t> &b) {
+    std::vector<std::size_t> common;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(common));
+    return common.size() % 2;
+}
+
+static std::set<std::size_t> random_set(std::mt19937 &rng, std::size_t dim, double density) {
+    std::bernoulli_distribution coin(density);
+    std::set<std::size_t> res;
+    for (std::size_t i = 0; i < dim; i++) {
+        if (coin(rng)) {
+            res.insert(i);
+        }
+    }
+    return res;
+}
+
+static bool equals(const vector_type &v, const std::set<std::size_t> &s) {
+    return v.size() == s.size() && std::equal(v.begin(), v.end(), s.begin());
+}
+
+TEST_CASE("spvecgf2 sparse")
+{
+    vector_type v1(100), v3(300), v5(500);
+
+    vector_type v = v1 + v3 + v5;
+    CHECK(v.size() == 3);
+    CHECK(!v.is_dense());
+    CHECK(*(v.begin() + 1) == 300);
+
+    v += v3;
+    CHECK(v.size() == 2);
+    CHECK(v * v1 == 1);
+    CHECK(v * v3 == 0);
+    CHECK(v * std::set<std::size_t> { 100, 500 } == 0);
+}
+
+TEST_CASE("spvecgf2 dense switching")
+{
+    const std::size_t dim = 1000;
+    std::set<std::size_t> all;
+    for (std::size_t i = 0; i < dim; i++) {
+        all.insert(i);
+    }
+
+    vector_type v(all);
+    CHECK(v.is_dense());
+    CHECK(v.size() == dim);
+    CHECK(equals(v, all));
+
+    // cancel all but a few positions, falls back to sparse
+    std::set<std::size_t> most = all;
+    most.erase(7);
+    most.erase(999);
+    v += vector_type(most);
+    CHECK(!v.is_dense());
+    CHECK(equals(v, std::set<std::size_t> { 7, 999 }));
+}
+
+TEST_CASE("spvecgf2 random")
+{
+    std::mt19937 rng(17);
+    const std::size_t dim = 700;
+    const std::vector<double> densities = { 0.001, 0.01, 0.05, 0.3, 0.8 };
+
+    for (std::size_t round = 0; round < 50; round++) {
+        auto a = random_set(rng, dim, densities[round % densities.size()]);
+        auto b = random_set(rng, dim, densities[(round / densities.size()) % densities.size()]);
+
+        vector_type va(a), vb(b);
+        CHECK(equals(va, a));
+        CHECK(equals(vb, b));
+        CHECK(va * vb == parity_of_intersection(a, b));
+        CHECK(vb * va == parity_of_intersection(a, b));
+        CHECK(va * b == parity_of_intersection(a, b));
+
+        vector_type sum = va + vb;
+        CHECK(equals(sum, symmetric_difference(a, b)));
+
+        va += vb;
+        CHECK(equals(va, symmetric_difference(a, b)));
+        va += vb;
+        CHECK(equals(va, a));
+    }
+}